@@ -45,15 +45,19 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <memory>
+#include <mutex>
 
 #include "MXFInputTrack.h"
 #include "../writers/OutputTrack.h"
 #include "../writers/TrackMapper.h"
+#include "../writers/PacketPipeline.h"
 #include <bmx/mxf_reader/MXFFileReader.h>
 #include <bmx/mxf_reader/MXFGroupReader.h>
 #include <bmx/mxf_reader/MXFSequenceReader.h>
 #include <bmx/mxf_reader/MXFFrameMetadata.h>
 #include <bmx/mxf_reader/MXFTimedTextTrackReader.h>
+#include <bmx/frame/PooledFrame.h>
 #include <bmx/essence_parser/SoundConversion.h>
 #include <bmx/essence_parser/MPEG2AspectRatioFilter.h>
 #include <bmx/mxf_helper/RDD36MXFDescriptorHelper.h>
@@ -92,6 +96,8 @@ using namespace mxfpp;
 
 #define DEFAULT_ST436_MANIFEST_COUNT    2
 
+#define FRAME_POOL_SIZE             16
+
 
 typedef struct
 {
@@ -121,6 +127,8 @@ static const uint16_t DEFAULT_RDD6_LINES[2] = {9, 572};     /* ST 274, line 9 fi
 static const uint8_t DEFAULT_RDD6_SDID      = 4;            /* first channel pair is 5/6 */
 
 static const uint32_t DEFAULT_HTTP_MIN_READ = 64 * 1024;
+static const uint32_t DEFAULT_HTTP_CACHE_BLOCKS = 64;
+static const uint32_t DEFAULT_HTTP_PREFETCH = 4;
 
 
 namespace bmx
@@ -279,6 +287,89 @@ static void construct_anc_rdd6(RDD6MetadataFrame *rdd6_frame,
     output_element.Construct(anc_buffer);
 }
 
+class TranswrapSamples
+{
+public:
+    TranswrapSamples() : data(0), size(0), num_samples(0) {}
+
+public:
+    unsigned char *data;
+    uint32_t size;
+    uint32_t num_samples;
+    bmx::ByteArray buffer;
+};
+
+class TranswrapPacket : public PipelinePacket
+{
+public:
+    TranswrapPacket();
+    virtual ~TranswrapPacket();
+
+    void Reset();
+
+public:
+    uint32_t num_read;
+    bool add_pcm_padding;
+    bool gf_read_failure;
+    vector<Frame*> frames;                      // 0 for timed text input tracks
+    vector<vector<TranswrapSamples> > samples;  // samples for each input track output
+    bmx::ByteArray rdd6_anc_buffer;
+};
+
+class TranswrapStages : public PipelineStages
+{
+public:
+    TranswrapStages();
+    virtual ~TranswrapStages();
+
+    virtual PipelinePacket* ReadPacket();
+    virtual void ProcessPacket(PipelinePacket *pipeline_packet);
+
+    // returns a written packet for reuse by ReadPacket, keeping its sample buffers allocated
+    void ReleasePacket(TranswrapPacket *packet);
+
+public:
+    MXFReader *reader;
+    MXFFileReader *file_reader;
+    vector<MXFInputTrack*> *input_tracks;
+    ClipWriterType clip_type;
+    int64_t read_duration;
+    vector<uint32_t> sample_sequence;
+    uint32_t sample_sequence_offset;
+    uint32_t max_samples_per_read;
+    Rational frame_rate;
+    bool growing_file;
+    unsigned int gf_retries;
+    float gf_retry_delay;
+    float gf_rate_after_fail;
+    bool ignore_d10_aes3_flags;
+    set<ANCDataType> pass_anc;
+    bool have_rdd6;
+    RDD6MetadataFrame *rdd6_frame;
+    RDD6MetadataSequence *rdd6_static_sequence;
+    bmx::ByteArray *rdd6_first_buffer;
+    bmx::ByteArray *rdd6_second_buffer;
+    bool rdd6_pair_in_frame;
+    uint8_t rdd6_sdid;
+    uint16_t *rdd6_lines;
+
+    int64_t total_read;
+    bool even_frame;
+    bool read_end;
+    unsigned int gf_retry_count;
+    bool gf_read_failure;
+    int64_t gf_failure_num_read;
+    uint32_t gf_failure_start;
+
+private:
+    TranswrapPacket* AllocPacket();
+
+private:
+    mutex free_packets_mutex;
+    vector<TranswrapPacket*> free_packets;
+};
+
+
 static uint32_t read_samples(MXFReader *reader, const vector<uint32_t> &sample_sequence,
                              uint32_t *sample_sequence_offset, uint32_t max_samples_per_read)
 {
@@ -299,12 +390,14 @@ static uint32_t read_samples(MXFReader *reader, const vector<uint32_t> &sample_s
     return num_read;
 }
 
-static void write_anc_samples(OutputTrack *output_track, Frame *frame, set<ANCDataType> &filter, bmx::ByteArray &anc_buffer)
+static void filter_anc_samples(Frame *frame, set<ANCDataType> &filter, TranswrapSamples *samples)
 {
     BMX_CHECK(frame->num_samples == 1);
 
     if (filter.empty() || (filter.size() == 1 && (*filter.begin()) == ALL_ANC_DATA)) {
-        output_track->WriteSamples(0, (unsigned char*)frame->GetBytes(), frame->GetSize(), frame->num_samples);
+        samples->data        = (unsigned char*)frame->GetBytes();
+        samples->size        = frame->GetSize();
+        samples->num_samples = frame->num_samples;
         return;
     }
 
@@ -320,10 +413,311 @@ static void write_anc_samples(OutputTrack *output_track, Frame *frame, set<ANCDa
             output_element.lines.push_back(input_element.lines[i]);
     }
 
-    anc_buffer.SetSize(0);
-    output_element.Construct(&anc_buffer);
+    samples->buffer.SetSize(0);
+    output_element.Construct(&samples->buffer);
+
+    samples->data        = samples->buffer.GetBytes();
+    samples->size        = samples->buffer.GetSize();
+    samples->num_samples = 1;
+}
+
+
+TranswrapPacket::TranswrapPacket()
+{
+    num_read = 0;
+    add_pcm_padding = false;
+    gf_read_failure = false;
+}
+
+TranswrapPacket::~TranswrapPacket()
+{
+    Reset();
+}
+
+void TranswrapPacket::Reset()
+{
+    num_read = 0;
+    add_pcm_padding = false;
+    gf_read_failure = false;
+
+    size_t i;
+    for (i = 0; i < frames.size(); i++)
+        delete frames[i];
+    frames.clear();
+}
+
+
+TranswrapStages::TranswrapStages()
+{
+    reader = 0;
+    file_reader = 0;
+    input_tracks = 0;
+    clip_type = CW_UNKNOWN_CLIP_TYPE;
+    read_duration = -1;
+    sample_sequence_offset = 0;
+    max_samples_per_read = 1;
+    frame_rate = ZERO_RATIONAL;
+    growing_file = false;
+    gf_retries = DEFAULT_GF_RETRIES;
+    gf_retry_delay = DEFAULT_GF_RETRY_DELAY;
+    gf_rate_after_fail = DEFAULT_GF_RATE_AFTER_FAIL;
+    ignore_d10_aes3_flags = false;
+    have_rdd6 = false;
+    rdd6_frame = 0;
+    rdd6_static_sequence = 0;
+    rdd6_first_buffer = 0;
+    rdd6_second_buffer = 0;
+    rdd6_pair_in_frame = true;
+    rdd6_sdid = DEFAULT_RDD6_SDID;
+    rdd6_lines = 0;
+
+    total_read = 0;
+    even_frame = true;
+    read_end = false;
+    gf_retry_count = 0;
+    gf_read_failure = false;
+    gf_failure_num_read = 0;
+    gf_failure_start = 0;
+}
+
+TranswrapStages::~TranswrapStages()
+{
+    size_t i;
+    for (i = 0; i < free_packets.size(); i++)
+        delete free_packets[i];
+}
 
-    output_track->WriteSamples(0, anc_buffer.GetBytes(), anc_buffer.GetSize(), 1);
+void TranswrapStages::ReleasePacket(TranswrapPacket *packet)
+{
+    // the frames are released now; the sample buffers are kept for the next packet
+    packet->Reset();
+
+    lock_guard<mutex> lock(free_packets_mutex);
+    free_packets.push_back(packet);
+}
+
+TranswrapPacket* TranswrapStages::AllocPacket()
+{
+    {
+        lock_guard<mutex> lock(free_packets_mutex);
+        if (!free_packets.empty()) {
+            TranswrapPacket *packet = free_packets.back();
+            free_packets.pop_back();
+            return packet;
+        }
+    }
+
+    return new TranswrapPacket();
+}
+
+PipelinePacket* TranswrapStages::ReadPacket()
+{
+    if (read_end || (read_duration >= 0 && total_read >= read_duration))
+        return 0;
+
+    if (gf_read_failure)
+        rt_sleep(gf_rate_after_fail, gf_failure_start, frame_rate, total_read - gf_failure_num_read);
+
+    uint32_t num_read;
+    while (true) {
+        num_read = read_samples(reader, sample_sequence, &sample_sequence_offset, max_samples_per_read);
+        if (num_read > 0)
+            break;
+
+        if (!growing_file || !reader->ReadError() || gf_retry_count >= gf_retries) {
+            read_end = true;
+            return 0;
+        }
+        gf_retry_count++;
+        gf_read_failure = true;
+        if (file_reader) {
+            // retry as soon as the file is modified
+            file_reader->WaitForUpdate((uint32_t)(gf_retry_delay * 1000));
+            file_reader->Refresh();
+        } else if (gf_retry_delay > 0.0) {
+            rt_sleep(1.0f / gf_retry_delay, get_tick_count(), frame_rate,
+                     frame_rate.numerator / frame_rate.denominator);
+        }
+    }
+    if (growing_file && gf_retry_count > 0) {
+        gf_failure_num_read = total_read;
+        gf_failure_start    = get_tick_count();
+        gf_retry_count      = 0;
+    }
+
+    // check whether any incomplete frames (where requested samples < read samples) are supported
+    bool add_pcm_padding = false;
+    size_t i;
+    for (i = 0; i < input_tracks->size(); i++) {
+        MXFInputTrack *input_track = (*input_tracks)[i];
+        if (input_track->GetTrackInfo()->essence_type == TIMED_TEXT) {
+            // timed text is handled elsewhere
+            continue;
+        }
+
+        Frame *frame = input_track->GetFrameBuffer()->GetLastFrame(false);
+        BMX_ASSERT(frame);
+
+        if (!frame->IsComplete()) {
+            const MXFTrackInfo *input_track_info = input_track->GetTrackInfo();
+            // only support padding with PCM samples and where the input edit rate equals audio sampling rate
+            if (input_track_info->essence_type != WAVE_PCM ||
+                input_track_info->edit_rate != ((MXFSoundTrackInfo*)input_track_info)->sampling_rate)
+            {
+                log_warn("Unable to provide PCM padding data for incomplete frame\n");
+                break;
+            }
+
+            // transferring partial frame data is only supported for the WAVE clip type
+            if (!frame->IsEmpty() && clip_type != CW_WAVE_CLIP_TYPE) {
+                log_warn("Transferring partial PCM frame data is only supported for %s\n",
+                         clip_type_to_string(CW_WAVE_CLIP_TYPE, NO_CLIP_SUB_TYPE));
+                break;
+            }
+
+            // only pad partial frames if not outputting to WAVE
+            if (clip_type != CW_WAVE_CLIP_TYPE)
+                add_pcm_padding = true;
+        }
+    }
+    if (i < input_tracks->size()) {
+        read_end = true;
+        return 0;
+    }
+
+    unique_ptr<TranswrapPacket> packet(AllocPacket());
+    packet->num_read        = num_read;
+    packet->add_pcm_padding = add_pcm_padding;
+    packet->gf_read_failure = gf_read_failure;
+    packet->frames.resize(input_tracks->size(), 0);
+    packet->samples.resize(input_tracks->size());
+    for (i = 0; i < input_tracks->size(); i++) {
+        MXFInputTrack *input_track = (*input_tracks)[i];
+        if (input_track->GetTrackInfo()->essence_type == TIMED_TEXT)
+            continue;
+
+        packet->frames[i] = input_track->GetFrameBuffer()->GetLastFrame(true);
+        BMX_ASSERT(packet->frames[i]);
+        packet->samples[i].resize(input_track->GetOutputTrackCount());
+    }
+
+    if (have_rdd6) {
+        if (rdd6_pair_in_frame || even_frame)
+            rdd6_frame->UpdateStaticFrame(rdd6_static_sequence);
+
+        if (rdd6_pair_in_frame) {
+            construct_anc_rdd6(rdd6_frame, rdd6_first_buffer, rdd6_second_buffer, rdd6_sdid, rdd6_lines,
+                               &packet->rdd6_anc_buffer);
+        } else {
+            if (even_frame) {
+                construct_anc_rdd6_sub_frame(rdd6_frame, true, rdd6_first_buffer, rdd6_sdid, rdd6_lines[0],
+                                             &packet->rdd6_anc_buffer);
+            } else {
+                construct_anc_rdd6_sub_frame(rdd6_frame, false, rdd6_second_buffer, rdd6_sdid, rdd6_lines[1],
+                                             &packet->rdd6_anc_buffer);
+            }
+        }
+
+        if (rdd6_pair_in_frame || !even_frame)
+            rdd6_static_sequence->UpdateForNextStaticFrame();
+        even_frame = !even_frame;
+    }
+
+    total_read += num_read;
+    if (max_samples_per_read > 1 && num_read < max_samples_per_read)
+        read_end = true;
+
+    return packet.release();
+}
+
+void TranswrapStages::ProcessPacket(PipelinePacket *pipeline_packet)
+{
+    TranswrapPacket *packet = dynamic_cast<TranswrapPacket*>(pipeline_packet);
+    BMX_ASSERT(packet);
+
+    size_t i;
+    for (i = 0; i < input_tracks->size(); i++) {
+        MXFInputTrack *input_track = (*input_tracks)[i];
+        Frame *frame = packet->frames[i];
+        if (!frame || frame->IsEmpty())
+            continue;
+
+        const MXFTrackInfo *input_track_info = input_track->GetTrackInfo();
+        const MXFSoundTrackInfo *input_sound_info = dynamic_cast<const MXFSoundTrackInfo*>(input_track_info);
+
+        uint32_t bits_per_sample = 0;
+        uint16_t channel_block_align = 0;
+        if (input_sound_info) {
+            bits_per_sample     = input_sound_info->bits_per_sample;
+            channel_block_align = (bits_per_sample + 7) / 8;
+        }
+
+        bool split_channels = (input_sound_info && input_sound_info->channel_count > 1) ||
+                              input_track_info->essence_type == D10_AES3_PCM;
+
+        // split the channels that are output from the multi-channel sound in a single pass
+        vector<unsigned char*> channel_data;
+        uint32_t num_channel_samples = 0;
+        uint32_t channel_data_size = 0;
+        size_t k;
+        if (split_channels) {
+            if (input_track_info->essence_type == D10_AES3_PCM) {
+                channel_data.resize(8, 0);
+                num_channel_samples = get_aes3_sample_count(frame->GetBytes(), frame->GetSize());
+            } else {
+                channel_data.resize(input_sound_info->channel_count, 0);
+                num_channel_samples = frame->GetSize() / (input_sound_info->channel_count * channel_block_align);
+            }
+            channel_data_size = num_channel_samples * channel_block_align;
+
+            for (k = 0; k < input_track->GetOutputTrackCount(); k++) {
+                uint32_t input_channel_index = input_track->GetInputChannelIndex(k);
+                BMX_CHECK(input_channel_index < channel_data.size());
+                if (!channel_data[input_channel_index]) {
+                    // the buffer of a reused packet is only reallocated if it is too small
+                    TranswrapSamples *samples = &packet->samples[i][k];
+                    samples->buffer.Allocate(channel_data_size);
+                    channel_data[input_channel_index] = samples->buffer.GetBytes();
+                }
+            }
+
+            if (input_track_info->essence_type == D10_AES3_PCM) {
+                convert_aes3_to_pcm_channels(frame->GetBytes(), frame->GetSize(), ignore_d10_aes3_flags,
+                                             bits_per_sample, (uint8_t)channel_data.size(), &channel_data[0],
+                                             channel_data_size);
+            } else {
+                deinterleave_audio_channels(frame->GetBytes(), frame->GetSize(),
+                                            bits_per_sample, input_sound_info->channel_count, &channel_data[0],
+                                            channel_data_size);
+            }
+        }
+
+        for (k = 0; k < input_track->GetOutputTrackCount(); k++) {
+            uint32_t input_channel_index = input_track->GetInputChannelIndex(k);
+            TranswrapSamples *samples = &packet->samples[i][k];
+
+            if (split_channels)
+            {
+                // output tracks mapped from the same input channel share the buffer
+                samples->data        = channel_data[input_channel_index];
+                samples->size        = channel_data_size;
+                samples->num_samples = num_channel_samples;
+            }
+            else if (input_track_info->essence_type == ANC_DATA)
+            {
+                filter_anc_samples(frame, pass_anc, samples);
+            }
+            else
+            {
+                samples->data = (unsigned char*)frame->GetBytes();
+                samples->size = frame->GetSize();
+                if (input_sound_info)
+                    samples->num_samples = frame->GetSize() / channel_block_align;
+                else
+                    samples->num_samples = frame->num_samples;
+            }
+        }
+    }
 }
 
 static void disable_tracks(MXFReader *reader, const set<size_t> &track_indexes,
@@ -341,6 +735,27 @@ static void disable_tracks(MXFReader *reader, const set<size_t> &track_indexes,
     }
 }
 
+static vector<MXFFileReader::OpenResult> open_file_readers(const vector<MXFFileReader*> &file_readers,
+                                                          const vector<const char*> &filenames,
+                                                          uint32_t num_threads)
+{
+    if (num_threads > 1) {
+        vector<string> filename_strs(filenames.begin(), filenames.end());
+        return MXFFileReader::OpenParallel(file_readers, filename_strs, 0, num_threads);
+    }
+
+    // stop at the first failure
+    vector<MXFFileReader::OpenResult> results;
+    size_t i;
+    for (i = 0; i < file_readers.size(); i++) {
+        results.push_back(file_readers[i]->Open(filenames[i]));
+        if (results.back() != MXFFileReader::MXF_RESULT_SUCCESS)
+            break;
+    }
+
+    return results;
+}
+
 EssenceType process_assumed_essence_type(const MXFTrackInfo *input_track_info, EssenceType assume_d10_essence_type)
 {
     // Map the essence type if generic MPEG video is assumed to be D-10
@@ -388,6 +803,8 @@ static void usage(const char *cmd)
     fprintf(stderr, "                          <uid> is a UUID (see Notes at the end) and is the Product UID property\n");
     fprintf(stderr, "  --create-date <tstamp>  Set the creation date in the MXF Identification set. Default is 'now'\n");
     fprintf(stderr, "  --input-file-md5        Calculate an MD5 checksum of the input file\n");
+    fprintf(stderr, "  --input-file-md5-stream Calculate the input file MD5 checksum in a separate thread using a sequential read of the file\n");
+    fprintf(stderr, "                          This avoids re-reading parts of the file skipped by the reader. It is not supported for stdin or HTTP input\n");
     fprintf(stderr, "  -y <hh:mm:sscff>        Override input start timecode. Default 00:00:00:00\n");
     fprintf(stderr, "                          The c character in the pattern should be ':' for non-drop frame; any other character indicates drop frame\n");
     fprintf(stderr, "  --mtc                   Check first and use the input material package start timecode if present\n");
@@ -404,6 +821,8 @@ static void usage(const char *cmd)
     fprintf(stderr, "  --group                 Use the group reader instead of the sequence reader\n");
     fprintf(stderr, "                          Use this option if the files have different material packages\n");
     fprintf(stderr, "                          but actually belong to the same virtual package / group\n");
+    fprintf(stderr, "  --open-threads <count>  Open the --group or sequence input files in parallel using <count> threads. The default is 1\n");
+    fprintf(stderr, "                          The input files are opened sequentially if --rw-intl is used\n");
     fprintf(stderr, "  --no-reorder            Don't attempt to order the inputs in a sequence\n");
     fprintf(stderr, "                          Use this option for files with broken timecode\n");
     fprintf(stderr, "  --rt <factor>           Transwrap at realtime rate x <factor>, where <factor> is a floating point value\n");
@@ -416,7 +835,15 @@ static void usage(const char *cmd)
     if (mxf_http_is_supported()) {
         fprintf(stderr, " --http-min-read <bytes>\n");
         fprintf(stderr, "                          Set the minimum number of bytes to read when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_MIN_READ);
+        fprintf(stderr, "  --http-cache-blocks <count>\n");
+        fprintf(stderr, "                          Set the number of <min read> sized blocks to cache when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_CACHE_BLOCKS);
+        fprintf(stderr, "  --http-prefetch <count>\n");
+        fprintf(stderr, "                          Set the maximum number of parallel HTTP range requests made ahead of reads. The default is %u. 0 disables prefetching\n", DEFAULT_HTTP_PREFETCH);
     }
+    fprintf(stderr, "  --read-ahead <count>    Read <count> content packages ahead in a separate thread. The default is 0, i.e. disabled\n");
+    fprintf(stderr, "                          This only applies to frame wrapped essence with a complete index table\n");
+    fprintf(stderr, "  --threads <count>       Use <count> threads: a read thread, <count> - 2 (minimum 1) threads for processing, e.g. audio de-interleaving, and the write thread\n");
+    fprintf(stderr, "                          The default is 1, i.e. read, process and write in sequence\n");
     fprintf(stderr, "  --no-precharge          Don't output clip/track with precharge. Adjust the start position and duration instead\n");
     fprintf(stderr, "  --no-rollout            Don't output clip/track with rollout. Adjust the duration instead\n");
     fprintf(stderr, "  --rw-intl               Interleave input reads with output writes\n");
@@ -424,10 +851,10 @@ static void usage(const char *cmd)
     fprintf(stderr, "                          Value must be a multiple of the system page size, %u\n", mxf_get_system_page_size());
 #if defined(_WIN32)
     fprintf(stderr, "  --seq-scan              Set the sequential scan hint for optimizing file caching whilst reading\n");
+#endif
 #if !defined(__MINGW32__)
     fprintf(stderr, "  --mmap-file             Use memory-mapped file I/O for the MXF files\n");
     fprintf(stderr, "                          Note: this may reduce file I/O performance and was found to be slower over network drives\n");
-#endif
 #endif
     fprintf(stderr, "  --avcihead <format> <file> <offset>\n");
     fprintf(stderr, "                          Default AVC-Intra sequence header data (512 bytes) to use when the input file does not have it\n");
@@ -598,6 +1025,7 @@ static void usage(const char *cmd)
     fprintf(stderr, "    --kag-size-512          Set KAG size to 512, instead of 1\n");
     fprintf(stderr, "    --system-item           Add system item\n");
     fprintf(stderr, "    --primary-package       Set the header metadata set primary package property to the top-level file source package\n");
+    fprintf(stderr, "    --write-behind          Write the file in a separate thread\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "  op1a/rdd9:\n");
     fprintf(stderr, "    --ard-zdf-hdf           Use the ARD ZDF HDF profile\n");
@@ -737,6 +1165,7 @@ int main(int argc, const char** argv)
     bool kag_size_512 = false;
     bool op1a_system_item = false;
     bool op1a_primary_package = false;
+    bool op1a_write_behind = false;
     AS10Shim as10_shim = AS10_UNKNOWN_SHIM;
     const char *output_name = "";
     Timecode start_timecode;
@@ -812,6 +1241,7 @@ int main(int argc, const char** argv)
     BMX_OPT_PROP_DECL_DEF(int32_t, user_display_f2_offset, 0);
     bool ignore_input_desc = false;
     bool input_file_md5 = false;
+    bool input_file_md5_stream = false;
     int input_file_flags = 0;
     bool no_precharge = false;
     bool no_rollout = false;
@@ -869,8 +1299,13 @@ int main(int argc, const char** argv)
     uint16_t rdd6_lines[2] = {DEFAULT_RDD6_LINES[0], DEFAULT_RDD6_LINES[1]};
     uint8_t rdd6_sdid = DEFAULT_RDD6_SDID;
     uint32_t http_min_read = DEFAULT_HTTP_MIN_READ;
+    uint32_t http_cache_blocks = DEFAULT_HTTP_CACHE_BLOCKS;
+    uint32_t http_prefetch = DEFAULT_HTTP_PREFETCH;
+    uint32_t read_ahead = 0;
+    uint32_t num_threads = 1;
+    uint32_t open_threads = 1;
     bool mp_track_num = false;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     bool use_mmap_file = false;
 #endif
     vector<EmbedXMLInfo> embed_xml;
@@ -1017,6 +1452,11 @@ int main(int argc, const char** argv)
         {
             input_file_md5 = true;
         }
+        else if (strcmp(argv[cmdln_index], "--input-file-md5-stream") == 0)
+        {
+            input_file_md5 = true;
+            input_file_md5_stream = true;
+        }
         else if (strcmp(argv[cmdln_index], "-y") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -1224,6 +1664,91 @@ int main(int argc, const char** argv)
             http_min_read = (uint32_t)(uvalue);
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--http-cache-blocks") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            http_cache_blocks = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--http-prefetch") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            http_prefetch = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--read-ahead") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            read_ahead = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            num_threads = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--open-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            open_threads = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--no-precharge") == 0)
         {
             no_precharge = true;
@@ -1259,12 +1784,12 @@ int main(int argc, const char** argv)
         {
             input_file_flags |= MXF_WIN32_FLAG_SEQUENTIAL_SCAN;
         }
+#endif
 #if !defined(__MINGW32__)
         else if (strcmp(argv[cmdln_index], "--mmap-file") == 0)
         {
             use_mmap_file = true;
         }
-#endif
 #endif
         else if (strcmp(argv[cmdln_index], "--avcihead") == 0)
         {
@@ -2219,6 +2744,10 @@ int main(int argc, const char** argv)
         {
             op1a_primary_package = true;
         }
+        else if (strcmp(argv[cmdln_index], "--write-behind") == 0)
+        {
+            op1a_write_behind = true;
+        }
         else if (strcmp(argv[cmdln_index], "--ard-zdf-hdf") == 0)
         {
             ard_zdf_hdf_profile = true;
@@ -2665,6 +3194,13 @@ int main(int argc, const char** argv)
         return 1;
     }
 
+    // the read/write interleaver is shared by all files and is not thread-safe
+    if (rw_interleave && (read_ahead > 0 || num_threads > 1 || op1a_write_behind)) {
+        usage(argv[0]);
+        fprintf(stderr, "Option '--rw-intl' can't be combined with '--read-ahead', '--threads' or '--write-behind'\n");
+        return 1;
+    }
+
     if (clip_sub_type == AS10_CLIP_SUB_TYPE) {
         const char *as10_shim_name = as10_helper.GetShimName();
         if (!as10_shim_name) {
@@ -2725,32 +3261,42 @@ int main(int argc, const char** argv)
 
         if (input_file_md5)
             file_factory.AddInputChecksumType(MD5_CHECKSUM);
+        file_factory.SetInputChecksumStream(input_file_md5_stream);
         file_factory.SetInputFlags(input_file_flags);
-        if (rw_interleave)
+        if (rw_interleave) {
             file_factory.SetRWInterleave(rw_interleave_size);
+            // the interleaver's cache is shared by all files and is not thread-safe
+            open_threads = 1;
+        }
         file_factory.SetHTTPMinReadSize(http_min_read);
-#if defined(_WIN32) && !defined(__MINGW32__)
+        file_factory.SetHTTPCache(http_cache_blocks, http_prefetch);
+#if !defined(__MINGW32__)
         file_factory.SetUseMMapFile(use_mmap_file);
 #endif
 
         if (use_group_reader && input_filenames.size() > 1) {
             MXFGroupReader *group_reader = new MXFGroupReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> grp_file_readers;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *grp_file_reader = new MXFFileReader();
                 grp_file_reader->SetFileFactory(&file_factory, false);
                 grp_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 grp_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
-                result = grp_file_reader->Open(input_filenames[i]);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                grp_file_reader->SetReadAhead(read_ahead);
+                grp_file_readers.push_back(grp_file_reader);
+            }
+            vector<MXFFileReader::OpenResult> results = open_file_readers(grp_file_readers, input_filenames,
+                                                                          open_threads);
+            for (i = 0; i < results.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", input_filenames[i],
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(grp_file_reader, disable_track_indexes[i],
+                disable_tracks(grp_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                group_reader->AddReader(grp_file_reader);
+                group_reader->AddReader(grp_file_readers[i]);
             }
             if (!group_reader->Finalize())
                 throw false;
@@ -2758,22 +3304,27 @@ int main(int argc, const char** argv)
             reader = group_reader;
         } else if (input_filenames.size() > 1) {
             MXFSequenceReader *seq_reader = new MXFSequenceReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> seq_file_readers;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *seq_file_reader = new MXFFileReader();
                 seq_file_reader->SetFileFactory(&file_factory, false);
                 seq_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 seq_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
-                result = seq_file_reader->Open(input_filenames[i]);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                seq_file_reader->SetReadAhead(read_ahead);
+                seq_file_readers.push_back(seq_file_reader);
+            }
+            vector<MXFFileReader::OpenResult> results = open_file_readers(seq_file_readers, input_filenames,
+                                                                          open_threads);
+            for (i = 0; i < results.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", input_filenames[i],
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(seq_file_reader, disable_track_indexes[i],
+                disable_tracks(seq_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                seq_reader->AddReader(seq_file_reader);
+                seq_reader->AddReader(seq_file_readers[i]);
             }
             if (!seq_reader->Finalize(false, keep_input_order))
                 throw false;
@@ -2785,6 +3336,7 @@ int main(int argc, const char** argv)
             file_reader->SetFileFactory(&file_factory, false);
             file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
             file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+            file_reader->SetReadAhead(read_ahead);
             if (pass_dm && clip_sub_type == AS11_CLIP_SUB_TYPE)
                 AS11Info::RegisterExtensions(file_reader->GetHeaderMetadata());
             if (pass_dm && clip_sub_type == AS10_CLIP_SUB_TYPE)
@@ -2854,12 +3406,19 @@ int main(int argc, const char** argv)
         }
 
 
+        // frames are re-used once deleted and reference the content package data read by the essence reader
+        // rather than a copy
+
+        size_t i;
+        for (i = 0; i < reader->GetNumTrackReaders(); i++)
+            reader->GetTrackReader(i)->GetFrameBuffer()->SetFrameFactory(new PooledFrameFactory(FRAME_POOL_SIZE), true);
+
+
         // check whether the frame rate is a sound sampling rate
         // a frame rate that is a sound sampling rate will result in the timecode rate being used as
         // the clip frame rate and the timecode rate defaulting to 25fps if not set by the user
 
         bool is_sound_frame_rate = false;
-        size_t i;
         for (i = 0; i < reader->GetNumTrackReaders(); i++) {
             const MXFSoundTrackInfo *input_sound_info =
                 dynamic_cast<const MXFSoundTrackInfo*>(reader->GetTrackReader(i)->GetTrackInfo());
@@ -3336,6 +3895,7 @@ int main(int argc, const char** argv)
             op1a_clip->SetOutputEndOffset(- rollout);
             op1a_clip->SetAddTimecodeTrack(!no_tc_track);
             op1a_clip->SetPrimaryPackage(op1a_primary_package);
+            op1a_clip->SetWriteBehind(op1a_write_behind);
         } else if (clip_type == CW_AVID_CLIP_TYPE) {
             AvidClip *avid_clip = clip->GetAvidClip();
 
@@ -4171,84 +4731,67 @@ int main(int argc, const char** argv)
             rt_start = get_tick_count();
 
 
-        // growing input files
+        // read and process stages, which run in separate threads if num_threads > 1
+
+        TranswrapStages stages;
+        stages.reader                 = reader;
+        stages.file_reader            = file_reader;
+        stages.input_tracks           = &input_tracks;
+        stages.clip_type              = clip_type;
+        stages.read_duration          = reader->GetReadDuration();
+        stages.sample_sequence        = sample_sequence;
+        stages.sample_sequence_offset = sample_sequence_offset;
+        stages.max_samples_per_read   = max_samples_per_read;
+        stages.frame_rate             = frame_rate;
+        stages.growing_file           = growing_file;
+        stages.gf_retries             = gf_retries;
+        stages.gf_retry_delay         = gf_retry_delay;
+        stages.gf_rate_after_fail     = gf_rate_after_fail;
+        stages.ignore_d10_aes3_flags  = ignore_d10_aes3_flags;
+        stages.pass_anc               = pass_anc;
+        if (rdd6_filename) {
+            // expecting last track to be RDD-6 from an XML file
+            BMX_ASSERT(!output_tracks.back()->HaveInputTrack() &&
+                       !output_tracks.back()->IsSilenceTrack());
+
+            stages.have_rdd6            = true;
+            stages.rdd6_frame           = &rdd6_frame;
+            stages.rdd6_static_sequence = &rdd6_static_sequence;
+            stages.rdd6_first_buffer    = &rdd6_first_buffer;
+            stages.rdd6_second_buffer   = &rdd6_second_buffer;
+            stages.rdd6_pair_in_frame   = rdd6_pair_in_frame;
+            stages.rdd6_sdid            = rdd6_sdid;
+            stages.rdd6_lines           = rdd6_lines;
+        }
 
-        unsigned int gf_retry_count = 0;
-        bool gf_read_failure = false;
-        int64_t gf_failure_num_read = 0;
-        uint32_t gf_failure_start = 0;
+        uint32_t num_process_threads = 0;
+        if (num_threads > 1)
+            num_process_threads = (num_threads > 2 ? num_threads - 2 : 1);
+        PacketPipeline pipeline(&stages, num_process_threads, 2 * num_process_threads + 2);
 
 
         // create clip file(s) and write samples
 
         clip->PrepareWrite();
 
+        pipeline.Start();
+
         float next_progress_update;
         init_progress(&next_progress_update);
 
         int64_t read_duration = reader->GetReadDuration();
         int64_t total_read = 0;
-        bool even_frame = true;
         int64_t duration_at_precharge_end = -1;
         int64_t duration_at_rollout_start = -1;
         int64_t container_duration;
         int64_t prev_container_duration = -1;
-        bmx::ByteArray sound_buffer;
-        while (read_duration < 0 || total_read < read_duration) {
-            uint32_t num_read = read_samples(reader, sample_sequence, &sample_sequence_offset, max_samples_per_read);
-            if (num_read == 0) {
-                if (!growing_file || !reader->ReadError() || gf_retry_count >= gf_retries)
-                    break;
-                gf_retry_count++;
-                gf_read_failure = true;
-                if (gf_retry_delay > 0.0) {
-                    rt_sleep(1.0f / gf_retry_delay, get_tick_count(), frame_rate,
-                             frame_rate.numerator / frame_rate.denominator);
-                }
-                continue;
-            }
-            if (growing_file && gf_retry_count > 0) {
-                gf_failure_num_read = total_read;
-                gf_failure_start    = get_tick_count();
-                gf_retry_count      = 0;
-            }
-
-            // check whether any incomplete frames (where requested samples < read samples) are supported
-            bool add_pcm_padding = false;
-            for (i = 0; i < input_tracks.size(); i++) {
-                MXFInputTrack *input_track = input_tracks[i];
-                if (input_track->GetTrackInfo()->essence_type == TIMED_TEXT) {
-                    // timed text is handled elsewhere
-                    continue;
-                }
-
-                Frame *frame = input_track->GetFrameBuffer()->GetLastFrame(false);
-                BMX_ASSERT(frame);
-
-                if (!frame->IsComplete()) {
-                    const MXFTrackInfo *input_track_info = input_track->GetTrackInfo();
-                    // only support padding with PCM samples and where the input edit rate equals audio sampling rate
-                    if (input_track_info->essence_type != WAVE_PCM ||
-                        input_track_info->edit_rate != ((MXFSoundTrackInfo*)input_track_info)->sampling_rate)
-                    {
-                        log_warn("Unable to provide PCM padding data for incomplete frame\n");
-                        break;
-                    }
-
-                    // transferring partial frame data is only supported for the WAVE clip type
-                    if (!frame->IsEmpty() && clip_type != CW_WAVE_CLIP_TYPE) {
-                        log_warn("Transferring partial PCM frame data is only supported for %s\n",
-                                 clip_type_to_string(CW_WAVE_CLIP_TYPE, NO_CLIP_SUB_TYPE));
-                        break;
-                    }
-
-                    // only pad partial frames if not outputting to WAVE
-                    if (clip_type != CW_WAVE_CLIP_TYPE)
-                        add_pcm_padding = true;
-                }
-            }
-            if (i < input_tracks.size())
+        while (true) {
+            unique_ptr<PipelinePacket> pipeline_packet(pipeline.NextPacket());
+            if (!pipeline_packet.get())
                 break;
+            TranswrapPacket *packet = dynamic_cast<TranswrapPacket*>(pipeline_packet.get());
+            BMX_ASSERT(packet);
+            uint32_t num_read = packet->num_read;
 
             if (clip_type == CW_AS02_CLIP_TYPE && (precharge || rollout)) {
                 container_duration = clip->GetDuration();
@@ -4266,14 +4809,12 @@ int main(int argc, const char** argv)
             uint32_t first_sound_num_samples = 0;
             for (i = 0; i < input_tracks.size(); i++) {
                 MXFInputTrack *input_track = input_tracks[i];
-                if (input_track->GetTrackInfo()->essence_type == TIMED_TEXT) {
+                Frame *frame = packet->frames[i];
+                if (!frame) {
                     // timed text is handled elsewhere
                     continue;
                 }
 
-                Frame *frame = input_track->GetFrameBuffer()->GetLastFrame(true);
-                BMX_ASSERT(frame);
-
                 if (clip_type == CW_AVID_CLIP_TYPE && convert_ess_marks) {
                     const vector<FrameMetadata*> *metadata = frame->GetMetadata(SDTI_CP_PACKAGE_METADATA_FMETA_ID);
                     if (metadata && !metadata->empty()) {
@@ -4296,18 +4837,11 @@ int main(int argc, const char** argv)
                 for (k = 0; k < input_track->GetOutputTrackCount(); k++) {
                     OutputTrack *output_track = input_track->GetOutputTrack(k);
                     uint32_t output_channel_index = input_track->GetOutputChannelIndex(k);
-                    uint32_t input_channel_index = input_track->GetInputChannelIndex(k);
+                    const TranswrapSamples &samples = packet->samples[i][k];
 
                     const MXFTrackInfo *input_track_info = input_track->GetTrackInfo();
                     const MXFSoundTrackInfo *input_sound_info = dynamic_cast<const MXFSoundTrackInfo*>(input_track_info);
 
-                    uint32_t bits_per_sample = 0;
-                    uint16_t channel_block_align = 0;
-                    if (input_sound_info) {
-                        bits_per_sample     = input_sound_info->bits_per_sample;
-                        channel_block_align = (bits_per_sample + 7) / 8;
-                    }
-
                     uint32_t num_samples = 0;
                     if (output_track->HaveSkipPrecharge())
                     {
@@ -4315,46 +4849,18 @@ int main(int argc, const char** argv)
                     }
                     else if (!frame->IsEmpty())
                     {
-                        if ((input_sound_info && input_sound_info->channel_count > 1) ||
-                                input_track_info->essence_type == D10_AES3_PCM)
-                        {
-                            sound_buffer.Allocate(frame->GetSize()); // more than enough
-                            if (input_track_info->essence_type == D10_AES3_PCM) {
-                                convert_aes3_to_pcm(frame->GetBytes(), frame->GetSize(), ignore_d10_aes3_flags,
-                                                    bits_per_sample, input_channel_index,
-                                                    sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                num_samples = get_aes3_sample_count(frame->GetBytes(), frame->GetSize());
-                            } else {
-                                deinterleave_audio(frame->GetBytes(), frame->GetSize(),
-                                                   bits_per_sample,
-                                                   input_sound_info->channel_count, input_channel_index,
-                                                   sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                num_samples = frame->GetSize() / (input_sound_info->channel_count * channel_block_align);
-                            }
-
-                            output_track->WriteSamples(output_channel_index,
-                                                       sound_buffer.GetBytes(),
-                                                       num_samples * channel_block_align,
-                                                       num_samples);
-                        }
-                        else if (input_track_info->essence_type == ANC_DATA)
+                        if (input_track_info->essence_type == ANC_DATA)
                         {
-                            write_anc_samples(output_track, frame, pass_anc, anc_buffer);
+                            output_track->WriteSamples(0, samples.data, samples.size, samples.num_samples);
                         }
                         else
                         {
-                            if (input_sound_info)
-                                num_samples = frame->GetSize() / channel_block_align;
-                            else
-                                num_samples = frame->num_samples;
-                            output_track->WriteSamples(output_channel_index,
-                                                       (unsigned char*)frame->GetBytes(),
-                                                       frame->GetSize(),
-                                                       num_samples);
+                            num_samples = samples.num_samples;
+                            output_track->WriteSamples(output_channel_index, samples.data, samples.size, num_samples);
                         }
                     }
 
-                    if (add_pcm_padding && !frame->IsComplete()) {
+                    if (packet->add_pcm_padding && !frame->IsComplete()) {
                         BMX_ASSERT(input_track_info->essence_type == WAVE_PCM);
                         BMX_ASSERT(input_sound_info->edit_rate == input_sound_info->sampling_rate);
                         num_samples = frame->request_num_samples - frame->num_samples;
@@ -4364,8 +4870,6 @@ int main(int argc, const char** argv)
                     if (input_sound_info && first_sound_num_samples == 0 && num_samples > 0)
                         first_sound_num_samples = num_samples;
                 }
-
-                delete frame;
             }
 
             // write samples for silence tracks
@@ -4381,26 +4885,8 @@ int main(int argc, const char** argv)
 
 
             if (rdd6_filename) {
-                // expecting last track to be RDD-6 from an XML file
-                BMX_ASSERT(!output_tracks.back()->HaveInputTrack() &&
-                           !output_tracks.back()->IsSilenceTrack());
-
-                if (rdd6_pair_in_frame || even_frame)
-                    rdd6_frame.UpdateStaticFrame(&rdd6_static_sequence);
-
-                if (rdd6_pair_in_frame) {
-                    construct_anc_rdd6(&rdd6_frame, &rdd6_first_buffer, &rdd6_second_buffer, rdd6_sdid, rdd6_lines, &anc_buffer);
-                } else {
-                    if (even_frame)
-                        construct_anc_rdd6_sub_frame(&rdd6_frame, true, &rdd6_first_buffer, rdd6_sdid, rdd6_lines[0], &anc_buffer);
-                    else
-                        construct_anc_rdd6_sub_frame(&rdd6_frame, false, &rdd6_second_buffer, rdd6_sdid, rdd6_lines[1], &anc_buffer);
-                }
-                output_tracks.back()->WriteSamples(0, anc_buffer.GetBytes(), anc_buffer.GetSize(), 1);
-
-                if (rdd6_pair_in_frame || !even_frame)
-                    rdd6_static_sequence.UpdateForNextStaticFrame();
-                even_frame = !even_frame;
+                output_tracks.back()->WriteSamples(0, packet->rdd6_anc_buffer.GetBytes(),
+                                                   packet->rdd6_anc_buffer.GetSize(), 1);
             }
 
 
@@ -4410,18 +4896,18 @@ int main(int argc, const char** argv)
             if (show_progress)
                 print_progress(total_read, read_duration, &next_progress_update);
 
-            if (max_samples_per_read > 1 && num_read < max_samples_per_read)
-                break;
-
-            if (gf_read_failure)
-                rt_sleep(gf_rate_after_fail, gf_failure_start, frame_rate, total_read - gf_failure_num_read);
-            else if (realtime)
+            // the read rate after a growing file read failure is limited in the read stage
+            if (realtime && !packet->gf_read_failure)
                 rt_sleep(rt_factor, rt_start, frame_rate, total_read);
+
+            pipeline_packet.release();
+            stages.ReleasePacket(packet);
         }
+        pipeline.Stop();
         if (reader->ReadError()) {
             bmx::log(reader->IsComplete() ? ERROR_LOG : WARN_LOG,
                      "A read error occurred: %s\n", reader->ReadErrorMessage().c_str());
-            if (gf_retry_count >= gf_retries)
+            if (stages.gf_retry_count >= gf_retries)
                 log_warn("Reached maximum growing file retries, %u\n", gf_retries);
             if (reader->IsComplete())
                 cmd_result = 1;
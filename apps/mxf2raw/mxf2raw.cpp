@@ -140,6 +140,8 @@ static const char *XML_INFO_WRITER_VERSION      = "0.1"; // format <major>.<mino
 static const char* STDIN_FILENAME = "stdin:";
 
 static const uint32_t DEFAULT_HTTP_MIN_READ = 64 * 1024;
+static const uint32_t DEFAULT_HTTP_CACHE_BLOCKS = 64;
+static const uint32_t DEFAULT_HTTP_PREFETCH = 4;
 
 
 namespace bmx
@@ -404,6 +406,27 @@ static void disable_tracks(MXFReader *reader, const set<size_t> &track_indexes,
     }
 }
 
+static vector<MXFFileReader::OpenResult> open_file_readers(const vector<MXFFileReader*> &file_readers,
+                                                          const vector<const char*> &filenames,
+                                                          int mode_flags, uint32_t num_threads)
+{
+    if (num_threads > 1) {
+        vector<string> filename_strs(filenames.begin(), filenames.end());
+        return MXFFileReader::OpenParallel(file_readers, filename_strs, mode_flags, num_threads);
+    }
+
+    // stop at the first failure
+    vector<MXFFileReader::OpenResult> results;
+    size_t i;
+    for (i = 0; i < file_readers.size(); i++) {
+        results.push_back(file_readers[i]->Open(filenames[i], mode_flags));
+        if (results.back() != MXFFileReader::MXF_RESULT_SUCCESS)
+            break;
+    }
+
+    return results;
+}
+
 static string get_d10_sound_flags(uint8_t flags)
 {
     char buf[10];
@@ -1589,10 +1612,15 @@ static void usage(const char *cmd)
     fprintf(stderr, " --file-chksum-only <type>\n");
     fprintf(stderr, "                       Calculate checksum of the file(s) and exit\n");
     fprintf(stderr, "                       <type> is one of the following: 'crc32', 'md5', 'sha1'\n");
+    fprintf(stderr, "                       The option can be repeated and multiple checksums are calculated in parallel\n");
     fprintf(stderr, "\n");
     fprintf(stderr, " --group               Use the group reader instead of the sequence reader\n");
     fprintf(stderr, "                       Use this option if the files have different material packages\n");
     fprintf(stderr, "                       but actually belong to the same virtual package / group\n");
+    fprintf(stderr, " --group-threads <count>\n");
+    fprintf(stderr, "                       Read the --group input files in parallel using <count> threads. The default is 1\n");
+    fprintf(stderr, " --open-threads <count>\n");
+    fprintf(stderr, "                       Open the --group or sequence input files in parallel using <count> threads. The default is 1\n");
     fprintf(stderr, " --no-reorder          Don't attempt to re-order the inputs, based on timecode, when constructing a sequence\n");
     fprintf(stderr, "                       Use this option for files with broken timecode\n");
     fprintf(stderr, "\n");
@@ -1608,6 +1636,8 @@ static void usage(const char *cmd)
     fprintf(stderr, "                       <type> is one of the following: 'crc32', 'md5', 'sha1'\n");
     fprintf(stderr, " --file-chksum <type>  Calculate checksum of the input file(s)\n");
     fprintf(stderr, "                       <type> is one of the following: 'crc32', 'md5', 'sha1'\n");
+    fprintf(stderr, " --file-chksum-stream  Calculate the --file-chksum checksums in a separate thread using a sequential read of the file\n");
+    fprintf(stderr, "                       This avoids re-reading parts of the file skipped by the reader. It is not supported for stdin or HTTP input\n");
     fprintf(stderr, " --as11                Extract AS-11 and UK DPP metadata\n");
     fprintf(stderr, " --as10                Extract AS-10 metadata\n");
     fprintf(stderr, " --app                 Extract APP metadata\n");
@@ -1650,19 +1680,30 @@ static void usage(const char *cmd)
     fprintf(stderr, "                       <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
 #if defined(_WIN32)
     fprintf(stderr, " --no-seq-scan         Do not set the sequential scan hint for optimizing file caching\n");
+#endif
 #if !defined(__MINGW32__)
     fprintf(stderr, " --mmap-file           Use memory-mapped file I/O for the MXF files\n");
     fprintf(stderr, "                       Note: this may reduce file I/O performance and was found to be slower over network drives\n");
 #endif
-#endif
+    fprintf(stderr, " --lazy-index <count>  Parse VBE index table segments when first used instead of when the file is opened\n");
+    fprintf(stderr, "                       Keep at most <count> parsed segments in memory. The default is 0, i.e. disabled\n");
+    fprintf(stderr, " --index-cache         Cache the index table and essence container layout of complete files in a '<filename>.bmxidx'\n");
+    fprintf(stderr, "                       sidecar file and use it to skip scanning the file when it is opened again\n");
+    fprintf(stderr, " --index-cache-dir <dir>\n");
+    fprintf(stderr, "                       Same as --index-cache but the sidecar files are stored in <dir>\n");
     fprintf(stderr, " --gf                  Support growing files. Retry reading a frame when it fails\n");
     fprintf(stderr, " --gf-retries <max>    Set the maximum times to retry reading a frame. The default is %u.\n", DEFAULT_GF_RETRIES);
     fprintf(stderr, " --gf-delay <sec>      Set the delay (in seconds) between a failure to read and a retry. The default is %f.\n", DEFAULT_GF_RETRY_DELAY);
+    fprintf(stderr, "                       A single input file is retried as soon as it is modified and the retry is only counted if it wasn't\n");
     fprintf(stderr, " --gf-rate <factor>    Limit the read rate to realtime rate x <factor> after a read failure. The default is %f\n", DEFAULT_GF_RATE_AFTER_FAIL);
     fprintf(stderr, "                       <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
     if (mxf_http_is_supported()) {
         fprintf(stderr, " --http-min-read <bytes>\n");
         fprintf(stderr, "                       Set the minimum number of bytes to read when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_MIN_READ);
+        fprintf(stderr, " --http-cache-blocks <count>\n");
+        fprintf(stderr, "                       Set the number of <min read> sized blocks to cache when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_CACHE_BLOCKS);
+        fprintf(stderr, " --http-prefetch <count>\n");
+        fprintf(stderr, "                       Set the maximum number of parallel HTTP range requests made ahead of reads. The default is %u. 0 disables prefetching\n", DEFAULT_HTTP_PREFETCH);
     }
     fprintf(stderr, "\n");
     fprintf(stderr, " --text-out <prefix>   Extract text based objects to files starting with <prefix>\n");
@@ -1685,6 +1726,8 @@ int main(int argc, const char** argv)
     LogLevel log_level = INFO_LOG;
     set<ChecksumType> file_checksum_only_types;
     bool use_group_reader = false;
+    uint32_t group_read_threads = 1;
+    uint32_t open_threads = 1;
     bool keep_input_order = false;
     bool check_end = false;
     bool check_complete = false;
@@ -1694,6 +1737,7 @@ int main(int argc, const char** argv)
     const char *info_filename = 0;
     set<ChecksumType> track_checksum_types;
     set<ChecksumType> file_checksum_types;
+    bool file_checksum_stream = false;
     bool do_as11_info = false;
     bool do_as10_info = false;
     bool do_app_info = false;
@@ -1706,6 +1750,9 @@ int main(int argc, const char** argv)
     bool do_index_info = false;
     bool do_avid_info = false;
     uint32_t st436_manifest_count = DEFAULT_ST436_MANIFEST_COUNT;
+    uint32_t lazy_index_segments = 0;
+    bool index_cache = false;
+    const char *index_cache_dir = "";
     const char *rdd6_filename = 0;
     int64_t rdd6_frame_min = 0;
     int64_t rdd6_frame_max = 0;
@@ -1735,8 +1782,10 @@ int main(int argc, const char** argv)
     float gf_retry_delay = DEFAULT_GF_RETRY_DELAY;
     float gf_rate_after_fail = DEFAULT_GF_RATE_AFTER_FAIL;
     uint32_t http_min_read = DEFAULT_HTTP_MIN_READ;
+    uint32_t http_cache_blocks = DEFAULT_HTTP_CACHE_BLOCKS;
+    uint32_t http_prefetch = DEFAULT_HTTP_PREFETCH;
     ChecksumType checkum_type;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     bool use_mmap_file = false;
 #endif
     const char *text_output_prefix = 0;
@@ -1815,6 +1864,40 @@ int main(int argc, const char** argv)
         {
             use_group_reader = true;
         }
+        else if (strcmp(argv[cmdln_index], "--group-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            group_read_threads = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--open-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            open_threads = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--no-reorder") == 0)
         {
             keep_input_order = true;
@@ -1908,6 +1991,10 @@ int main(int argc, const char** argv)
             do_write_info = true;
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--file-chksum-stream") == 0)
+        {
+            file_checksum_stream = true;
+        }
         else if (strcmp(argv[cmdln_index], "--as11") == 0)
         {
             do_as11_info = true;
@@ -2132,12 +2219,45 @@ int main(int argc, const char** argv)
         {
             file_flags &= ~MXF_WIN32_FLAG_SEQUENTIAL_SCAN;
         }
+#endif
+        else if (strcmp(argv[cmdln_index], "--index-cache") == 0)
+        {
+            index_cache = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--index-cache-dir") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            index_cache = true;
+            index_cache_dir = argv[cmdln_index + 1];
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--lazy-index") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            lazy_index_segments = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
 #if !defined(__MINGW32__)
         else if (strcmp(argv[cmdln_index], "--mmap-file") == 0)
         {
             use_mmap_file = true;
         }
-#endif
 #endif
         else if (strcmp(argv[cmdln_index], "--gf") == 0)
         {
@@ -2222,6 +2342,40 @@ int main(int argc, const char** argv)
             http_min_read = (uint32_t)(uvalue);
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--http-cache-blocks") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            http_cache_blocks = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--http-prefetch") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            http_prefetch = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--regtest") == 0)
         {
             BMX_REGRESSION_TEST = true;
@@ -2380,54 +2534,69 @@ int main(int argc, const char** argv)
 
         if (!file_checksum_types.empty())
             file_factory.SetInputChecksumTypes(file_checksum_types);
+        file_factory.SetInputChecksumStream(file_checksum_stream);
         file_factory.SetInputFlags(file_flags);
         file_factory.SetHTTPMinReadSize(http_min_read);
-#if defined(_WIN32) && !defined(__MINGW32__)
+        file_factory.SetHTTPCache(http_cache_blocks, http_prefetch);
+#if !defined(__MINGW32__)
         file_factory.SetUseMMapFile(use_mmap_file);
 #endif
 
         int input_open_flags = do_parse_read && !do_ess_read ? MXFFileReader::MXF_MODE_PARSE_ONLY : 0;
         if (use_group_reader && input_filenames.size() > 1) {
             MXFGroupReader *group_reader = new MXFGroupReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> grp_file_readers;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *grp_file_reader = new MXFFileReader();
                 grp_file_reader->SetFileFactory(&file_factory, false);
                 grp_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 grp_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
-                result = grp_file_reader->Open(input_filenames[i], input_open_flags);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                grp_file_reader->SetLazyIndex(lazy_index_segments);
+                grp_file_reader->SetIndexCache(index_cache, index_cache_dir);
+                grp_file_readers.push_back(grp_file_reader);
+            }
+            vector<MXFFileReader::OpenResult> results = open_file_readers(grp_file_readers, input_filenames,
+                                                                          input_open_flags, open_threads);
+            for (i = 0; i < results.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", get_input_filename(input_filenames[i]),
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(grp_file_reader, disable_track_indexes[i],
+                disable_tracks(grp_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                group_reader->AddReader(grp_file_reader);
+                group_reader->AddReader(grp_file_readers[i]);
             }
             if (!group_reader->Finalize())
                 throw false;
+            group_reader->SetReadThreads(group_read_threads);
 
             reader = group_reader;
         } else if (input_filenames.size() > 1) {
             MXFSequenceReader *seq_reader = new MXFSequenceReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> seq_file_readers;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *seq_file_reader = new MXFFileReader();
                 seq_file_reader->SetFileFactory(&file_factory, false);
                 seq_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 seq_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
-                result = seq_file_reader->Open(input_filenames[i], input_open_flags);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                seq_file_reader->SetLazyIndex(lazy_index_segments);
+                seq_file_reader->SetIndexCache(index_cache, index_cache_dir);
+                seq_file_readers.push_back(seq_file_reader);
+            }
+            vector<MXFFileReader::OpenResult> results = open_file_readers(seq_file_readers, input_filenames,
+                                                                          input_open_flags, open_threads);
+            for (i = 0; i < results.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", get_input_filename(input_filenames[i]),
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(seq_file_reader, disable_track_indexes[i],
+                disable_tracks(seq_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                seq_reader->AddReader(seq_file_reader);
+                seq_reader->AddReader(seq_file_readers[i]);
             }
             if (!seq_reader->Finalize(false, keep_input_order))
                 throw false;
@@ -2439,6 +2608,8 @@ int main(int argc, const char** argv)
             file_reader->SetFileFactory(&file_factory, false);
             file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
             file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+            file_reader->SetLazyIndex(lazy_index_segments);
+            file_reader->SetIndexCache(index_cache, index_cache_dir);
             if (do_as11_info)
                 as11_register_extensions(file_reader);
             if (do_as10_info)
@@ -2690,6 +2861,7 @@ int main(int argc, const char** argv)
 
             // read data
             bmx::ByteArray sound_buffer;
+            vector<unsigned char*> channel_buffers;
             int64_t total_num_read = 0;
             while (true)
             {
@@ -2697,11 +2869,17 @@ int main(int argc, const char** argv)
                 if (num_read == 0) {
                     if (!growing_file || !reader->ReadError() || gf_retry_count >= gf_retries)
                         break;
-                    gf_retry_count++;
                     gf_read_failure = true;
-                    if (gf_retry_delay > 0.0) {
-                        rt_sleep(1.0f / gf_retry_delay, get_tick_count(), edit_rate,
-                                 edit_rate.numerator / edit_rate.denominator);
+                    gf_retry_count++;
+                    if (file_reader) {
+                        // retry as soon as the file is modified
+                        file_reader->WaitForUpdate((uint32_t)(gf_retry_delay * 1000));
+                        file_reader->Refresh();
+                    } else {
+                        if (gf_retry_delay > 0.0) {
+                            rt_sleep(1.0f / gf_retry_delay, get_tick_count(), edit_rate,
+                                     edit_rate.numerator / edit_rate.denominator);
+                        }
                     }
                     continue;
                 }
@@ -2812,24 +2990,33 @@ int main(int argc, const char** argv)
                             string filename;
                             const MXFSoundTrackInfo *sound_info = dynamic_cast<const MXFSoundTrackInfo*>(track_info);
                             if (sound_info && deinterleave && sound_info->channel_count > 1) {
+                                // split all channels in a single pass into consecutive regions of the buffer
+                                uint32_t channel_size;
+                                if (sound_info->essence_type == D10_AES3_PCM) {
+                                    channel_size = sound_info->block_align / sound_info->channel_count *
+                                                        get_aes3_sample_count(frame->GetBytes(), frame->GetSize());
+                                } else {
+                                    channel_size = frame->GetSize() / sound_info->channel_count;
+                                }
                                 sound_buffer.Allocate(frame->GetSize()); // more than enough
+                                channel_buffers.resize(sound_info->channel_count);
                                 uint32_t c;
+                                for (c = 0; c < sound_info->channel_count; c++)
+                                    channel_buffers[c] = sound_buffer.GetBytes() + c * channel_size;
+                                if (sound_info->essence_type == D10_AES3_PCM) {
+                                    convert_aes3_to_pcm_channels(frame->GetBytes(), frame->GetSize(), false,
+                                                                 sound_info->bits_per_sample,
+                                                                 (uint8_t)sound_info->channel_count,
+                                                                 &channel_buffers[0], channel_size);
+                                } else {
+                                    deinterleave_audio_channels(frame->GetBytes(), frame->GetSize(),
+                                                                sound_info->bits_per_sample, sound_info->channel_count,
+                                                                &channel_buffers[0], channel_size);
+                                }
                                 for (c = 0; c < sound_info->channel_count; c++) {
-                                    if (sound_info->essence_type == D10_AES3_PCM) {
-                                        convert_aes3_to_pcm(frame->GetBytes(), frame->GetSize(), false,
-                                                            sound_info->bits_per_sample, c,
-                                                            sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                        sound_buffer.SetSize(sound_info->block_align / sound_info->channel_count *
-                                                                get_aes3_sample_count(frame->GetBytes(), frame->GetSize()));
-                                    } else {
-                                        deinterleave_audio(frame->GetBytes(), frame->GetSize(),
-                                                           sound_info->bits_per_sample, sound_info->channel_count, c,
-                                                           sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                        sound_buffer.SetSize(frame->GetSize() / sound_info->channel_count);
-                                    }
                                     output_file_manager.GetTrackFile(i, c, &file, &filename);
                                     write_data(file, filename,
-                                               sound_buffer.GetBytes(), sound_buffer.GetSize(),
+                                               channel_buffers[c], channel_size,
                                                (wrap_klv_mask.find(track_info->data_def) != wrap_klv_mask.end()),
                                                &frame->element_key);
                                 }
@@ -45,6 +45,7 @@
 #include <vector>
 #include <algorithm>
 #include <sstream>
+#include <memory>
 
 #include "RawInputTrack.h"
 #include "../writers/OutputTrack.h"
@@ -73,6 +74,7 @@
 #include <bmx/URI.h>
 #include <bmx/MXFUtils.h>
 #include <bmx/Utils.h>
+#include <bmx/ThreadPool.h>
 #include <bmx/Version.h>
 #include <bmx/apps/AppUtils.h>
 #include <bmx/apps/TimedTextManifestParser.h>
@@ -424,6 +426,7 @@ static void usage(const char *cmd)
     fprintf(stderr, "  --dur <frame>           Set the duration in frames in frame rate units. Default is minimum input duration\n");
     fprintf(stderr, "  --rt <factor>           Wrap at realtime rate x <factor>, where <factor> is a floating point value\n");
     fprintf(stderr, "                          <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+    fprintf(stderr, "  --read-threads <count>  Read the inputs in parallel using <count> threads. The default is 1\n");
     fprintf(stderr, "  --avcihead <format> <file> <offset>\n");
     fprintf(stderr, "                          Default AVC-Intra sequence header data (512 bytes) to use when the input file does not have it\n");
     fprintf(stderr, "                          <format> is a comma separated list of one or more of the following integer values:\n");
@@ -505,6 +508,7 @@ static void usage(const char *cmd)
     fprintf(stderr, "    --aes-3                 Use AES-3 audio mapping\n");
     fprintf(stderr, "    --kag-size-512          Set KAG size to 512, instead of 1\n");
     fprintf(stderr, "    --primary-package       Set the header metadata set primary package property to the top-level file source package\n");
+    fprintf(stderr, "    --write-behind          Write the file in a separate thread\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "  op1a/rdd9/d10:\n");
     fprintf(stderr, "    --xml-scheme-id <id>    Set the XML payload scheme identifier associated with the following --embed-xml option.\n");
@@ -817,6 +821,7 @@ int main(int argc, const char** argv)
     bool aes3 = false;
     bool kag_size_512 = false;
     bool op1a_primary_package = false;
+    bool op1a_write_behind = false;
     AS10Shim as10_shim = AS10_UNKNOWN_SHIM;
     const char *mpeg_descr_defaults_name = 0;
     bool mpeg_descr_frame_checks = true;
@@ -880,6 +885,7 @@ int main(int argc, const char** argv)
     bool force_no_avci_head = false;
     bool realtime = false;
     float rt_factor = 1.0;
+    uint32_t read_threads = 1;
     bool product_info_set = false;
     string company_name;
     string product_name;
@@ -1114,6 +1120,23 @@ int main(int argc, const char** argv)
             realtime = true;
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--read-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            read_threads = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--avcihead") == 0)
         {
             if (cmdln_index + 3 >= argc)
@@ -1412,6 +1435,10 @@ int main(int argc, const char** argv)
         {
             op1a_primary_package = true;
         }
+        else if (strcmp(argv[cmdln_index], "--write-behind") == 0)
+        {
+            op1a_write_behind = true;
+        }
         else if (strcmp(argv[cmdln_index], "--xml-scheme-id") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -4650,6 +4677,7 @@ int main(int argc, const char** argv)
             op1a_clip->SetOutputEndOffset(- output_end_offset);
             op1a_clip->SetAddTimecodeTrack(!no_tc_track);
             op1a_clip->SetPrimaryPackage(op1a_primary_package);
+            op1a_clip->SetWriteBehind(op1a_write_behind);
 
             if (!have_samples_to_write) {
                 op1a_clip->SetInputDuration(duration);
@@ -5483,6 +5511,19 @@ int main(int argc, const char** argv)
             rt_start = get_tick_count();
 
 
+        // read the inputs in parallel if enabled. Each input has its own reader and file
+
+        vector<RawInput*> read_inputs;
+        for (i = 0; i < inputs.size(); i++) {
+            if (!inputs[i].disabled && inputs[i].essence_type != TIMED_TEXT)
+                read_inputs.push_back(&inputs[i]);
+        }
+        unique_ptr<ThreadPool> read_thread_pool;
+        vector<uint32_t> read_num_samples(read_inputs.size());
+        if (read_threads > 1 && read_inputs.size() > 1)
+            read_thread_pool.reset(new ThreadPool(read_threads < read_inputs.size() ? read_threads : (uint32_t)read_inputs.size()));
+
+
         // create clip file(s) and write samples
 
         clip->PrepareWrite();
@@ -5498,10 +5539,17 @@ int main(int argc, const char** argv)
             // read samples into input buffers first to ensure the frame data is available for all tracks
             uint32_t min_num_samples = max_samples_per_read;
             uint32_t num_samples;
-            for (i = 0; i < inputs.size(); i++) {
-                RawInput *input = &inputs[i];
-                if (!input->disabled && input->essence_type != TIMED_TEXT) {
-                    num_samples = read_samples(input, max_samples_per_read);
+            if (read_thread_pool) {
+                read_thread_pool->Run(read_inputs.size(), [&](size_t index) {
+                    read_num_samples[index] = read_samples(read_inputs[index], max_samples_per_read);
+                });
+                for (i = 0; i < read_inputs.size(); i++) {
+                    if (read_num_samples[i] < min_num_samples)
+                        min_num_samples = read_num_samples[i];
+                }
+            } else {
+                for (i = 0; i < read_inputs.size(); i++) {
+                    num_samples = read_samples(read_inputs[i], max_samples_per_read);
                     if (num_samples < min_num_samples) {
                         min_num_samples = num_samples;
                         if (min_num_samples == 0)
@@ -5581,6 +5629,9 @@ int main(int argc, const char** argv)
                 rt_sleep(rt_factor, rt_start, frame_rate, total_read);
         }
 
+        // stop the read threads before the inputs are cleared
+        read_thread_pool.reset();
+
 
         if (regtest_end < 0) { // only complete if not regression testing partial files
 
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "PacketPipeline.h"
+
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+PacketPipeline::PacketPipeline(PipelineStages *stages, uint32_t num_process_threads, uint32_t max_packets)
+{
+    BMX_CHECK(max_packets > 0);
+
+    mStages = stages;
+    mNumProcessThreads = num_process_threads;
+    mMaxPackets = max_packets;
+    mReadCount = 0;
+    mNextCount = 0;
+    mErrorCount = 0;
+    mReadEnd = false;
+    mStop = false;
+}
+
+PacketPipeline::~PacketPipeline()
+{
+    Stop();
+}
+
+void PacketPipeline::Start()
+{
+    if (mNumProcessThreads == 0)
+        return;
+
+    BMX_CHECK(mThreads.empty());
+
+    try
+    {
+        mThreads.push_back(thread(&PacketPipeline::ReadThread, this));
+        uint32_t i;
+        for (i = 0; i < mNumProcessThreads; i++)
+            mThreads.push_back(thread(&PacketPipeline::ProcessThread, this));
+    }
+    catch (...)
+    {
+        Stop();
+        throw;
+    }
+}
+
+PipelinePacket* PacketPipeline::NextPacket()
+{
+    if (mNumProcessThreads == 0) {
+        if (mReadEnd)
+            return 0;
+
+        PipelinePacket *packet = mStages->ReadPacket();
+        if (!packet) {
+            mReadEnd = true;
+            return 0;
+        }
+        try
+        {
+            mStages->ProcessPacket(packet);
+        }
+        catch (...)
+        {
+            delete packet;
+            throw;
+        }
+
+        return packet;
+    }
+
+    unique_lock<mutex> lock(mMutex);
+    map<int64_t, PipelinePacket*>::iterator iter;
+    while (true) {
+        // packets read before an error occurred are returned first
+        iter = mProcessedPackets.find(mNextCount);
+        if (iter != mProcessedPackets.end() ||
+            (mError && mNextCount >= mErrorCount) ||
+            (mReadEnd && mNextCount >= mReadCount) ||
+            mStop)
+        {
+            break;
+        }
+        mNextCond.wait(lock);
+    }
+
+    if (iter == mProcessedPackets.end()) {
+        exception_ptr error = mError;
+        lock.unlock();
+        Stop();
+        if (error)
+            rethrow_exception(error);
+        return 0;
+    }
+
+    PipelinePacket *packet = iter->second;
+    mProcessedPackets.erase(iter);
+    mNextCount++;
+    lock.unlock();
+    mReadCond.notify_one();
+
+    return packet;
+}
+
+void PacketPipeline::Stop()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mReadCond.notify_all();
+    mProcessCond.notify_all();
+    mNextCond.notify_all();
+
+    size_t i;
+    for (i = 0; i < mThreads.size(); i++)
+        mThreads[i].join();
+    mThreads.clear();
+
+    for (i = 0; i < mProcessQueue.size(); i++)
+        delete mProcessQueue[i].second;
+    mProcessQueue.clear();
+    map<int64_t, PipelinePacket*>::iterator iter;
+    for (iter = mProcessedPackets.begin(); iter != mProcessedPackets.end(); iter++)
+        delete iter->second;
+    mProcessedPackets.clear();
+}
+
+void PacketPipeline::ReadThread()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && !mError && mReadCount - mNextCount >= mMaxPackets)
+            mReadCond.wait(lock);
+        if (mStop || mError)
+            break;
+        lock.unlock();
+
+        PipelinePacket *packet = 0;
+        try
+        {
+            packet = mStages->ReadPacket();
+        }
+        catch (...)
+        {
+            lock.lock();
+            SetError(mReadCount);
+            break;
+        }
+
+        lock.lock();
+        if (!packet)
+            break;
+        if (mStop) {
+            delete packet;
+            break;
+        }
+        mProcessQueue.push_back(make_pair(mReadCount, packet));
+        mReadCount++;
+        mProcessCond.notify_one();
+    }
+
+    mReadEnd = true;
+    lock.unlock();
+    mProcessCond.notify_all();
+    mNextCond.notify_all();
+}
+
+void PacketPipeline::ProcessThread()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && !mReadEnd && mProcessQueue.empty())
+            mProcessCond.wait(lock);
+        if (mStop || mProcessQueue.empty())
+            break;
+
+        int64_t count = mProcessQueue.front().first;
+        PipelinePacket *packet = mProcessQueue.front().second;
+        mProcessQueue.pop_front();
+        lock.unlock();
+
+        try
+        {
+            mStages->ProcessPacket(packet);
+        }
+        catch (...)
+        {
+            delete packet;
+            lock.lock();
+            SetError(count);
+            continue;
+        }
+
+        lock.lock();
+        if (mStop) {
+            delete packet;
+            break;
+        }
+        mProcessedPackets[count] = packet;
+        mNextCond.notify_all();
+    }
+}
+
+void PacketPipeline::SetError(int64_t count)
+{
+    // called with the mutex locked and from within a catch block
+    if (!mError || count < mErrorCount) {
+        mError = current_exception();
+        mErrorCount = count;
+    }
+    mReadCond.notify_all();
+    mNextCond.notify_all();
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_PACKET_PIPELINE_H_
+#define BMX_PACKET_PIPELINE_H_
+
+#include <deque>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include <bmx/BMXTypes.h>
+
+
+namespace bmx
+{
+
+
+class PipelinePacket
+{
+public:
+    virtual ~PipelinePacket() {}
+};
+
+
+class PipelineStages
+{
+public:
+    virtual ~PipelineStages() {}
+
+    // called in sequence in the read thread. Returns 0 when there are no more packets
+    virtual PipelinePacket* ReadPacket() = 0;
+
+    // called concurrently in the process threads. Packets can be processed in any order
+    virtual void ProcessPacket(PipelinePacket *packet) = 0;
+};
+
+
+class PacketPipeline
+{
+public:
+    // num_process_threads 0 means packets are read and processed in the calling thread by NextPacket()
+    PacketPipeline(PipelineStages *stages, uint32_t num_process_threads, uint32_t max_packets);
+    ~PacketPipeline();
+
+    void Start();
+
+    // returns the next processed packet in read order, or 0 when there are no more packets
+    // an exception thrown in a read or process thread is re-thrown here
+    // the caller takes ownership of the packet
+    PipelinePacket* NextPacket();
+
+    // stops the threads and deletes any packets not yet returned by NextPacket()
+    void Stop();
+
+private:
+    void ReadThread();
+    void ProcessThread();
+
+    void SetError(int64_t count);
+
+private:
+    PipelineStages *mStages;
+    uint32_t mNumProcessThreads;
+    uint32_t mMaxPackets;
+
+    std::mutex mMutex;
+    std::condition_variable mReadCond;
+    std::condition_variable mProcessCond;
+    std::condition_variable mNextCond;
+    std::deque<std::pair<int64_t, PipelinePacket*> > mProcessQueue;
+    std::map<int64_t, PipelinePacket*> mProcessedPackets;
+    int64_t mReadCount;
+    int64_t mNextCount;
+    int64_t mErrorCount;
+    bool mReadEnd;
+    bool mStop;
+    std::exception_ptr mError;
+
+    std::vector<std::thread> mThreads;
+};
+
+
+};
+
+
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_CHUNKED_BYTE_ARRAY_H_
+#define BMX_CHUNKED_BYTE_ARRAY_H_
+
+#include <vector>
+
+#include <bmx/BMXTypes.h>
+
+
+
+namespace bmx
+{
+
+
+// Array of fixed size records stored in fixed size chunks. Appending a record doesn't reallocate or copy the
+// existing records and so record addresses remain valid until Clear is called. New records are zero initialized
+class ChunkedByteArray
+{
+public:
+    ChunkedByteArray(uint32_t record_size, uint32_t chunk_num_records);
+    ~ChunkedByteArray();
+
+    unsigned char* AppendRecord();
+    void AppendRecord(const unsigned char *bytes);
+
+    unsigned char* GetRecord(size_t index) const;
+
+    // sets bytes to the record at index and returns the number of records, up to end, that follow contiguously
+    size_t GetContiguousRecords(size_t index, size_t end, const unsigned char **bytes) const;
+
+    size_t GetNumRecords() const    { return mNumRecords; }
+    uint32_t GetRecordSize() const  { return mRecordSize; }
+    uint64_t GetSize() const        { return (uint64_t)mNumRecords * mRecordSize; }
+
+    void Clear();
+
+private:
+    std::vector<unsigned char*> mChunks;
+    uint32_t mRecordSize;
+    uint32_t mChunkNumRecords;
+    size_t mNumRecords;
+};
+
+
+};
+
+
+
+#endif
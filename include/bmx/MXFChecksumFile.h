@@ -34,6 +34,7 @@
 
 
 #include <string>
+#include <vector>
 
 #include <mxf/mxf_file.h>
 
@@ -48,12 +49,24 @@ namespace bmx
 typedef struct MXFChecksumFile MXFChecksumFile;
 
 MXFChecksumFile* mxf_checksum_file_open(MXFFile *target, ChecksumType type);
+// Multiple checksum types are calculated in parallel using a MultiChecksum
+MXFChecksumFile* mxf_checksum_file_open(MXFFile *target, const std::vector<ChecksumType> &types);
+// The checksum is calculated in a separate thread that reads stream_file, a separate read-only handle on the same
+// file as target, sequentially from the start. The checksum file takes ownership of stream_file
+MXFChecksumFile* mxf_checksum_file_open_stream(MXFFile *target, ChecksumType type, MXFFile *stream_file);
+MXFChecksumFile* mxf_checksum_file_open_stream(MXFFile *target, const std::vector<ChecksumType> &types,
+                                               MXFFile *stream_file);
 MXFFile* mxf_checksum_file_get_file(MXFChecksumFile *checksum_file);
 void mxf_checksum_file_force_update(MXFChecksumFile *checksum_file);
 bool mxf_checksum_file_final(MXFChecksumFile *checksum_file);
 size_t mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file);
 void mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, unsigned char *digest, size_t size);
 std::string mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file);
+// These variants select the digest when the checksum file was opened with multiple types
+size_t mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file, ChecksumType type);
+void mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, ChecksumType type, unsigned char *digest,
+                              size_t size);
+std::string mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file, ChecksumType type);
 
 
 };
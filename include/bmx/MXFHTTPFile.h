@@ -33,6 +33,8 @@
 #define BMX_MXF_HTTP_FILE_H_
 
 #include <string>
+#include <vector>
+#include <utility>
 
 #include <mxf/mxf_file.h>
 
@@ -47,6 +49,15 @@ bool mxf_http_is_url(const std::string &url_str);
 
 MXFFile* mxf_http_file_open_read(const std::string &url_str, uint32_t min_read_size);
 
+// Reads are cached in min_read_size blocks, with up to cache_blocks blocks kept in a LRU cache.
+// Up to prefetch_count range requests are run in parallel ahead of the reads, either for the
+// hinted ranges or the next blocks if reading sequentially.
+MXFFile* mxf_http_file_open_read(const std::string &url_str, uint32_t min_read_size, uint32_t cache_blocks,
+                                 uint32_t prefetch_count);
+
+// Hint the (offset, size) byte ranges that will be read next. Returns false if mxf_file is not a HTTP file
+bool mxf_http_file_hint_ranges(MXFFile *mxf_file, const std::vector<std::pair<int64_t, uint32_t> > &ranges);
+
 
 };
 
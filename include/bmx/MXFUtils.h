@@ -58,6 +58,8 @@ std::string convert_utf16_string(const unsigned char *utf16_str, uint16_t size);
 
 MXFDataDefEnum convert_essence_type_to_data_def(EssenceType essence_type);
 
+bool get_kl(const unsigned char *data, uint64_t size, mxfKey *key, uint8_t *llen, uint64_t *len);
+
 
 };
 
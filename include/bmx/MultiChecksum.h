@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_MULTI_CHECKSUM_H_
+#define BMX_MULTI_CHECKSUM_H_
+
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <bmx/Checksum.h>
+
+
+#define MULTI_CHECKSUM_CHUNK_SIZE       (4 * 1024 * 1024)
+#define MULTI_CHECKSUM_NUM_BUFFERS      3
+
+
+
+namespace bmx
+{
+
+
+// Calculates several checksums over the same data. Data is copied into chunks and each chunk is passed to
+// one thread per checksum type, with at most num_buffers chunks in flight. A single type is updated directly
+// on the calling thread
+class MultiChecksum
+{
+public:
+    MultiChecksum(const std::vector<ChecksumType> &types, uint32_t chunk_size = MULTI_CHECKSUM_CHUNK_SIZE,
+                  uint32_t num_buffers = MULTI_CHECKSUM_NUM_BUFFERS);
+    ~MultiChecksum();
+
+    void Update(const unsigned char *data, uint32_t size);
+
+    // Use GetBuffer and CommitBuffer to fill the chunk directly and avoid the copy in Update
+    unsigned char* GetBuffer(uint32_t *size);
+    void CommitBuffer(uint32_t size);
+
+    void Final();
+
+    size_t GetNumTypes() const { return mLanes.size(); }
+    ChecksumType GetType(size_t index) const;
+    bool HaveType(ChecksumType type) const;
+
+    const Checksum* GetChecksum(ChecksumType type) const;
+
+private:
+    typedef struct
+    {
+        Checksum checksum;
+        uint64_t processed_count;
+        std::thread thread;
+    } Lane;
+
+    typedef struct
+    {
+        unsigned char *data;
+        uint32_t size;
+    } Chunk;
+
+private:
+    void LaneThread(Lane *lane);
+    void AcquireFillChunk();
+    void SubmitFillChunk();
+    void StopLanes();
+
+private:
+    std::vector<Lane*> mLanes;
+    std::vector<Chunk> mChunks;
+    uint32_t mChunkSize;
+    bool mParallel;
+    bool mFinal;
+
+    Chunk *mFillChunk;
+    uint64_t mSubmitCount;
+
+    std::mutex mMutex;
+    std::condition_variable mSubmitCond;
+    std::condition_variable mProcessedCond;
+    bool mStop;
+};
+
+
+};
+
+
+
+#endif
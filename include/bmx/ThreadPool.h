@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_THREAD_POOL_H_
+#define BMX_THREAD_POOL_H_
+
+
+#include <vector>
+#include <functional>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <bmx/BMXTypes.h>
+
+
+
+namespace bmx
+{
+
+
+// Runs a batch of tasks using a fixed set of threads. The calling thread also runs tasks and so num_threads - 1
+// worker threads are created. Run must not be called concurrently
+class ThreadPool
+{
+public:
+    ThreadPool(uint32_t num_threads);
+    ~ThreadPool();
+
+    uint32_t GetNumThreads() const { return (uint32_t)mThreads.size() + 1; }
+
+    // calls task(index) for each index in [0, num_tasks) and returns once all have completed.
+    // The exception thrown by the task with the lowest index is re-thrown
+    void Run(size_t num_tasks, const std::function<void(size_t)> &task);
+
+private:
+    void WorkerThread();
+    void RunTasks(std::unique_lock<std::mutex> &lock);
+
+private:
+    std::vector<std::thread> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mTaskCond;
+    std::condition_variable mDoneCond;
+    const std::function<void(size_t)> *mTask;
+    size_t mNumTasks;
+    size_t mNextTask;
+    size_t mNumDone;
+    std::exception_ptr mException;
+    size_t mExceptionIndex;
+    bool mStop;
+};
+
+
+};
+
+
+
+#endif
@@ -100,6 +100,8 @@ bool check_ends_with_dir_separator(std::string name);
 
 int64_t get_file_size(const std::string &filename);
 int64_t get_file_size(FILE *file);
+// returns the modification time in nanoseconds since the epoch. The resolution depends on the platform and filesystem
+int64_t get_file_mod_time(const std::string &filename);
 
 std::string trim_string(std::string value);
 std::vector<std::string> split_string(std::string value, char separator, bool allow_empty);
@@ -35,6 +35,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <mutex>
 
 #include <bmx/mxf_helper/MXFFileFactory.h>
 #include <bmx/MXFChecksumFile.h>
@@ -63,10 +64,12 @@ public:
 
     void SetInputChecksumTypes(const std::set<ChecksumType> &types);
     void AddInputChecksumType(ChecksumType type);
+    void SetInputChecksumStream(bool enable);
     void SetInputFlags(int flags);
     void SetRWInterleave(uint32_t rw_interleave_size);
     void SetHTTPMinReadSize(uint32_t size);
-#if defined(_WIN32) && !defined(__MINGW32__)
+    void SetHTTPCache(uint32_t cache_blocks, uint32_t prefetch_count);
+#if !defined(__MINGW32__)
     void SetUseMMapFile(bool enable);
 #endif
 
@@ -89,6 +92,7 @@ public:
     std::string GetInputChecksumDigestString(size_t file_index, ChecksumType type) const;
 
 private:
+    MXFFile* OpenChecksumStreamFile(const std::string &filename);
     MXFChecksumFile* GetChecksumFile(size_t file_index, ChecksumType type) const;
 
 private:
@@ -101,11 +105,15 @@ private:
 
 private:
     std::set<ChecksumType> mInputChecksumTypes;
+    bool mInputChecksumStream;
     int mInputFlags;
     std::vector<InputChecksumFile> mInputChecksumFiles;
+    std::mutex mOpenReadMutex;
     MXFRWInterleaver *mRWInterleaver;
     uint32_t mHTTPMinReadSize;
-#if defined(_WIN32) && !defined(__MINGW32__)
+    uint32_t mHTTPCacheBlocks;
+    uint32_t mHTTPPrefetchCount;
+#if !defined(__MINGW32__)
     bool mUseMMapFile;
 #endif
 };
@@ -32,34 +32,17 @@
 #ifndef BMX_AVID_INDEX_TABLE_H_
 #define BMX_AVID_INDEX_TABLE_H_
 
-#include <deque>
-#include <set>
+#include <vector>
 
 #include <libMXF++/MXF.h>
 
-#include <bmx/ByteArray.h>
+#include <bmx/ChunkedByteArray.h>
 
 
 namespace bmx
 {
 
 
-class AvidIndexEntry
-{
-public:
-    AvidIndexEntry();
-    AvidIndexEntry(int8_t temporal_offset_, int8_t key_frame_offset_, uint8_t flags_,
-                   int64_t stream_offset_, bool can_start_partition_);
-
-public:
-    int64_t stream_offset;
-    int8_t temporal_offset;
-    int8_t key_frame_offset;
-    uint8_t flags;
-    bool can_start_partition;
-};
-
-
 class AvidIndexTable
 {
 public:
@@ -86,8 +69,9 @@ private:
     uint32_t mBodySID;
     mxfRational mEditRate;
 
-    std::deque<AvidIndexEntry> mIndexEntries;
-    std::set<uint32_t> require_updates;
+    ChunkedByteArray mIndexEntries;
+    std::vector<bool> mCanStartPartition;
+    std::vector<bool> mRequireUpdates;
 };
 
 
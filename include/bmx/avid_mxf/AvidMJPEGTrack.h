@@ -34,7 +34,7 @@
 
 #include <bmx/avid_mxf/AvidPictureTrack.h>
 #include <bmx/mxf_helper/MJPEGMXFDescriptorHelper.h>
-#include <bmx/ByteArray.h>
+#include <bmx/ChunkedByteArray.h>
 
 
 
@@ -61,7 +61,7 @@ protected:
 private:
     MJPEGMXFDescriptorHelper *mMJPEGDescriptorHelper;
 
-    ByteArray mIndexSegment;
+    ChunkedByteArray mIndexSegment;
 };
 
 
@@ -34,7 +34,7 @@
 
 #include <bmx/avid_mxf/AvidPictureTrack.h>
 #include <bmx/writer_helper/MPEG2LGWriterHelper.h>
-#include <bmx/ByteArray.h>
+#include <bmx/ChunkedByteArray.h>
 
 
 
@@ -61,7 +61,7 @@ protected:
 private:
     MPEG2LGWriterHelper mWriterHelper;
 
-    ByteArray mIndexSegment;
+    ChunkedByteArray mIndexSegment;
 };
 
 
@@ -50,6 +50,7 @@ public:
     virtual ~RawEssenceReader();
 
     void SetMaxReadLength(int64_t len);
+    void SetReadBlockSize(uint32_t size);
 
     void SetFixedSampleSize(uint32_t size);
 
@@ -63,7 +64,7 @@ public:
 public:
     virtual uint32_t ReadSamples(uint32_t num_samples);
 
-    virtual unsigned char* GetSampleData() const        { return mSampleBuffer.GetBytes(); }
+    virtual unsigned char* GetSampleData() const        { return mSampleBuffer.GetBytes() + mSampleDataOffset; }
     uint32_t GetSampleDataSize() const                  { return mSampleDataSize; }
     uint32_t GetNumSamples() const                      { return mNumSamples; }
     uint32_t GetSampleSize() const;
@@ -74,6 +75,10 @@ protected:
     bool ReadAndParseSample();
     uint32_t ReadBytes(uint32_t size);
     void ShiftSampleData(uint32_t to_offset, uint32_t from_offset);
+    void ConsumeSampleData();
+    void GrowSampleBuffer(uint32_t size);
+
+    uint32_t GetBufferedSize() const { return mSampleBuffer.GetSize() - mSampleDataOffset; }
 
     uint32_t AppendBytes(const unsigned char *bytes, uint32_t size);
 
@@ -82,12 +87,14 @@ protected:
 
     int64_t mMaxReadLength;
     int64_t mTotalReadLength;
+    uint32_t mReadBlockSize;
     uint32_t mMaxSampleSize;
 
     uint32_t mFixedSampleSize;
     EssenceParser *mEssenceParser;
 
     ByteArray mSampleBuffer;
+    uint32_t mSampleDataOffset;
     uint32_t mSampleDataSize;
     uint32_t mNumSamples;
     bool mReadFirstSample;
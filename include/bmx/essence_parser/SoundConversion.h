@@ -41,6 +41,21 @@ namespace bmx
 {
 
 
+typedef enum
+{
+    SCALAR_SOUND_CONVERSION_ISA,
+    SSE2_SOUND_CONVERSION_ISA,
+    AVX2_SOUND_CONVERSION_ISA,
+    NEON_SOUND_CONVERSION_ISA,
+} SoundConversionISA;
+
+// the default is the best instruction set supported by the build and the CPU
+// the scalar code is always supported and gives bit-exact equal results
+bool sound_conversion_isa_supported(SoundConversionISA isa);
+bool set_sound_conversion_isa(SoundConversionISA isa);
+SoundConversionISA get_sound_conversion_isa();
+
+
 uint8_t get_aes3_channel_valid_flags(const unsigned char *aes3_data, uint32_t aes3_data_size);
 uint16_t get_aes3_sample_count(const unsigned char *aes3_data, uint32_t aes3_data_size);
 
@@ -52,10 +67,22 @@ uint32_t convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t aes3_da
                                 uint32_t bits_per_sample, uint8_t channel_count,
                                 unsigned char *pcm_data, uint32_t pcm_data_size);
 
+// convert all channels in a single pass; pcm_data has channel_count buffers of pcm_data_size bytes each
+// and a null buffer skips the channel
+uint32_t convert_aes3_to_pcm_channels(const unsigned char *aes3_data, uint32_t aes3_data_size, bool ignore_valid_flags,
+                                      uint32_t bits_per_sample, uint8_t channel_count,
+                                      unsigned char * const *pcm_data, uint32_t pcm_data_size);
+
 void deinterleave_audio(const unsigned char *input_data, uint32_t input_data_size,
                         uint32_t bits_per_sample, uint16_t channel_count, uint16_t channel_num,
                         unsigned char *output_data, uint32_t output_data_size);
 
+// deinterleave all channels in a single pass; output_data has channel_count buffers of output_data_size bytes each
+// and a null buffer skips the channel
+void deinterleave_audio_channels(const unsigned char *input_data, uint32_t input_data_size,
+                                 uint32_t bits_per_sample, uint16_t channel_count,
+                                 unsigned char * const *output_data, uint32_t output_data_size);
+
 void interleave_audio(const unsigned char *input_data, uint32_t input_data_size,
                       uint32_t bits_per_sample, uint16_t channel_count, uint16_t channel_num,
                       unsigned char *output_data, uint32_t output_data_size);
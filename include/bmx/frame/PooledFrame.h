@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_POOLED_FRAME_H_
+#define BMX_POOLED_FRAME_H_
+
+
+#include <vector>
+#include <mutex>
+
+#include <bmx/frame/SharedBufferFrame.h>
+
+
+
+namespace bmx
+{
+
+
+typedef struct
+{
+    size_t max_free;        // maximum number of frames kept for re-use
+    size_t num_free;        // number of frames available for re-use
+    size_t num_in_use;      // number of frames currently in use
+    size_t max_in_use;      // maximum number of frames in use at the same time
+    uint64_t num_created;   // number of frames requiring a new allocation
+    uint64_t num_reused;    // number of frames re-using a released frame
+} FramePoolStats;
+
+
+class FramePool
+{
+public:
+    FramePool(size_t max_free);
+
+    void AddRef();
+    void Release();
+
+    ByteArray* AcquireBuffer();
+    void ReleaseBuffer(ByteArray *buffer);
+
+    void* AllocateFrame(size_t size);
+    static void FreeFrame(void *ptr);
+
+    FramePoolStats GetStats();
+
+private:
+    ~FramePool();
+
+    void ReleaseFrame(void *block);
+
+private:
+    std::mutex mMutex;
+    uint32_t mRefCount;
+    size_t mMaxFree;
+    std::vector<ByteArray*> mFreeBuffers;
+    std::vector<void*> mFreeFrames;
+    size_t mFrameAllocSize;
+    FramePoolStats mStats;
+};
+
+
+class PooledFrame : public SharedBufferFrame
+{
+public:
+    PooledFrame(FramePool *pool);
+    PooledFrame(const PooledFrame &from);
+    virtual ~PooledFrame();
+
+    virtual Frame* Clone();
+
+public:
+    static void* operator new(size_t size, FramePool *pool);
+    static void operator delete(void *ptr);
+    static void operator delete(void *ptr, FramePool *pool);
+
+private:
+    FramePool *mPool;
+};
+
+
+class PooledFrameFactory : public FrameFactory
+{
+public:
+    PooledFrameFactory(size_t max_free_frames);
+    virtual ~PooledFrameFactory();
+
+    virtual Frame* CreateFrame();
+
+    FramePoolStats GetStats() { return mPool->GetStats(); }
+
+private:
+    FramePool *mPool;
+};
+
+
+};
+
+
+
+#endif
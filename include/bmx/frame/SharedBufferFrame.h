@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_SHARED_BUFFER_FRAME_H_
+#define BMX_SHARED_BUFFER_FRAME_H_
+
+
+#include <atomic>
+
+#include <bmx/frame/Frame.h>
+
+
+
+namespace bmx
+{
+
+
+// the reference count is atomic so that frames can be released in a different thread to the reader
+class SharedBuffer
+{
+public:
+    SharedBuffer();
+
+    void AddRef();
+    void Release();
+
+    bool IsShared() const { return mRefCount > 1; }
+
+    ByteArray* GetData() { return &mData; }
+
+private:
+    ~SharedBuffer();
+
+private:
+    std::atomic<uint32_t> mRefCount;
+    ByteArray mData;
+};
+
+
+class SharedBufferFrame : public Frame
+{
+public:
+    SharedBufferFrame();
+    SharedBufferFrame(const SharedBufferFrame &from);
+    virtual ~SharedBufferFrame();
+
+    void SetSharedData(SharedBuffer *buffer, uint32_t offset, uint32_t size);
+    bool HaveSharedData() const { return mSharedBuffer != 0; }
+
+public:
+    virtual uint32_t GetSize() const;
+    virtual const unsigned char* GetBytes() const;
+
+    virtual void Grow(uint32_t min_size);
+    virtual uint32_t GetSizeAvailable() const;
+    virtual unsigned char* GetBytesAvailable() const;
+    virtual void SetSize(uint32_t size);
+    virtual void IncrementSize(uint32_t inc);
+
+    virtual Frame* Clone();
+
+protected:
+    SharedBufferFrame(ByteArray *data);
+    SharedBufferFrame(const SharedBufferFrame &from, ByteArray *data);
+
+private:
+    void CopySharedData();
+
+protected:
+    ByteArray *mData;
+
+private:
+    ByteArray mOwnedData;
+    SharedBuffer *mSharedBuffer;
+    uint32_t mSharedOffset;
+    uint32_t mSharedSize;
+};
+
+
+class SharedBufferFrameFactory : public FrameFactory
+{
+public:
+    virtual ~SharedBufferFrameFactory() {};
+
+    virtual Frame* CreateFrame();
+};
+
+
+};
+
+
+
+#endif
@@ -111,7 +111,7 @@ public:
 
     uint32_t GetWriteSize() const;
     uint32_t GetNumSamplesWritten() const { return mNumSamplesWritten; }
-    uint32_t Write();
+    uint32_t Write(ByteArray *write_buffer);
     void CompleteWrite();
 
     void Reset(int64_t new_position);
@@ -148,10 +148,13 @@ public:
 public:
     bool IsReady();
     void UpdateIndexTable();
-    uint32_t Write();
-    void WriteSystemItem();
+    uint32_t Write(ByteArray *write_buffer);
+    void WriteSystemItem(ByteArray *write_buffer);
     void CompleteWrite();
 
+private:
+    void InitSystemItemTemplate();
+
 private:
     mxfpp::File *mMXFFile;
     OP1AIndexTable *mIndexTable;
@@ -163,6 +166,7 @@ private:
     Rational mFrameRate;
     Timecode mStartTimecode;
     uint8_t mContentPackageRate;
+    ByteArray mSystemItemTemplate;
     std::vector<OP1AContentPackageElementData*> mElementData;
     std::map<uint32_t, OP1AContentPackageElementData*> mElementTrackIndexMap;
     int64_t mPosition;
@@ -232,6 +236,7 @@ private:
 
     std::deque<OP1AContentPackage*> mContentPackages;
     std::vector<OP1AContentPackage*> mFreeContentPackages;
+    ByteArray mWriteBuffer;
     int64_t mPosition;
 };
 
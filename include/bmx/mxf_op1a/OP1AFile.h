@@ -95,6 +95,7 @@ public:
     void SetRepeatIndexTable(bool enable);                              // default false. Repeat index table in Footer if true
     void ForceWriteCBEDuration0(bool enable);                           // force duration=0 for CBE index table
     void SetPrimaryPackage(bool enable);                                // default false
+    void SetWriteBehind(bool enable);                                   // default false. Write to file in a separate thread
 
 public:
     void SetOutputStartOffset(int64_t offset);
@@ -215,6 +216,8 @@ private:
     bool mSupportCompleteSinglePass;
     int64_t mFooterPartitionOffset;
 
+    bool mWriteBehind;
+
     MXFChecksumFile *mMXFChecksumFile;
     std::string mMD5DigestStr;
 
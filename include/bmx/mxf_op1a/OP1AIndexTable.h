@@ -36,6 +36,7 @@
 #include <set>
 
 #include <bmx/ByteArray.h>
+#include <bmx/ChunkedByteArray.h>
 
 
 
@@ -137,11 +138,11 @@ public:
     uint32_t GetDuration() const;
 
     mxfpp::IndexTableSegment* GetSegment() { return &mSegment; }
-    ByteArray* GetEntries() { return &mEntries; }
+    void WriteIndexEntries(mxfpp::File *mxf_file);
 
 private:
     mxfpp::IndexTableSegment mSegment;
-    ByteArray mEntries;
+    ChunkedByteArray mEntries;
     uint32_t mIndexEntrySize;
 };
 
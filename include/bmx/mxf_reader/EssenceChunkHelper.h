@@ -75,6 +75,10 @@ public:
 
     size_t GetNumIndexedPartitions() const { return mNumIndexedPartitions; }
 
+    // used to store and restore a complete essence chunk index in a MXFIndexCache
+    const std::vector<EssenceChunk>& GetEssenceChunks() const { return mEssenceChunks; }
+    void SetEssenceChunks(const std::vector<EssenceChunk> &chunks);
+
 public:
     bool IsComplete() const { return mIsComplete; }
 
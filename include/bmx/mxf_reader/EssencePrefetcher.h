@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_ESSENCE_PREFETCHER_H_
+#define BMX_ESSENCE_PREFETCHER_H_
+
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <libMXF++/MXF.h>
+
+#include <bmx/frame/SharedBufferFrame.h>
+
+
+
+namespace bmx
+{
+
+
+class EssencePrefetcher
+{
+public:
+    EssencePrefetcher(mxfpp::File *file, uint32_t max_requests);
+    ~EssencePrefetcher();
+
+    uint32_t GetMaxRequests() const { return mMaxRequests; }
+
+    bool IsFull();
+    bool IsNext(int64_t position);
+    int64_t GetLastPosition();
+
+    void Request(int64_t position, int64_t file_position, uint32_t size);
+    SharedBuffer* Take(int64_t position, int64_t *file_position, uint32_t *size);
+    void Recycle(SharedBuffer *buffer);
+
+    void Clear();
+
+private:
+    typedef enum
+    {
+        REQUEST_QUEUED,
+        REQUEST_READING,
+        REQUEST_DONE,
+        REQUEST_FAILED,
+    } RequestState;
+
+    typedef struct
+    {
+        int64_t position;
+        int64_t file_position;
+        uint32_t size;
+        SharedBuffer *buffer;
+        RequestState state;
+    } PrefetchRequest;
+
+private:
+    void ReadThread();
+    bool ReadRequest(PrefetchRequest *request, std::string *read_error);
+
+private:
+    mxfpp::File *mFile;
+    uint32_t mMaxRequests;
+
+    std::mutex mMutex;
+    std::condition_variable mRequestCond;
+    std::condition_variable mDoneCond;
+    std::deque<PrefetchRequest> mRequests;
+    std::vector<SharedBuffer*> mFreeBuffers;
+    std::string mReadError;
+    bool mStop;
+    std::thread mThread;
+};
+
+
+};
+
+
+
+#endif
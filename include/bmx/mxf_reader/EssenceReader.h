@@ -35,6 +35,7 @@
 
 #include <vector>
 #include <deque>
+#include <map>
 
 #include <bmx/frame/Frame.h>
 #include <bmx/mxf_reader/FrameMetadataReader.h>
@@ -48,6 +49,9 @@ namespace bmx
 
 
 class MXFFileReader;
+class MXFTrackReader;
+class SharedBuffer;
+class EssencePrefetcher;
 
 
 class EssenceReaderBuffer
@@ -94,10 +98,17 @@ public:
 
     void SetReadLimits(int64_t start_position, int64_t duration);
     void SetBufferFrames(bool enable);
+    void SetReadAhead(uint32_t num_content_packages);
+
+    // drop the read-ahead requests so that the file can be accessed from the caller's thread
+    void ClearPrefetch();
 
     uint32_t Read(uint32_t num_samples);
     void Seek(int64_t position);
 
+    // parse the content packages, partitions and index table segments appended to an incomplete file
+    void Refresh();
+
     mxfRational GetEditRate() const    { return mIndexTableHelper.GetEditRate(); };
     int64_t GetPosition() const        { return mPosition; }
     int64_t GetIndexedDuration() const { return mIndexTableHelper.GetDuration(); }
@@ -111,6 +122,15 @@ public:
 private:
     uint32_t ReadClipWrappedSamples(uint32_t num_samples);
     uint32_t ReadFrameWrappedSamples(uint32_t num_samples);
+    uint32_t ReadContentPackages(int64_t start_position, int64_t cp_file_position, uint32_t size,
+                                 uint32_t max_content_packages,
+                                 std::map<uint32_t, MXFTrackReader*> *enabled_track_readers);
+    bool ReadPrefetchedContentPackage(int64_t start_position,
+                                      std::map<uint32_t, MXFTrackReader*> *enabled_track_readers);
+    void ParseContentPackage(int64_t start_position, int64_t cp_file_position, uint32_t buffer_offset,
+                             uint32_t size, std::map<uint32_t, MXFTrackReader*> *enabled_track_readers);
+    Frame* GetElementFrame(const mxfKey *key, uint8_t llen, int64_t start_position, int64_t cp_file_position,
+                           int64_t element_offset, std::map<uint32_t, MXFTrackReader*> *enabled_track_readers);
 
     void GetEditUnit(int64_t position, mxfKey *element_key, int64_t *file_position, int64_t *size);
     void GetEditUnitGroup(int64_t position, uint32_t max_samples, mxfKey *element_key, int64_t *file_position,
@@ -118,6 +138,12 @@ private:
 
     uint32_t GetConstantEditUnitSize();
 
+    bool GetPrefetchEditUnit(int64_t position, int64_t *file_position, uint32_t *size);
+
+    void HintReadRanges();
+
+    void AdviseReadLimits();
+
 private:
     bool SeekEssence(int64_t base_position);
     bool ReadEssenceKL(bool first_element, mxfKey *key, uint8_t *llen, uint64_t *len);
@@ -158,6 +184,11 @@ private:
     uint32_t mImageEndOffset;
 
     EssenceReaderBuffer mReadFrameBuffer;
+    SharedBuffer *mContentPackage;
+    EssencePrefetcher *mPrefetcher;
+    bool mHintReadRanges;
+    int64_t mHintedStart;
+    int64_t mHintedEnd;
 
     int64_t mBasePosition;
     int64_t mFilePosition;
@@ -170,6 +201,7 @@ private:
     int64_t mLastKnownBasePosition;
     bool mHaveFooter;
     bool mBaseReadError;
+    int64_t mRefreshFileSize;
 };
 
 
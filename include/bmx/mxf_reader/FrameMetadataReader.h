@@ -34,6 +34,7 @@
 
 
 #include <bmx/mxf_reader/MXFFrameMetadata.h>
+#include <bmx/ByteArray.h>
 
 
 
@@ -55,7 +56,8 @@ public:
     virtual ~FrameMetadataChildReader() {}
 
     virtual void Reset() = 0;
-    virtual bool ProcessFrameMetadata(const mxfKey *key, uint64_t len) = 0;
+    virtual bool IsFrameMetadata(const mxfKey *key) = 0;
+    virtual bool ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len) = 0;
     virtual void InsertFrameMetadata(Frame *frame, uint32_t track_number) = 0;
 };
 
@@ -63,15 +65,15 @@ public:
 class SystemScheme1Reader : public FrameMetadataChildReader
 {
 public:
-    SystemScheme1Reader(mxfpp::File *file, Rational frame_rate, bool is_bbc_preservation_file);
+    SystemScheme1Reader(Rational frame_rate, bool is_bbc_preservation_file);
     virtual ~SystemScheme1Reader();
 
     virtual void Reset();
-    virtual bool ProcessFrameMetadata(const mxfKey *key, uint64_t len);
+    virtual bool IsFrameMetadata(const mxfKey *key);
+    virtual bool ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len);
     virtual void InsertFrameMetadata(Frame *frame, uint32_t track_number);
 
 private:
-    mxfpp::File *mFile;
     Rational mFrameRate;
     bool mIsBBCPreservationFile;
 
@@ -85,15 +87,15 @@ private:
 class SDTICPSystemMetadataReader : public FrameMetadataChildReader
 {
 public:
-    SDTICPSystemMetadataReader(mxfpp::File *file);
+    SDTICPSystemMetadataReader();
     virtual ~SDTICPSystemMetadataReader();
 
     virtual void Reset();
-    virtual bool ProcessFrameMetadata(const mxfKey *key, uint64_t len);
+    virtual bool IsFrameMetadata(const mxfKey *key);
+    virtual bool ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len);
     virtual void InsertFrameMetadata(Frame *frame, uint32_t track_number);
 
 private:
-    mxfpp::File *mFile;
     SDTICPSystemMetadata *mMetadata;
 };
 
@@ -101,15 +103,15 @@ private:
 class SDTICPPackageMetadataReader : public FrameMetadataChildReader
 {
 public:
-    SDTICPPackageMetadataReader(mxfpp::File *file);
+    SDTICPPackageMetadataReader();
     virtual ~SDTICPPackageMetadataReader();
 
     virtual void Reset();
-    virtual bool ProcessFrameMetadata(const mxfKey *key, uint64_t len);
+    virtual bool IsFrameMetadata(const mxfKey *key);
+    virtual bool ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len);
     virtual void InsertFrameMetadata(Frame *frame, uint32_t track_number);
 
 private:
-    mxfpp::File *mFile;
     SDTICPPackageMetadata *mMetadata;
 };
 
@@ -122,10 +124,13 @@ public:
 
     void Reset();
     bool ProcessFrameMetadata(const mxfKey *key, uint64_t len);
+    bool ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len);
     void InsertFrameMetadata(Frame *frame, uint32_t track_number);
 
 private:
+    mxfpp::File *mFile;
     std::vector<FrameMetadataChildReader*> mReaders;
+    ByteArray mValueBuffer;
 };
 
 
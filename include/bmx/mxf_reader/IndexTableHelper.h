@@ -33,6 +33,7 @@
 #define BMX_INDEX_TABLE_HELPER_H_
 
 #include <vector>
+#include <list>
 #include <memory>
 
 #include <libMXF++/MXF.h>
@@ -46,6 +47,8 @@ namespace bmx
 
 
 class MXFFileReader;
+class MXFIndexCacheWriter;
+class MXFIndexCacheReader;
 
 
 class IndexTableHelperSegment : public mxfpp::IndexTableSegment
@@ -57,6 +60,15 @@ public:
     void ReadIndexTableSegment(mxfpp::File *file, uint64_t segment_len);
     void ProcessIndexTableSegment(Rational expected_edit_rate);
 
+    // reads the segment properties but skips the index and delta entry arrays
+    void ReadIndexTableSegmentInfo(mxfpp::File *file, uint64_t segment_len, uint32_t *num_index_entries);
+
+    // the index entries of an unloaded segment are read from the segment at file_position when loaded
+    void SetUnloaded(int64_t file_position);
+    bool IsLoaded() const { return mIsLoaded; }
+    void Load(mxfpp::File *file);
+    void Unload();
+
     bool HaveExtraIndexEntries() const { return mHaveExtraIndexEntries; }
     int64_t GetIndexEndOffset() const  { return mIndexEndOffset; }
 
@@ -84,8 +96,28 @@ public:
 
     void CopyIndexEntries(const IndexTableHelperSegment *segment, uint32_t duration);
 
+    void AppendDeltaEntry(int8_t pos_table_index, uint8_t slice, uint32_t element_delta);
+
+    void WriteCache(MXFIndexCacheWriter *writer);
+    void ReadCache(MXFIndexCacheReader *reader);
+
+private:
+    typedef struct
+    {
+        int8_t pos_table_index;
+        uint8_t slice;
+        uint32_t element_delta;
+    } DeltaEntry;
+
+private:
+    void AllocIndexEntries(uint32_t num_entries);
+    void FreeIndexEntries();
+
 private:
-    unsigned char *mIndexEntries;
+    int64_t *mStreamOffsets;
+    int8_t *mTemporalOffsets;
+    int8_t *mKeyFrameOffsets;
+    uint8_t *mFlags;
     uint32_t mAllocIndexEntries;
     uint32_t mNumIndexEntries;
     uint32_t mEntriesStart;
@@ -97,6 +129,11 @@ private:
     int64_t mEssenceStartOffset;
 
     bool mIsFileIndexSegment;
+
+    bool mIsLoaded;
+    int64_t mFilePosition;
+
+    std::vector<DeltaEntry> mDeltaEntries;
 };
 
 
@@ -138,12 +175,26 @@ public:
 
     bool GetIndexEntry(MXFIndexEntryExt *entry, int64_t position);
 
+    bool RequireSegmentLoad(int64_t position) const;
+
+    // returns false if the index table can't be written because some segments are not loaded
+    bool WriteCache(MXFIndexCacheWriter *writer) const;
+    void ReadCache(MXFIndexCacheReader *reader);
+
 private:
     void InsertCBEIndexSegment(std::unique_ptr<IndexTableHelperSegment> &new_segment_up);
     void InsertVBEIndexSegment(std::unique_ptr<IndexTableHelperSegment> &new_segment_up);
 
     IndexTableHelperSegment* CreateStartSegment(IndexTableHelperSegment *segment, uint32_t duration);
 
+    bool ReadUnloadedIndexTableSegment(uint8_t llen, uint64_t len);
+    void LoadSegment(IndexTableHelperSegment *segment);
+    void LoadAllSegments();
+    void UpdateSegmentStarts();
+    size_t FindSegment(int64_t position) const;
+    int GetSegmentEditUnit(size_t index, int64_t position, int8_t *temporal_offset, int8_t *key_frame_offset,
+                           uint8_t *flags, int64_t *stream_offset);
+
 private:
     MXFFileReader *mFileReader;
     mxfpp::File *mFile;
@@ -151,6 +202,7 @@ private:
     bool mIsComplete;
 
     std::vector<IndexTableHelperSegment*> mSegments;
+    std::vector<int64_t> mSegmentStarts;
     size_t mLastEditUnitSegment;
 
     uint32_t mEditUnitSize;
@@ -159,6 +211,10 @@ private:
 
     Rational mEditRate;
     int64_t mDuration;
+
+    bool mLazyLoad;
+    uint32_t mMaxLoadedSegments;
+    std::list<IndexTableHelperSegment*> mLoadedSegments;
 };
 
 
@@ -43,8 +43,10 @@
 #include <bmx/mxf_reader/MXFReader.h>
 #include <bmx/mxf_reader/MXFFileTrackReader.h>
 #include <bmx/mxf_reader/EssenceReader.h>
+#include <bmx/mxf_reader/MXFIndexCache.h>
 #include <bmx/mxf_reader/MXFPackageResolver.h>
 #include <bmx/mxf_helper/MXFFileFactory.h>
+#include <bmx/FileWatcher.h>
 #include <bmx/URI.h>
 
 
@@ -65,6 +67,7 @@ public:
     friend class MXFTextObject;
     friend class FrameMetadataReader;
     friend class EssenceReaderBuffer;
+    friend class MXFIndexCache;
 
 public:
     typedef enum
@@ -97,6 +100,9 @@ public:
     void SetFileFactory(MXFFileFactory *factory, bool take_ownership);
     virtual void SetEmptyFrames(bool enable);
     void SetST436ManifestFrameCount(uint32_t count);     // default: 2 frames used to extract manifest
+    void SetReadAhead(uint32_t count);                   // default: 0 content packages read ahead in a thread
+    void SetLazyIndex(uint32_t max_loaded_segments);     // default: 0, i.e. all index segments are parsed in Open
+    void SetIndexCache(bool enable, const std::string &directory = "");  // default: disabled
     virtual void SetFileIndex(MXFFileIndex *file_index, bool take_ownership);
     virtual void SetMCALabelIndex(MXFMCALabelIndex *label_index, bool take_ownership);
 
@@ -104,6 +110,19 @@ public:
     OpenResult Open(mxfpp::File *file, std::string filename, int mode_flags=0);
     OpenResult Open(mxfpp::File *file, const URI &abs_uri, const URI &rel_uri, const std::string &filename, int mode_flags=0);
 
+    // open readers[i] with filenames[i] using num_threads threads. The files are opened by the readers' file
+    // factories in order on the calling thread and then the header metadata, index tables etc. are read in
+    // parallel. The file factories must support concurrent use if the files reference external essence files
+    static std::vector<OpenResult> OpenParallel(const std::vector<MXFFileReader*> &readers,
+                                                const std::vector<std::string> &filenames,
+                                                int mode_flags, uint32_t num_threads);
+
+    // parse the data appended to an incomplete (growing) file since the last read or refresh and update the
+    // duration and completeness. Returns true if the duration or completeness changed
+    bool Refresh();
+    // wait for the file to be modified. Returns true if the file was modified before the timeout expired
+    bool WaitForUpdate(uint32_t timeout_msec);
+
     mxfpp::DataModel* GetDataModel() const            { return mDataModel; }
     mxfpp::HeaderMetadata* GetHeaderMetadata() const  { return mHeaderMetadata; }
     MXFPackageResolver* GetPackageResolver() const    { return mPackageResolver; }
@@ -263,6 +282,12 @@ private:
 
     uint32_t mRequireFrameInfoCount;
     uint32_t mST436ManifestCount;
+    uint32_t mReadAheadCount;
+    uint32_t mLazyIndexSegments;
+    bool mIndexCacheEnabled;
+    std::string mIndexCacheDirectory;
+    MXFIndexCache *mIndexCache;
+    FileWatcher *mFileWatcher;
 
     std::set<mxfpp::SourcePackage*> mMCALabelIndexedPackages;
 };
@@ -42,6 +42,9 @@ namespace bmx
 {
 
 
+class ThreadPool;
+
+
 class MXFGroupReader : public MXFReader
 {
 public:
@@ -54,6 +57,10 @@ public:
     void AddReader(MXFReader *reader);
     bool Finalize();
 
+    // default: 1. Member readers are read in parallel using num_threads threads if > 1.
+    // The members must not share files or frame buffers
+    void SetReadThreads(uint32_t num_threads);
+
 public:
     virtual MXFFileReader* GetFileReader(size_t file_id);
     virtual std::vector<size_t> GetFileIds(bool internal_ess_only) const;
@@ -98,6 +105,8 @@ public:
     virtual void SetTemporaryFrameBuffer(bool enable);
 
 private:
+    uint32_t ReadMember(size_t i, int64_t current_position, uint32_t num_samples);
+
     void StartRead();
     void CompleteRead();
     void AbortRead();
@@ -116,6 +125,8 @@ private:
 
     std::vector<std::vector<uint32_t> > mSampleSequences;
     std::vector<int64_t> mSampleSequenceSizes;
+
+    ThreadPool *mReadThreadPool;
 };
 
 
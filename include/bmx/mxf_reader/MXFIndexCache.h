@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_MXF_INDEX_CACHE_H_
+#define BMX_MXF_INDEX_CACHE_H_
+
+
+#include <string>
+#include <vector>
+
+#include <bmx/BMXTypes.h>
+
+
+
+namespace bmx
+{
+
+
+class MXFFileReader;
+class IndexTableHelper;
+class EssenceChunkHelper;
+
+
+class MXFIndexCacheWriter
+{
+public:
+    MXFIndexCacheWriter();
+
+    void WriteUInt8(uint8_t value);
+    void WriteUInt32(uint32_t value);
+    void WriteInt32(int32_t value)   { WriteUInt32((uint32_t)value); }
+    void WriteUInt64(uint64_t value);
+    void WriteInt64(int64_t value)   { WriteUInt64((uint64_t)value); }
+    void WriteBool(bool value)       { WriteUInt8(value ? 1 : 0); }
+    void WriteRational(Rational value);
+    void WriteBytes(const void *data, size_t size);
+
+    const std::vector<unsigned char>& GetData() const { return mData; }
+
+private:
+    std::vector<unsigned char> mData;
+};
+
+
+class MXFIndexCacheReader
+{
+public:
+    MXFIndexCacheReader(const unsigned char *data, size_t size);
+
+    uint8_t ReadUInt8();
+    uint32_t ReadUInt32();
+    int32_t ReadInt32()   { return (int32_t)ReadUInt32(); }
+    uint64_t ReadUInt64();
+    int64_t ReadInt64()   { return (int64_t)ReadUInt64(); }
+    bool ReadBool()       { return ReadUInt8() != 0; }
+    Rational ReadRational();
+    void ReadBytes(void *data, size_t size);
+
+    // returns a count that is checked against the remaining data assuming each item is at least min_item_size bytes
+    uint32_t ReadCount(size_t min_item_size);
+
+    bool IsEnd() const { return mPos == mSize; }
+
+private:
+    const unsigned char *mData;
+    size_t mSize;
+    size_t mPos;
+};
+
+
+// A sidecar file that holds the index table and essence container layout extracted from a complete file.
+// The cache is keyed on the file size, modification time, partition layout, header partition pack and a check of
+// the file content and is ignored and rewritten if the key doesn't match the file being opened
+class MXFIndexCache
+{
+public:
+    MXFIndexCache(MXFFileReader *file_reader, const std::string &mxf_filename, const std::string &cache_filename);
+    ~MXFIndexCache();
+
+    const std::string& GetFilename() const { return mCacheFilename; }
+
+    bool Read(IndexTableHelper *index_table, EssenceChunkHelper *essence_chunks);
+    void Write(const IndexTableHelper *index_table, const EssenceChunkHelper *essence_chunks);
+
+private:
+    bool CreateKey();
+
+private:
+    MXFFileReader *mFileReader;
+    std::string mMXFFilename;
+    std::string mCacheFilename;
+    std::vector<unsigned char> mKey;
+};
+
+
+};
+
+
+
+#endif
@@ -90,6 +90,9 @@ public:
 
     virtual void SetFileFactory(MXFFileFactory *factory, bool take_ownership);
 
+    // default: 1. The external files referenced by a source clip's locators are opened in parallel if > 1
+    void SetOpenThreads(uint32_t num_threads);
+
     virtual void ExtractPackages(MXFFileReader *file_reader);
 
 public:
@@ -106,6 +109,7 @@ protected:
     std::vector<ResolvedPackage> mResolvedPackages;
     std::map<mxfUMID, mxfKey> mResolvedPackageTypeMap;
     std::vector<MXFFileReader*> mExternalReaders;
+    uint32_t mOpenThreads;
 };
 
 
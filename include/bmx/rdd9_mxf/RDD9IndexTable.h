@@ -35,6 +35,7 @@
 #include <vector>
 
 #include <bmx/ByteArray.h>
+#include <bmx/ChunkedByteArray.h>
 
 
 
@@ -128,11 +129,11 @@ public:
     uint32_t GetDuration() const;
 
     mxfpp::IndexTableSegment* GetSegment() { return &mSegment; }
-    ByteArray* GetEntries() { return &mEntries; }
+    void WriteIndexEntries(mxfpp::File *mxf_file);
 
 private:
     mxfpp::IndexTableSegment mSegment;
-    ByteArray mEntries;
+    ChunkedByteArray mEntries;
     uint32_t mIndexEntrySize;
 };
 
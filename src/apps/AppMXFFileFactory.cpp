@@ -39,6 +39,7 @@
 
 #include <bmx/apps/AppMXFFileFactory.h>
 #include <bmx/MXFHTTPFile.h>
+#include <bmx/MXFMMapFile.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -51,10 +52,13 @@ using namespace mxfpp;
 
 AppMXFFileFactory::AppMXFFileFactory()
 {
+    mInputChecksumStream = false;
     mInputFlags = 0;
     mRWInterleaver = 0;
     mHTTPMinReadSize = 64 * 1024;
-#if defined(_WIN32) && !defined(__MINGW32__)
+    mHTTPCacheBlocks = 64;
+    mHTTPPrefetchCount = 0;
+#if !defined(__MINGW32__)
     mUseMMapFile = false;
 #endif
 }
@@ -75,6 +79,11 @@ void AppMXFFileFactory::AddInputChecksumType(ChecksumType type)
     mInputChecksumTypes.insert(type);
 }
 
+void AppMXFFileFactory::SetInputChecksumStream(bool enable)
+{
+    mInputChecksumStream = enable;
+}
+
 void AppMXFFileFactory::SetInputFlags(int flags)
 {
     mInputFlags = flags;
@@ -98,7 +107,13 @@ void AppMXFFileFactory::SetHTTPMinReadSize(uint32_t size)
     mHTTPMinReadSize = size;
 }
 
-#if defined(_WIN32) && !defined(__MINGW32__)
+void AppMXFFileFactory::SetHTTPCache(uint32_t cache_blocks, uint32_t prefetch_count)
+{
+    mHTTPCacheBlocks = cache_blocks;
+    mHTTPPrefetchCount = prefetch_count;
+}
+
+#if !defined(__MINGW32__)
 void AppMXFFileFactory::SetUseMMapFile(bool enable)
 {
     mUseMMapFile = enable;
@@ -142,6 +157,9 @@ File* AppMXFFileFactory::OpenNew(string filename)
 
 File* AppMXFFileFactory::OpenRead(string filename)
 {
+    // external essence files can be opened by readers that are being opened in parallel
+    lock_guard<mutex> lock(mOpenReadMutex);
+
     MXFFile *mxf_file = 0;
 
     try
@@ -152,7 +170,7 @@ File* AppMXFFileFactory::OpenRead(string filename)
             uri_str = "stdin:";
         } else {
             if (mxf_http_is_url(filename)) {
-                mxf_file = mxf_http_file_open_read(filename, mHTTPMinReadSize);
+                mxf_file = mxf_http_file_open_read(filename, mHTTPMinReadSize, mHTTPCacheBlocks, mHTTPPrefetchCount);
                 uri_str = filename;
             } else {
 #if defined(_WIN32)
@@ -163,7 +181,10 @@ File* AppMXFFileFactory::OpenRead(string filename)
 #endif
                     BMX_CHECK(mxf_win32_file_open_read(filename.c_str(), mInputFlags, &mxf_file));
 #else
-                BMX_CHECK(mxf_disk_file_open_read(filename.c_str(), &mxf_file));
+                if (mUseMMapFile)
+                    mxf_file = mxf_mmap_file_open_read(filename);
+                else
+                    BMX_CHECK(mxf_disk_file_open_read(filename.c_str(), &mxf_file));
 #endif
             }
         }
@@ -185,12 +206,18 @@ File* AppMXFFileFactory::OpenRead(string filename)
             input_checksum_file.filename = filename;
             input_checksum_file.abs_uri = abs_uri;
 
-            set<ChecksumType>::const_iterator types_iter;
-            for (types_iter = mInputChecksumTypes.begin(); types_iter != mInputChecksumTypes.end(); types_iter++) {
-                MXFChecksumFile *checksum_file = mxf_checksum_file_open(mxf_file, *types_iter);
-                input_checksum_file.checksum_files.push_back(make_pair(*types_iter, checksum_file));
-                mxf_file = mxf_checksum_file_get_file(checksum_file);
-            }
+            // a single checksum file calculates all the types in parallel
+            vector<ChecksumType> types(mInputChecksumTypes.begin(), mInputChecksumTypes.end());
+            MXFChecksumFile *checksum_file;
+            if (mInputChecksumStream && uri_str.empty())
+                checksum_file = mxf_checksum_file_open_stream(mxf_file, types, OpenChecksumStreamFile(filename));
+            else
+                checksum_file = mxf_checksum_file_open(mxf_file, types);
+            mxf_file = mxf_checksum_file_get_file(checksum_file);
+
+            size_t i;
+            for (i = 0; i < types.size(); i++)
+                input_checksum_file.checksum_files.push_back(make_pair(types[i], checksum_file));
 
             mInputChecksumFiles.push_back(input_checksum_file);
         }
@@ -286,18 +313,29 @@ vector<ChecksumType> AppMXFFileFactory::GetInputChecksumTypes(size_t file_index)
 
 size_t AppMXFFileFactory::GetInputChecksumDigestSize(size_t file_index, ChecksumType type) const
 {
-    return mxf_checksum_file_digest_size(GetChecksumFile(file_index, type));
+    return mxf_checksum_file_digest_size(GetChecksumFile(file_index, type), type);
 }
 
 void AppMXFFileFactory::GetInputChecksumDigest(size_t file_index, ChecksumType type, unsigned char *digest,
                                                size_t size) const
 {
-    return mxf_checksum_file_digest(GetChecksumFile(file_index, type), digest, size);
+    return mxf_checksum_file_digest(GetChecksumFile(file_index, type), type, digest, size);
 }
 
 string AppMXFFileFactory::GetInputChecksumDigestString(size_t file_index, ChecksumType type) const
 {
-    return mxf_checksum_file_digest_str(GetChecksumFile(file_index, type));
+    return mxf_checksum_file_digest_str(GetChecksumFile(file_index, type), type);
+}
+
+MXFFile* AppMXFFileFactory::OpenChecksumStreamFile(const string &filename)
+{
+    MXFFile *mxf_file = 0;
+#if defined(_WIN32)
+    BMX_CHECK(mxf_win32_file_open_read(filename.c_str(), MXF_WIN32_FLAG_SEQUENTIAL_SCAN, &mxf_file));
+#else
+    BMX_CHECK(mxf_disk_file_open_read(filename.c_str(), &mxf_file));
+#endif
+    return mxf_file;
 }
 
 MXFChecksumFile* AppMXFFileFactory::GetChecksumFile(size_t file_index, ChecksumType type) const
@@ -50,35 +50,25 @@ using namespace mxfpp;
 // MAX_INDEX_SEGMENT_SIZE <= 65535 [2-byte max len]
 #define MAX_INDEX_SEGMENT_SIZE      0xffff
 #define INDEX_ENTRY_SIZE            11
+#define INDEX_ENTRIES_CHUNK_SIZE    4096
 
 
 
-AvidIndexEntry::AvidIndexEntry()
-    : stream_offset(0)
-    , temporal_offset(0)
-    , key_frame_offset(0)
-    , flags(0)
-    , can_start_partition(true)
+static void set_entry_offsets(unsigned char *entry_bytes, int8_t temporal_offset, int8_t key_frame_offset,
+                              uint8_t flags)
 {
-
+    mxf_set_int8(temporal_offset * 2,  &entry_bytes[0]);    // temporal offset
+    mxf_set_int8(key_frame_offset * 2, &entry_bytes[1]);    // key frame offset
+    mxf_set_uint8(flags & 0x80,        &entry_bytes[2]);    // flags
 }
 
-AvidIndexEntry::AvidIndexEntry(int8_t temporal_offset_, int8_t key_frame_offset_,
-        uint8_t flags_, int64_t stream_offset_, bool can_start_partition_)
-    : stream_offset(stream_offset_)
-    , temporal_offset(temporal_offset_)
-    , key_frame_offset(key_frame_offset_)
-    , flags(flags_)
-    , can_start_partition(can_start_partition_)
-{
-
-}
 
 
 AvidIndexTable::AvidIndexTable(uint32_t index_sid, uint32_t body_sid, mxfRational edit_rate)
     : mIndexSID(index_sid)
     , mBodySID(body_sid)
     , mEditRate(edit_rate)
+    , mIndexEntries(INDEX_ENTRY_SIZE, INDEX_ENTRIES_CHUNK_SIZE)
 {
 
 }
@@ -96,14 +86,22 @@ void AvidIndexTable::AddIndexEntry(int64_t position, int8_t temporal_offset,
 {
     uint32_t index_pos = (uint32_t)position;
 
-    BMX_ASSERT(index_pos >= mIndexEntries.size());
+    BMX_ASSERT(index_pos >= mIndexEntries.GetNumRecords());
+
+    // entries skipped over are null entries
+    while (index_pos > mIndexEntries.GetNumRecords()) {
+        mIndexEntries.AppendRecord();
+        mCanStartPartition.push_back(true);
+        mRequireUpdates.push_back(false);
+    }
 
-    if (index_pos >= mIndexEntries.size())
-        mIndexEntries.resize(index_pos + 1);
-    mIndexEntries[index_pos] = AvidIndexEntry(temporal_offset, key_frame_offset,
-            flags, stream_offset, can_start_partition);
-    if (require_update)
-        require_updates.insert(index_pos);
+    // the entries are stored in the serialized form
+    unsigned char *entry_bytes = mIndexEntries.AppendRecord();
+    set_entry_offsets(entry_bytes, temporal_offset, key_frame_offset, flags);
+    mxf_set_int64(stream_offset, &entry_bytes[3]);                  // stream offset
+
+    mCanStartPartition.push_back(can_start_partition);
+    mRequireUpdates.push_back(require_update);
 }
 
 void AvidIndexTable::UpdateIndexEntry(int64_t position, int8_t temporal_offset,
@@ -113,13 +111,11 @@ void AvidIndexTable::UpdateIndexEntry(int64_t position, int8_t temporal_offset,
     uint32_t index_pos = (uint32_t)position;
 
     // must update an already existing entry
-    BMX_ASSERT(index_pos < mIndexEntries.size());
+    BMX_ASSERT(index_pos < mIndexEntries.GetNumRecords());
 
-    mIndexEntries[index_pos].temporal_offset = temporal_offset;
-    mIndexEntries[index_pos].key_frame_offset = key_frame_offset;
-    mIndexEntries[index_pos].flags = flags;
+    set_entry_offsets(mIndexEntries.GetRecord(index_pos), temporal_offset, key_frame_offset, flags);
 
-    require_updates.erase(index_pos);
+    mRequireUpdates[index_pos] = false;
 }
 
 
@@ -130,14 +126,14 @@ void AvidIndexTable::WriteVBEIndexTable(mxfpp::File *mxf_file, mxfpp::Partition
     // separate index table into segments of (MAX_INDEX_SEGMENT_SIZE / INDEX_ENTRY_SIZE) entries;
     // each entry _should_ start with an I-frame (can_start_partition == true)
     uint32_t begin = 0;
-    uint32_t end = (uint32_t)mIndexEntries.size();
+    uint32_t end = (uint32_t)mIndexEntries.GetNumRecords();
 
     while (begin != end) {
         uint32_t seg_end = min(begin + MAX_INDEX_SEGMENT_SIZE / INDEX_ENTRY_SIZE, end);
 
         if (seg_end != end) {
             for (uint32_t pos = seg_end; pos > begin; pos--) {
-                 if (mIndexEntries[pos].can_start_partition) {
+                 if (mCanStartPartition[pos]) {
                      seg_end = pos;
                      break;
                  }
@@ -176,21 +172,14 @@ void AvidIndexTable::WriteIndexSegmentHeader(mxfpp::File *mxf_file, uint32_t beg
 void AvidIndexTable::WriteIndexSegmentArray(mxfpp::File *mxf_file, uint32_t begin, uint32_t end)
 {
     BMX_ASSERT(begin < end);
-    BMX_ASSERT(end <= mIndexEntries.size());
-
-    const uint32_t size = end - begin;
-    ByteArray index_segment(size * INDEX_ENTRY_SIZE);
-    index_segment.SetSize(size * INDEX_ENTRY_SIZE);
-
-    for (uint32_t pos = 0; pos != size; pos++) {
-        AvidIndexEntry const& entry = mIndexEntries[pos + begin];
-        unsigned char* bytes = index_segment.GetBytes() + pos * INDEX_ENTRY_SIZE;
-
-        mxf_set_int8(entry.temporal_offset * 2,  bytes + 0);    // temporal offset
-        mxf_set_int8(entry.key_frame_offset * 2, bytes + 1);    // key frame offset
-        mxf_set_uint8(entry.flags & 0x80,        bytes + 2);    // flags
-        mxf_set_int64(entry.stream_offset,       bytes + 3);    // stream offset
+    BMX_ASSERT(end <= mIndexEntries.GetNumRecords());
+
+    // write the serialized entries directly from the chunks
+    size_t pos = begin;
+    while (pos < end) {
+        const unsigned char *bytes;
+        size_t count = mIndexEntries.GetContiguousRecords(pos, end, &bytes);
+        mxf_file->write(bytes, (uint32_t)(count * INDEX_ENTRY_SIZE));
+        pos += count;
     }
-
-    mxf_file->write(index_segment.GetBytes(), index_segment.GetSize());
 }
@@ -47,21 +47,19 @@ using namespace mxfpp;
 
 
 #define INDEX_ENTRY_SIZE            11
-#define INDEX_ENTRIES_INCREMENT     250
+#define INDEX_ENTRIES_CHUNK_SIZE    4096
 #define NULL_TEMPORAL_OFFSET        127
 
 
 
 AvidMJPEGTrack::AvidMJPEGTrack(AvidClip *clip, uint32_t track_index, EssenceType essence_type, File *file)
-: AvidPictureTrack(clip, track_index, essence_type, file)
+: AvidPictureTrack(clip, track_index, essence_type, file), mIndexSegment(INDEX_ENTRY_SIZE, INDEX_ENTRIES_CHUNK_SIZE)
 {
     mMJPEGDescriptorHelper = dynamic_cast<MJPEGMXFDescriptorHelper*>(mDescriptorHelper);
     BMX_ASSERT(mMJPEGDescriptorHelper);
 
     mTrackNumber = MXF_AVID_MJPEG_PICT_TRACK_NUM;
     mEssenceElementKey = MXF_EE_K(AvidMJPEGClipWrapped);
-
-    mIndexSegment.SetAllocBlockSize(INDEX_ENTRIES_INCREMENT * INDEX_ENTRY_SIZE);
 }
 
 AvidMJPEGTrack::~AvidMJPEGTrack()
@@ -86,7 +84,7 @@ void AvidMJPEGTrack::WriteSamples(const unsigned char *data, uint32_t size, uint
     mxf_set_int8(0, &entry[1]);
     mxf_set_uint8(0x80, &entry[2]); // key frame
     mxf_set_int64(mContainerSize, &entry[3]);
-    mIndexSegment.Append(entry, sizeof(entry));
+    mIndexSegment.AppendRecord(entry);
 
     mContainerDuration++;
     mContainerSize += size;
@@ -102,7 +100,7 @@ void AvidMJPEGTrack::WriteVBEIndexTable(Partition *partition)
     segment.setBodySID(mBodySID);
     segment.setEditUnitByteCount(0);
 
-    uint32_t num_index_entries = mIndexSegment.GetSize() / INDEX_ENTRY_SIZE;
+    uint32_t num_index_entries = (uint32_t)mIndexSegment.GetNumRecords();
     BMX_ASSERT(num_index_entries >= 1);
     int64_t index_duration = num_index_entries - 1;
 
@@ -115,7 +113,14 @@ void AvidMJPEGTrack::WriteVBEIndexTable(Partition *partition)
     segment.writeHeader(mMXFFile, 0, num_index_entries);
     // Avid ignores the 16-bit llen and uses the number of index entries (uint32) instead
     segment.writeAvidIndexEntryArrayHeader(mMXFFile, 0, 0, num_index_entries);
-    mMXFFile->write(mIndexSegment.GetBytes(), mIndexSegment.GetSize());
+    size_t num_index_records = mIndexSegment.GetNumRecords();
+    size_t index = 0;
+    while (index < num_index_records) {
+        const unsigned char *bytes;
+        size_t count = mIndexSegment.GetContiguousRecords(index, num_index_records, &bytes);
+        mMXFFile->write(bytes, (uint32_t)(count * INDEX_ENTRY_SIZE));
+        index += count;
+    }
 
     partition->fillToKag(mMXFFile);
     partition->markIndexEnd(mMXFFile);
@@ -129,7 +134,7 @@ void AvidMJPEGTrack::PostSampleWriting(mxfpp::Partition *partition)
     mxf_set_int8(0, &entry[1]);
     mxf_set_uint8(0x80, &entry[2]);
     mxf_set_int64(mContainerSize, &entry[3]);
-    mIndexSegment.Append(entry, sizeof(entry));
+    mIndexSegment.AppendRecord(entry);
 
     AvidPictureTrack::PostSampleWriting(partition);
 }
@@ -45,20 +45,18 @@ using namespace mxfpp;
 
 
 #define INDEX_ENTRY_SIZE            11
-#define INDEX_ENTRIES_INCREMENT     250
+#define INDEX_ENTRIES_CHUNK_SIZE    4096
 #define NULL_TEMPORAL_OFFSET        127
 
 
 
 AvidMPEG2LGTrack::AvidMPEG2LGTrack(AvidClip *clip, uint32_t track_index, EssenceType essence_type, File *file)
-: AvidPictureTrack(clip, track_index, essence_type, file)
+: AvidPictureTrack(clip, track_index, essence_type, file), mIndexSegment(INDEX_ENTRY_SIZE, INDEX_ENTRIES_CHUNK_SIZE)
 {
     mWriterHelper.SetFlavour(MPEG2LGWriterHelper::AVID_FLAVOUR);
 
     mTrackNumber = MXF_AVID_MPEG_PICT_TRACK_NUM;
     mEssenceElementKey = MXF_EE_K(AvidMPEGClipWrapped);
-
-    mIndexSegment.SetAllocBlockSize(INDEX_ENTRIES_INCREMENT * INDEX_ENTRY_SIZE);
 }
 
 AvidMPEG2LGTrack::~AvidMPEG2LGTrack()
@@ -78,12 +76,11 @@ void AvidMPEG2LGTrack::WriteSamples(const unsigned char *data, uint32_t size, ui
 
     if (mWriterHelper.HavePrevTemporalOffset()) {
         // mIndexSegments only hold whole GOPs and so the earlier entry should be in the current segment
-        BMX_CHECK((size_t)(mWriterHelper.GetPrevTemporalOffset() * INDEX_ENTRY_SIZE) <= mIndexSegment.GetSize());
+        BMX_CHECK((size_t)(2 * mWriterHelper.GetPrevTemporalOffset()) <= mIndexSegment.GetNumRecords());
 
-        uint32_t segment_offset = mIndexSegment.GetSize();
-        segment_offset -= 2 * mWriterHelper.GetPrevTemporalOffset() * INDEX_ENTRY_SIZE;
-        mxf_set_int8(mWriterHelper.GetPrevTemporalOffset() * 2, &mIndexSegment.GetBytes()[segment_offset]);
-        mxf_set_int8(mWriterHelper.GetPrevTemporalOffset() * 2, &mIndexSegment.GetBytes()[segment_offset] + INDEX_ENTRY_SIZE);
+        size_t segment_index = mIndexSegment.GetNumRecords() - 2 * mWriterHelper.GetPrevTemporalOffset();
+        mxf_set_int8(mWriterHelper.GetPrevTemporalOffset() * 2, mIndexSegment.GetRecord(segment_index));
+        mxf_set_int8(mWriterHelper.GetPrevTemporalOffset() * 2, mIndexSegment.GetRecord(segment_index + 1));
     }
 
 
@@ -102,8 +99,8 @@ void AvidMPEG2LGTrack::WriteSamples(const unsigned char *data, uint32_t size, ui
     mxf_set_uint8(mWriterHelper.GetFlags() & 0xf0,      &entry[2]);  // flags
     mxf_set_int64(mContainerSize,                       &entry[3]);  // stream offset
 
-    mIndexSegment.Append(entry, sizeof(entry));
-    mIndexSegment.Append(entry, sizeof(entry));
+    mIndexSegment.AppendRecord(entry);
+    mIndexSegment.AppendRecord(entry);
 
 
     mContainerDuration++;
@@ -120,7 +117,7 @@ void AvidMPEG2LGTrack::WriteVBEIndexTable(Partition *partition)
     segment.setBodySID(mBodySID);
     segment.setEditUnitByteCount(0);
 
-    uint32_t num_index_entries = mIndexSegment.GetSize() / INDEX_ENTRY_SIZE;
+    uint32_t num_index_entries = (uint32_t)mIndexSegment.GetNumRecords();
     BMX_ASSERT(num_index_entries >= 1);
     int64_t index_duration = (num_index_entries - 1) / 2;
 
@@ -133,7 +130,14 @@ void AvidMPEG2LGTrack::WriteVBEIndexTable(Partition *partition)
     segment.writeHeader(mMXFFile, 0, num_index_entries);
     // Avid ignores the 16-bit llen and uses the number of index entries (uint32) instead
     segment.writeAvidIndexEntryArrayHeader(mMXFFile, 0, 0, num_index_entries);
-    mMXFFile->write(mIndexSegment.GetBytes(), mIndexSegment.GetSize());
+    size_t num_index_records = mIndexSegment.GetNumRecords();
+    size_t index = 0;
+    while (index < num_index_records) {
+        const unsigned char *bytes;
+        size_t count = mIndexSegment.GetContiguousRecords(index, num_index_records, &bytes);
+        mMXFFile->write(bytes, (uint32_t)(count * INDEX_ENTRY_SIZE));
+        index += count;
+    }
 
     partition->fillToKag(mMXFFile);
     partition->markIndexEnd(mMXFFile);
@@ -150,7 +154,7 @@ void AvidMPEG2LGTrack::PostSampleWriting(mxfpp::Partition *partition)
     mxf_set_int8(0,                 &entry[1]);
     mxf_set_uint8(0xc0,             &entry[2]);
     mxf_set_int64(mContainerSize,   &entry[3]);
-    mIndexSegment.Append(entry, sizeof(entry));
+    mIndexSegment.AppendRecord(entry);
 
 
     // Note: no need to update the file descriptor with MPEG info extracted from the essence data because
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BMX_X86_CPU
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+#if (defined(__aarch64__) || defined(__arm__)) && defined(__linux__)
+#define BMX_LINUX_ARM_CPU
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#include <bmx/CPUFeatures.h>
+
+using namespace bmx;
+
+
+
+typedef struct
+{
+    bool sse2;
+    bool ssse3;
+    bool sse41;
+    bool pclmul;
+    bool avx2;
+    bool sha;
+    bool neon;
+    bool arm_crc32;
+} CPUFeatures;
+
+
+#if defined(BMX_X86_CPU)
+
+static void get_cpuid(unsigned int leaf, unsigned int sub_leaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+    int int_regs[4];
+    __cpuidex(int_regs, (int)leaf, (int)sub_leaf);
+    regs[0] = (unsigned int)int_regs[0];
+    regs[1] = (unsigned int)int_regs[1];
+    regs[2] = (unsigned int)int_regs[2];
+    regs[3] = (unsigned int)int_regs[3];
+#else
+    if (!__get_cpuid_count(leaf, sub_leaf, &regs[0], &regs[1], &regs[2], &regs[3]))
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+}
+
+static unsigned long long get_xcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+#endif
+
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+    features.sse2 = false;
+    features.ssse3 = false;
+    features.sse41 = false;
+    features.pclmul = false;
+    features.avx2 = false;
+    features.sha = false;
+    features.neon = false;
+    features.arm_crc32 = false;
+
+#if defined(BMX_X86_CPU)
+    unsigned int regs[4];
+    get_cpuid(0, 0, regs);
+    unsigned int max_leaf = regs[0];
+    if (max_leaf >= 1) {
+        get_cpuid(1, 0, regs);
+        features.sse2   = ((regs[3] & (1 << 26)) != 0);
+        features.ssse3  = ((regs[2] & (1 << 9)) != 0);
+        features.sse41  = ((regs[2] & (1 << 19)) != 0);
+        features.pclmul = ((regs[2] & (1 << 1)) != 0);
+
+        // AVX registers require OS support, indicated by OSXSAVE and the XMM and YMM state bits in XCR0
+        bool os_avx = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (get_xcr0() & 0x6) == 0x6;
+        if (max_leaf >= 7) {
+            get_cpuid(7, 0, regs);
+            features.avx2 = os_avx && ((regs[1] & (1 << 5)) != 0);
+            features.sha  = ((regs[1] & (1 << 29)) != 0);
+        }
+    }
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+    features.neon = true;
+#if defined(BMX_LINUX_ARM_CPU) && defined(__aarch64__)
+    features.arm_crc32 = ((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0);
+#elif defined(__APPLE__) || defined(__ARM_FEATURE_CRC32)
+    features.arm_crc32 = true;
+#endif
+#endif
+
+    return features;
+}
+
+
+bool bmx::cpu_has_feature(CPUFeature feature)
+{
+    static const CPUFeatures features = detect_cpu_features();
+
+    switch (feature)
+    {
+        case CPU_FEATURE_SSE2:
+            return features.sse2;
+        case CPU_FEATURE_SSSE3:
+            return features.ssse3;
+        case CPU_FEATURE_SSE41:
+            return features.sse41;
+        case CPU_FEATURE_PCLMUL:
+            return features.pclmul;
+        case CPU_FEATURE_AVX2:
+            return features.avx2;
+        case CPU_FEATURE_SHA:
+            return features.sha;
+        case CPU_FEATURE_NEON:
+            return features.neon;
+        case CPU_FEATURE_ARM_CRC32:
+            return features.arm_crc32;
+    }
+
+    return false;
+}
@@ -37,7 +37,30 @@
 #include <cstring>
 #include <cerrno>
 
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && \
+        (defined(_MSC_VER) || defined(__clang__) || \
+            (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define BMX_PCLMUL_CRC32
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#define BMX_TARGET_PCLMUL
+#else
+#define BMX_TARGET_PCLMUL   __attribute__((target("pclmul")))
+#endif
+#endif
+#if defined(__aarch64__) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 6))
+#define BMX_ARM_CRC32
+#include <arm_acle.h>
+#if defined(__clang__)
+#define BMX_TARGET_ARM_CRC32    __attribute__((target("crc")))
+#else
+#define BMX_TARGET_ARM_CRC32    __attribute__((target("+crc")))
+#endif
+#endif
+
 #include <bmx/CRC32.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -118,11 +141,185 @@ void bmx::crc32_init(uint32_t *crc32)
     *crc32 = 0xffffffffL;
 }
 
-void bmx::crc32_update(uint32_t *crc32, const unsigned char *data, size_t size)
+
+// Slice-by-16 tables; table[0] is CRC32_TABLE and table[k] advances table[k - 1] by a zero byte
+
+class CRC32SliceTables
+{
+public:
+    CRC32SliceTables()
+    {
+        int k, n;
+        for (n = 0; n < 256; n++)
+            table[0][n] = CRC32_TABLE[n];
+        for (k = 1; k < 16; k++) {
+            for (n = 0; n < 256; n++)
+                table[k][n] = (table[k - 1][n] >> 8) ^ CRC32_TABLE[table[k - 1][n] & 0xff];
+        }
+    }
+
+    uint32_t table[16][256];
+};
+
+
+static uint32_t table_crc32_update(uint32_t crc32, const unsigned char *data, size_t size)
 {
+#ifndef WORDS_BIGENDIAN
+    static const CRC32SliceTables slice_tables;
+    const uint32_t (*table)[256] = slice_tables.table;
+
+    while (size >= 16) {
+        uint32_t words[4];
+        memcpy(words, data, sizeof(words));
+        words[0] ^= crc32;
+        crc32 = table[15][ words[0]        & 0xff] ^ table[14][(words[0] >>  8) & 0xff] ^
+                table[13][(words[0] >> 16) & 0xff] ^ table[12][ words[0] >> 24        ] ^
+                table[11][ words[1]        & 0xff] ^ table[10][(words[1] >>  8) & 0xff] ^
+                table[ 9][(words[1] >> 16) & 0xff] ^ table[ 8][ words[1] >> 24        ] ^
+                table[ 7][ words[2]        & 0xff] ^ table[ 6][(words[2] >>  8) & 0xff] ^
+                table[ 5][(words[2] >> 16) & 0xff] ^ table[ 4][ words[2] >> 24        ] ^
+                table[ 3][ words[3]        & 0xff] ^ table[ 2][(words[3] >>  8) & 0xff] ^
+                table[ 1][(words[3] >> 16) & 0xff] ^ table[ 0][ words[3] >> 24        ];
+        data += 16;
+        size -= 16;
+    }
+#endif
+
     size_t i;
     for (i = 0; i < size; i++)
-        *crc32 = CRC32_TABLE[((*crc32) ^ data[i]) & 0xff] ^ ((*crc32) >> 8);
+        crc32 = CRC32_TABLE[(crc32 ^ data[i]) & 0xff] ^ (crc32 >> 8);
+
+    return crc32;
+}
+
+
+#if defined(BMX_PCLMUL_CRC32)
+
+// Folds 64 bytes at a time using carry-less multiplication, followed by a Barrett reduction. See the Intel paper
+// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction". The constants are for the
+// bit-reflected 0x04c11db7 polynomial. size must be a multiple of 16 and at least 64.
+
+BMX_TARGET_PCLMUL
+static uint32_t pclmul_crc32_update(uint32_t crc32, const unsigned char *data, size_t size)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0,              0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i low_mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i*)(data + 0x00));
+    x2 = _mm_loadu_si128((const __m128i*)(data + 0x10));
+    x3 = _mm_loadu_si128((const __m128i*)(data + 0x20));
+    x4 = _mm_loadu_si128((const __m128i*)(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc32));
+    data += 64;
+    size -= 64;
+
+    // fold 4 x 128-bit in parallel
+    while (size >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data + 0x30)));
+        data += 64;
+        size -= 64;
+    }
+
+    // fold into 128-bit
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // fold the remaining 128-bit blocks
+    while (size >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)data)), x5);
+        data += 16;
+        size -= 16;
+    }
+
+    // fold 128-bit to 64-bit
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, low_mask);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32-bit
+    x2 = _mm_and_si128(x1, low_mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, low_mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_srli_si128(x1, 4);
+    return (uint32_t)_mm_cvtsi128_si32(x0);
+}
+
+#endif // BMX_PCLMUL_CRC32
+
+
+#if defined(BMX_ARM_CRC32)
+
+BMX_TARGET_ARM_CRC32
+static uint32_t arm_crc32_update(uint32_t crc32, const unsigned char *data, size_t size)
+{
+    while (size >= 8) {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        crc32 = __crc32d(crc32, value);
+        data += 8;
+        size -= 8;
+    }
+    while (size > 0) {
+        crc32 = __crc32b(crc32, *data);
+        data++;
+        size--;
+    }
+
+    return crc32;
+}
+
+#endif // BMX_ARM_CRC32
+
+
+
+void bmx::crc32_update(uint32_t *crc32, const unsigned char *data, size_t size)
+{
+#if defined(BMX_PCLMUL_CRC32)
+    if (size >= 64 && cpu_has_feature(CPU_FEATURE_PCLMUL)) {
+        size_t fold_size = size & ~(size_t)15;
+        *crc32 = pclmul_crc32_update(*crc32, data, fold_size);
+        data += fold_size;
+        size -= fold_size;
+    }
+#endif
+#if defined(BMX_ARM_CRC32)
+    if (cpu_has_feature(CPU_FEATURE_ARM_CRC32)) {
+        *crc32 = arm_crc32_update(*crc32, data, size);
+        return;
+    }
+#endif
+
+    *crc32 = table_crc32_update(*crc32, data, size);
 }
 
 void bmx::crc32_final(uint32_t *crc32)
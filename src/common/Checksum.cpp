@@ -37,6 +37,7 @@
 #include <cerrno>
 
 #include <bmx/Checksum.h>
+#include <bmx/MultiChecksum.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -89,34 +90,32 @@ vector<string> Checksum::CalcFileChecksums(const string &filename, const vector<
 
 vector<string> Checksum::CalcFileChecksums(FILE *file, const vector<ChecksumType> &types)
 {
-    vector<Checksum> checksums;
-    size_t i;
-    for (i = 0; i < types.size(); i++)
-        checksums.push_back(Checksum(types[i]));
+    if (types.empty())
+        return vector<string>();
 
-    const size_t buffer_size = 8192;
-    unsigned char *buffer = new unsigned char[buffer_size];
-    size_t num_read = buffer_size;
-    while (num_read == buffer_size) {
+    MultiChecksum checksums(types);
+
+    uint32_t buffer_size;
+    unsigned char *buffer;
+    size_t num_read;
+    do {
+        buffer = checksums.GetBuffer(&buffer_size);
         num_read = fread(buffer, 1, buffer_size, file);
         if (num_read != buffer_size && ferror(file)) {
             log_warn("Read failure when calculating checksum: %s\n", bmx_strerror(errno).c_str());
-            delete [] buffer;
             return vector<string>();
         }
 
-        if (num_read > 0) {
-            for (i = 0; i < checksums.size(); i++)
-                checksums[i].Update(buffer, (uint32_t)num_read);
-        }
-    }
-    delete [] buffer;
+        if (num_read > 0)
+            checksums.CommitBuffer((uint32_t)num_read);
+    } while (num_read == buffer_size);
+
+    checksums.Final();
 
     vector<string> result;
-    for (i = 0; i < checksums.size(); i++) {
-        checksums[i].Final();
-        result.push_back(checksums[i].GetDigestString());
-    }
+    size_t i;
+    for (i = 0; i < types.size(); i++)
+        result.push_back(checksums.GetChecksum(types[i])->GetDigestString());
 
     return result;
 }
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+
+#include <bmx/ChunkedByteArray.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+ChunkedByteArray::ChunkedByteArray(uint32_t record_size, uint32_t chunk_num_records)
+{
+    BMX_CHECK(record_size > 0 && chunk_num_records > 0);
+
+    mRecordSize = record_size;
+    mChunkNumRecords = chunk_num_records;
+    mNumRecords = 0;
+}
+
+ChunkedByteArray::~ChunkedByteArray()
+{
+    Clear();
+}
+
+unsigned char* ChunkedByteArray::AppendRecord()
+{
+    size_t chunk_offset = mNumRecords % mChunkNumRecords;
+    if (chunk_offset == 0) {
+        unsigned char *chunk = new unsigned char[(size_t)mChunkNumRecords * mRecordSize];
+        memset(chunk, 0, (size_t)mChunkNumRecords * mRecordSize);
+        mChunks.push_back(chunk);
+    }
+    mNumRecords++;
+
+    return mChunks.back() + chunk_offset * mRecordSize;
+}
+
+void ChunkedByteArray::AppendRecord(const unsigned char *bytes)
+{
+    memcpy(AppendRecord(), bytes, mRecordSize);
+}
+
+unsigned char* ChunkedByteArray::GetRecord(size_t index) const
+{
+    BMX_ASSERT(index < mNumRecords);
+
+    return mChunks[index / mChunkNumRecords] + (index % mChunkNumRecords) * mRecordSize;
+}
+
+size_t ChunkedByteArray::GetContiguousRecords(size_t index, size_t end, const unsigned char **bytes) const
+{
+    BMX_ASSERT(index < end && end <= mNumRecords);
+
+    size_t chunk_offset = index % mChunkNumRecords;
+    *bytes = mChunks[index / mChunkNumRecords] + chunk_offset * mRecordSize;
+
+    size_t count = mChunkNumRecords - chunk_offset;
+    if (count > end - index)
+        count = end - index;
+    return count;
+}
+
+void ChunkedByteArray::Clear()
+{
+    size_t i;
+    for (i = 0; i < mChunks.size(); i++)
+        delete [] mChunks[i];
+    mChunks.clear();
+    mNumRecords = 0;
+}
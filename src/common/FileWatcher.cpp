@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <thread>
+#include <chrono>
+
+#include <bmx/FileWatcher.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define SIZE_POLL_INTERVAL_MSEC     20
+
+
+
+static int64_t get_file_size_or_error(const string &filename)
+{
+    try
+    {
+        return get_file_size(filename);
+    }
+    catch (const BMXException&)
+    {
+        return -1;
+    }
+}
+
+
+
+FileWatcher::FileWatcher(const string &filename)
+{
+    mFilename = filename;
+    mNotifyFD = -1;
+    mLastSize = get_file_size_or_error(filename);
+
+#ifdef HAVE_SYS_INOTIFY_H
+    mNotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mNotifyFD >= 0 &&
+        inotify_add_watch(mNotifyFD, filename.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB) < 0)
+    {
+        log_debug("Failed to add inotify watch for file '%s': %s\n", filename.c_str(), bmx_strerror(errno).c_str());
+        close(mNotifyFD);
+        mNotifyFD = -1;
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    if (mNotifyFD >= 0)
+        close(mNotifyFD);
+#endif
+}
+
+bool FileWatcher::Wait(uint32_t timeout_msec)
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    if (mNotifyFD >= 0) {
+        struct pollfd poll_fd;
+        poll_fd.fd      = mNotifyFD;
+        poll_fd.events  = POLLIN;
+        poll_fd.revents = 0;
+
+        int result;
+        do {
+            result = poll(&poll_fd, 1, (int)timeout_msec);
+        } while (result < 0 && errno == EINTR);
+        if (result <= 0)
+            return false;
+
+        // drain the queued events; any event means the file has been modified
+        char buffer[4096];
+        while (read(mNotifyFD, buffer, sizeof(buffer)) > 0) {
+        }
+
+        return true;
+    }
+#endif
+
+    return PollFileSize(timeout_msec);
+}
+
+bool FileWatcher::PollFileSize(uint32_t timeout_msec)
+{
+    uint32_t waited = 0;
+    while (true) {
+        int64_t size = get_file_size_or_error(mFilename);
+        if (size != mLastSize) {
+            mLastSize = size;
+            return true;
+        }
+        if (waited >= timeout_msec)
+            break;
+
+        uint32_t interval = timeout_msec - waited;
+        if (interval > SIZE_POLL_INTERVAL_MSEC)
+            interval = SIZE_POLL_INTERVAL_MSEC;
+        this_thread::sleep_for(chrono::milliseconds(interval));
+        waited += interval;
+    }
+
+    return false;
+}
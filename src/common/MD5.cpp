@@ -110,7 +110,10 @@ static void byte_reverse(unsigned char *buf, unsigned longs)
 
 /* #define F1(x, y, z) (x & y | ~x & z) */
 #define F1(x, y, z) (z ^ (x & (y ^ z)))
-#define F2(x, y, z) F1(z, x, y)
+/* #define F2(x, y, z) F1(z, x, y) */
+/* the two terms of F2 have no common bits and so can be added; this allows the addition of (y & ~z),
+   which doesn't depend on the result of the previous step, to start early */
+#define F2(x, y, z) ((x & z) + (y & ~z))
 #define F3(x, y, z) (x ^ y ^ z)
 #define F4(x, y, z) (y ^ (x | ~z))
 
@@ -124,7 +127,7 @@ static void byte_reverse(unsigned char *buf, unsigned longs)
  * reflect the addition of 16 longwords of new data.  MD5Update blocks
  * the data and converts bytes into longwords for this routine.
  */
-static void md5_transform(uint32_t buf[4], uint32_t in[16])
+static void md5_transform(uint32_t buf[4], const uint32_t in[16])
 {
     register uint32_t a, b, c, d;
 
@@ -207,6 +210,39 @@ static void md5_transform(uint32_t buf[4], uint32_t in[16])
     buf[3] += d;
 }
 
+/*
+ * Transform a sequence of 64-byte blocks directly from the input data.
+ * Aligned input on little-endian machines is transformed in place; otherwise
+ * each block is first copied to an aligned, host order workspace.
+ */
+static void md5_transform_blocks(uint32_t buf[4], const unsigned char *data, uint32_t num_blocks)
+{
+    uint32_t in[16];
+    uint32_t i;
+#ifndef HIGHFIRST
+    if (((uintptr_t)data & (sizeof(uint32_t) - 1)) == 0) {
+        for (i = 0; i < num_blocks; i++) {
+            md5_transform(buf, (const uint32_t *) data);
+            data += 64;
+        }
+        return;
+    }
+#endif
+    for (i = 0; i < num_blocks; i++) {
+#ifndef HIGHFIRST
+        memcpy(in, data, 64);
+#else
+        int j;
+        for (j = 0; j < 16; j++) {
+            in[j] = (uint32_t)data[j * 4]             | ((uint32_t)data[j * 4 + 1] << 8) |
+                    ((uint32_t)data[j * 4 + 2] << 16) | ((uint32_t)data[j * 4 + 3] << 24);
+        }
+#endif
+        md5_transform(buf, in);
+        data += 64;
+    }
+}
+
 /*
  * Start MD5 accumulation.  Set bit count to 0 and buffer to mysterious
  * initialization constants.
@@ -257,12 +293,10 @@ void bmx::md5_update(MD5Context *ctx, const unsigned char *buf, uint32_t len)
     }
     /* Process data in 64-byte chunks */
 
-    while (len >= 64) {
-        memcpy(ctx->in, buf, 64);
-        byte_reverse(ctx->in, 16);
-        md5_transform(ctx->buf, (uint32_t *) ctx->in);
-        buf += 64;
-        len -= 64;
+    if (len >= 64) {
+        md5_transform_blocks(ctx->buf, buf, len / 64);
+        buf += len & ~63U;
+        len &= 63;
     }
 
     /* Handle any remaining bytes of data. */
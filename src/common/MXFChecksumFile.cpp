@@ -37,9 +37,13 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <thread>
+#include <atomic>
+
 #include <mxf/mxf.h>
 
 #include <bmx/MXFChecksumFile.h>
+#include <bmx/MultiChecksum.h>
 #include <bmx/Logging.h>
 #include <bmx/BMXException.h>
 
@@ -48,23 +52,112 @@ using namespace std;
 using namespace bmx;
 
 
+#define STREAM_READ_SIZE    (4 * 1024 * 1024)
+
+
 struct bmx::MXFChecksumFile
 {
     MXFFile *mxf_file;
 };
 
+typedef struct
+{
+    MXFFile *file;
+    MultiChecksum *checksum;
+    std::thread thread;
+    std::atomic<bool> stop;
+    bool result;
+    int64_t position;
+} ChecksumStreamer;
+
 struct MXFFileSysData
 {
     MXFChecksumFile checksum_file;
     MXFFile *target;
-    Checksum *checksum;
+    MultiChecksum *checksum;
     int64_t position;
     int64_t checksum_position;
     bool force_update;
     bool checksum_final;
+    ChecksumStreamer *streamer;
 };
 
 
+static void stream_checksum(ChecksumStreamer *streamer)
+{
+    try
+    {
+        if (!mxf_file_seek(streamer->file, 0, SEEK_SET))
+            throw false;
+
+        // read directly into the checksum buffer, which is at most STREAM_READ_SIZE
+        uint32_t buffer_size = 0;
+        uint32_t num_read = 0;
+        while (num_read == buffer_size && !streamer->stop) {
+            unsigned char *buffer = streamer->checksum->GetBuffer(&buffer_size);
+            if (buffer_size > STREAM_READ_SIZE)
+                buffer_size = STREAM_READ_SIZE;
+            num_read = mxf_file_read(streamer->file, buffer, buffer_size);
+            if (num_read > 0) {
+                streamer->checksum->CommitBuffer(num_read);
+                streamer->position += num_read;
+            }
+        }
+
+        streamer->result = !streamer->stop;
+    }
+    catch (...)
+    {
+        streamer->result = false;
+    }
+}
+
+static bool complete_stream_checksum(ChecksumStreamer *streamer, int64_t file_size)
+{
+    // the stream thread stops at the first short read, which is before the end if the file was still growing
+    if (streamer->position >= file_size)
+        return true;
+
+    try
+    {
+        // the seek clears the end-of-file state left by the short read
+        if (!mxf_file_seek(streamer->file, streamer->position, SEEK_SET))
+            return false;
+
+        while (streamer->position < file_size) {
+            uint32_t buffer_size;
+            unsigned char *buffer = streamer->checksum->GetBuffer(&buffer_size);
+            if (buffer_size > STREAM_READ_SIZE)
+                buffer_size = STREAM_READ_SIZE;
+            if (buffer_size > file_size - streamer->position)
+                buffer_size = (uint32_t)(file_size - streamer->position);
+            uint32_t num_read = mxf_file_read(streamer->file, buffer, buffer_size);
+            if (num_read == 0)
+                return false;
+            streamer->checksum->CommitBuffer(num_read);
+            streamer->position += num_read;
+        }
+
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+static bool join_streamer(ChecksumStreamer *streamer, int64_t file_size)
+{
+    if (streamer->thread.joinable())
+        streamer->thread.join();
+    if (streamer->result && !complete_stream_checksum(streamer, file_size))
+        streamer->result = false;
+    if (!streamer->result)
+        log_error("Failed to calculate checksum from a sequential read of the file\n");
+    return streamer->result;
+}
+
+
 static bool update_checksum_to_position(MXFChecksumFile *checksum_file, int64_t position)
 {
     MXFFile *mxf_file = checksum_file->mxf_file;
@@ -135,12 +228,26 @@ static void update_checksum_to_nonseekable_end(MXFChecksumFile *checksum_file)
 
 static void checksum_file_close(MXFFileSysData *sys_data)
 {
+    if (sys_data->streamer) {
+        sys_data->streamer->stop = true;
+        if (sys_data->streamer->thread.joinable())
+            sys_data->streamer->thread.join();
+        mxf_file_close(&sys_data->streamer->file);
+        delete sys_data->streamer;
+        sys_data->streamer = 0;
+    }
     if (sys_data->target)
         mxf_file_close(&sys_data->target);
 }
 
 static uint32_t checksum_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
 {
+    if (sys_data->streamer) {
+        uint32_t result = mxf_file_read(sys_data->target, data, count);
+        sys_data->position += result;
+        return result;
+    }
+
     if (sys_data->force_update &&
         !update_checksum_to_position(&sys_data->checksum_file, sys_data->position))
     {
@@ -167,7 +274,7 @@ static uint32_t checksum_file_read(MXFFileSysData *sys_data, uint8_t *data, uint
 
 static uint32_t checksum_file_write(MXFFileSysData *sys_data, const uint8_t *data, uint32_t count)
 {
-    BMX_CHECK_M(sys_data->position == sys_data->checksum_position,
+    BMX_CHECK_M(!sys_data->streamer && sys_data->position == sys_data->checksum_position,
                 ("File modification not supported when using the MXF checksum file"));
 
     uint32_t result = mxf_file_write(sys_data->target, data, count);
@@ -186,6 +293,13 @@ static uint32_t checksum_file_write(MXFFileSysData *sys_data, const uint8_t *dat
 
 static int checksum_file_getc(MXFFileSysData *sys_data)
 {
+    if (sys_data->streamer) {
+        int result = mxf_file_getc(sys_data->target);
+        if (result != EOF)
+            sys_data->position++;
+        return result;
+    }
+
     if (sys_data->force_update &&
         !update_checksum_to_position(&sys_data->checksum_file, sys_data->position))
     {
@@ -208,7 +322,7 @@ static int checksum_file_getc(MXFFileSysData *sys_data)
 
 static int checksum_file_putc(MXFFileSysData *sys_data, int c)
 {
-    BMX_CHECK_M(sys_data->position == sys_data->checksum_position,
+    BMX_CHECK_M(!sys_data->streamer && sys_data->position == sys_data->checksum_position,
                 ("File modification not supported when using the MXF Checksum file"));
 
     int result = mxf_file_putc(sys_data->target, c);
@@ -234,7 +348,7 @@ static int checksum_file_eof(MXFFileSysData *sys_data)
 static int checksum_file_seek(MXFFileSysData *sys_data, int64_t offset, int whence)
 {
     // if possible, seek using the checksum update if forced to update
-    if (sys_data->force_update) {
+    if (sys_data->force_update && !sys_data->streamer) {
         if (whence == SEEK_SET && offset > sys_data->checksum_position)
             return update_checksum_to_position(&sys_data->checksum_file, offset);
         else if (whence == SEEK_CUR && sys_data->position + offset > sys_data->checksum_position)
@@ -259,7 +373,7 @@ static int checksum_file_seek(MXFFileSysData *sys_data, int64_t offset, int when
                 break;
         }
 
-        if (sys_data->force_update &&
+        if (sys_data->force_update && !sys_data->streamer &&
             !update_checksum_to_position(&sys_data->checksum_file, sys_data->position))
         {
             return 0;
@@ -301,6 +415,11 @@ static void free_checksum_file(MXFFileSysData *sys_data)
 
 
 MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, ChecksumType type)
+{
+    return mxf_checksum_file_open(target, vector<ChecksumType>(1, type));
+}
+
+MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, const vector<ChecksumType> &types)
 {
     MXFFile *checksum_file = 0;
     try
@@ -312,7 +431,7 @@ MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, ChecksumType type)
         memset(checksum_file->sysData, 0, sizeof(MXFFileSysData));
 
         checksum_file->sysData->target            = target;
-        checksum_file->sysData->checksum          = new Checksum(type);
+        checksum_file->sysData->checksum          = new MultiChecksum(types);
         checksum_file->sysData->position          = mxf_file_tell(target);
         checksum_file->sysData->checksum_position = 0;
         checksum_file->sysData->force_update      = false;
@@ -348,6 +467,45 @@ MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, ChecksumType type)
     }
 }
 
+MXFChecksumFile* bmx::mxf_checksum_file_open_stream(MXFFile *target, ChecksumType type, MXFFile *stream_file)
+{
+    return mxf_checksum_file_open_stream(target, vector<ChecksumType>(1, type), stream_file);
+}
+
+MXFChecksumFile* bmx::mxf_checksum_file_open_stream(MXFFile *target, const vector<ChecksumType> &types,
+                                                    MXFFile *stream_file)
+{
+    MXFChecksumFile *checksum_file = 0;
+    try
+    {
+        checksum_file = mxf_checksum_file_open(target, types);
+
+        MXFFileSysData *sys_data = checksum_file->mxf_file->sysData;
+        sys_data->streamer = new ChecksumStreamer;
+        sys_data->streamer->file = stream_file;
+        sys_data->streamer->checksum = sys_data->checksum;
+        sys_data->streamer->stop = false;
+        sys_data->streamer->result = false;
+        sys_data->streamer->position = 0;
+        sys_data->streamer->thread = std::thread(stream_checksum, sys_data->streamer);
+
+        return checksum_file;
+    }
+    catch (...)
+    {
+        if (checksum_file) {
+            MXFFile *mxf_file = checksum_file->mxf_file;
+            mxf_file->sysData->target = 0; // ownership returns to the caller
+            if (!mxf_file->sysData->streamer)
+                mxf_file_close(&stream_file);
+            mxf_file_close(&mxf_file);
+        } else {
+            mxf_file_close(&stream_file);
+        }
+        throw;
+    }
+}
+
 MXFFile* bmx::mxf_checksum_file_get_file(MXFChecksumFile *checksum_file)
 {
     return checksum_file->mxf_file;
@@ -366,7 +524,11 @@ bool bmx::mxf_checksum_file_final(MXFChecksumFile *checksum_file)
     if (sys_data->checksum_final)
         return true;
 
-    if (mxf_file_is_seekable(mxf_file)) {
+    if (sys_data->streamer) {
+        // the target has been read to the end and so its size is the final size of a growing file
+        if (!join_streamer(sys_data->streamer, mxf_file_size(sys_data->target)))
+            return false;
+    } else if (mxf_file_is_seekable(mxf_file)) {
         int64_t file_pos = mxf_file_tell(mxf_file);
         int64_t file_size = mxf_file_size(mxf_file);
         if (!update_checksum_to_position(checksum_file, file_size))
@@ -385,15 +547,34 @@ bool bmx::mxf_checksum_file_final(MXFChecksumFile *checksum_file)
 
 size_t bmx::mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file)
 {
-    return checksum_file->mxf_file->sysData->checksum->GetDigestSize();
+    MultiChecksum *checksum = checksum_file->mxf_file->sysData->checksum;
+    return mxf_checksum_file_digest_size(checksum_file, checksum->GetType(0));
 }
 
 void bmx::mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, unsigned char *digest, size_t size)
 {
-    return checksum_file->mxf_file->sysData->checksum->GetDigest(digest, size);
+    MultiChecksum *checksum = checksum_file->mxf_file->sysData->checksum;
+    return mxf_checksum_file_digest(checksum_file, checksum->GetType(0), digest, size);
 }
 
 string bmx::mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file)
 {
-    return checksum_file->mxf_file->sysData->checksum->GetDigestString();
+    MultiChecksum *checksum = checksum_file->mxf_file->sysData->checksum;
+    return mxf_checksum_file_digest_str(checksum_file, checksum->GetType(0));
+}
+
+size_t bmx::mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file, ChecksumType type)
+{
+    return checksum_file->mxf_file->sysData->checksum->GetChecksum(type)->GetDigestSize();
+}
+
+void bmx::mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, ChecksumType type, unsigned char *digest,
+                                   size_t size)
+{
+    return checksum_file->mxf_file->sysData->checksum->GetChecksum(type)->GetDigest(digest, size);
+}
+
+string bmx::mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file, ChecksumType type)
+{
+    return checksum_file->mxf_file->sysData->checksum->GetChecksum(type)->GetDigestString();
 }
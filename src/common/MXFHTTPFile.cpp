@@ -41,6 +41,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <map>
+#include <list>
+#include <deque>
+
 #include <curl/curl.h>
 
 #include <mxf/mxf.h>
@@ -54,37 +58,69 @@ using namespace std;
 using namespace bmx;
 
 
+#define DEFAULT_CACHE_BLOCKS    64
+
+
 typedef struct
 {
     MXFFile *mxf_file;
 } MXFHTTPFile;
 
-struct MXFFileSysData
+typedef enum
 {
-    MXFHTTPFile http_file;
-    string url_str;
-    CURL *curl;
-    int64_t position;
-    int eof;
-    unsigned char *buffer;
-    uint32_t buffer_pos;
-    uint32_t buffer_size;
-    uint32_t buffer_alloc_size;
-    bool disable_response_code_warn;
-};
+    HTTP_BLOCK_PENDING,
+    HTTP_BLOCK_DONE,
+    HTTP_BLOCK_FAILED,
+} HTTPBlockState;
+
+typedef struct
+{
+    int64_t index;
+    unsigned char *data;
+    uint32_t size;          // less than the block size at the end of the file
+    HTTPBlockState state;
+    bool demand;            // a read is waiting for the block
+    bool in_lru;
+    list<int64_t>::iterator lru_iter;
+} HTTPBlock;
 
 typedef struct
 {
     MXFFileSysData *sys_data;
+    CURL *curl;
     int64_t range_first;
     int64_t range_last;
+    vector<HTTPBlock*> blocks;
     uint8_t *client_data;
     uint32_t client_rem_count;
     uint32_t read_count;
     bool accept_range_recv;
     bool accept_bytes_range;
+    char error_buf[CURL_ERROR_SIZE];
+    char range_buf[64];
 } CURLReceiveInfo;
 
+struct MXFFileSysData
+{
+    MXFHTTPFile http_file;
+    string url_str;
+    CURL *curl;
+    CURLM *multi;
+    vector<CURL*> free_handles;
+    vector<CURLReceiveInfo*> transfers;
+    int64_t position;
+    int eof;
+    uint32_t block_size;
+    uint32_t max_blocks;
+    uint32_t prefetch_count;
+    map<int64_t, HTTPBlock*> blocks;
+    list<int64_t> lru;      // completed blocks, most recently used first
+    int64_t known_size;     // the file size, or an upper bound, once a response has revealed it
+    int64_t last_read_end;
+    deque<pair<int64_t, uint32_t> > hint_ranges;
+    bool disable_response_code_warn;
+};
+
 
 static size_t get_http_field_value_pos(const string &header_str, const string &field_name)
 {
@@ -122,14 +158,16 @@ static size_t curl_header_cb(char *buffer, size_t size, size_t nmemb, void *priv
   size_t fidx = get_http_field_value_pos(header_str, "Accept-Ranges");
   if (fidx != string::npos) {
       info->accept_range_recv = true;
-      if (header_str.compare(fidx, 5, "bytes"))
+      if (header_str.compare(fidx, 5, "bytes") == 0)
           info->accept_bytes_range = true;
   }
 
   fidx = get_http_field_value_pos(header_str, "Content-Range");
   if (fidx != string::npos) {
       int64_t first;
-      if (sscanf(&header_str.c_str()[fidx], "%" PRId64, &first) == 1) {
+      if (sscanf(&header_str.c_str()[fidx], "bytes %" PRId64, &first) == 1 ||
+          sscanf(&header_str.c_str()[fidx], "%" PRId64, &first) == 1)
+      {
           if (first != info->range_first) {
               log_warn("HTTP content range start byte at %" PRId64 " does not match requested start byte at %" PRId64 "\n",
                        first, info->range_first);
@@ -146,130 +184,452 @@ static size_t curl_data_cb(void* ptr, size_t size, size_t nmemb, void *priv)
 
   size_t rec_count = size * nmemb;
 
-  uint32_t client_copy_count = 0;
-  if (info->client_rem_count > 0) {
-      client_copy_count = info->client_rem_count;
+  // a transfer either reads directly into the client's data or into cache blocks
+  if (info->client_data) {
+      uint32_t client_copy_count = info->client_rem_count;
       if (client_copy_count > rec_count)
           client_copy_count = (uint32_t)(rec_count);
       memcpy(&info->client_data[info->read_count], ptr, client_copy_count);
       info->client_rem_count   -= client_copy_count;
       info->sys_data->position += client_copy_count;
       info->read_count         += client_copy_count;
+      return client_copy_count;
   }
 
-  uint32_t buf_copy_count = 0;
-  if (client_copy_count < rec_count) {
-      buf_copy_count = info->sys_data->buffer_alloc_size - info->sys_data->buffer_size;
-      if (buf_copy_count > rec_count - client_copy_count)
-          buf_copy_count = (uint32_t)(rec_count - client_copy_count);
-      memcpy(&info->sys_data->buffer[info->sys_data->buffer_size], &((unsigned char*)ptr)[client_copy_count], buf_copy_count);
-      info->sys_data->buffer_size += buf_copy_count;
-      info->read_count            += buf_copy_count;
+  uint32_t block_size = info->sys_data->block_size;
+  size_t copy_count = 0;
+  while (copy_count < rec_count) {
+      size_t block_offset = info->read_count / block_size;
+      if (block_offset >= info->blocks.size())
+          break;
+      HTTPBlock *block = info->blocks[block_offset];
+      uint32_t block_copy_count = block_size - block->size;
+      if (block_copy_count > rec_count - copy_count)
+          block_copy_count = (uint32_t)(rec_count - copy_count);
+      memcpy(&block->data[block->size], &((unsigned char*)ptr)[copy_count], block_copy_count);
+      block->size      += block_copy_count;
+      info->read_count += block_copy_count;
+      copy_count       += block_copy_count;
   }
 
-  return (size_t)client_copy_count + (size_t)buf_copy_count;
+  return copy_count;
+}
+
+
+static void setup_transfer(MXFFileSysData *sys_data, CURL *curl, CURLReceiveInfo *info)
+{
+    bmx_snprintf(info->range_buf, sizeof(info->range_buf), "%" PRId64 "-%" PRId64,
+                 info->range_first, info->range_last);
+
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, info->error_buf);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1);
+    curl_easy_setopt(curl, CURLOPT_URL, sys_data->url_str.c_str());
+    curl_easy_setopt(curl, CURLOPT_RANGE, info->range_buf);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_data_cb);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)info);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_header_cb);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void*)info);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)info);
+}
+
+static bool check_transfer_result(MXFFileSysData *sys_data, CURLReceiveInfo *info, CURLcode result, bool log_errors)
+{
+    if (result != 0) {
+        if (result == CURLE_PARTIAL_FILE)
+            return true;
+
+        if (result == CURLE_WRITE_ERROR) {
+            if (!info->accept_range_recv || !info->accept_bytes_range) {
+                if (log_errors) {
+                    bmx::log((info->range_first == 0 ? WARN_LOG: ERROR_LOG),
+                             "HTTP server does not support byte range requests\n");
+                }
+                // the data is valid if it was requested from the start of the file
+                return info->range_first == 0;
+            } else if (log_errors) {
+                log_error("HTTP server returned more data than requested\n");
+            }
+        } else if (log_errors) {
+            log_error("HTTP request failed: %s (curl result %d)\n", info->error_buf, result);
+        }
+        return false;
+    }
+
+    long code;
+    curl_easy_getinfo(info->curl, CURLINFO_RESPONSE_CODE, &code);
+    if (code != 206) { // 206 = partial content
+        if (!sys_data->disable_response_code_warn) {
+            if (info->accept_range_recv && !info->accept_bytes_range)
+                log_warn("HTTP server does not support byte range requests\n");
+            else if (!info->accept_range_recv)
+                log_warn("HTTP server does not indicate support for byte range requests\n");
+            else
+                log_warn("Unexpected HTTP response code %ld\n", code);
+            sys_data->disable_response_code_warn = true;
+        }
+        // the whole file was returned, which only matches the request if it started at the beginning
+        return info->range_first == 0;
+    }
+    sys_data->disable_response_code_warn = false;
+
+    // a short response identifies the end of the file
+    if (info->range_first + info->read_count <= info->range_last &&
+        (sys_data->known_size < 0 || info->range_first + info->read_count < sys_data->known_size))
+    {
+        sys_data->known_size = info->range_first + info->read_count;
+    }
+
+    return true;
+}
+
+
+static void remove_block(MXFFileSysData *sys_data, HTTPBlock *block)
+{
+    if (block->in_lru)
+        sys_data->lru.erase(block->lru_iter);
+    sys_data->blocks.erase(block->index);
+    delete [] block->data;
+    delete block;
+}
+
+static void touch_block(MXFFileSysData *sys_data, HTTPBlock *block)
+{
+    if (block->in_lru)
+        sys_data->lru.erase(block->lru_iter);
+    sys_data->lru.push_front(block->index);
+    block->lru_iter = sys_data->lru.begin();
+    block->in_lru = true;
+}
+
+static void evict_blocks(MXFFileSysData *sys_data)
+{
+    // pending blocks are not in the LRU list and are therefore never evicted
+    while (sys_data->blocks.size() > sys_data->max_blocks && !sys_data->lru.empty()) {
+        map<int64_t, HTTPBlock*>::iterator iter = sys_data->blocks.find(sys_data->lru.back());
+        BMX_ASSERT(iter != sys_data->blocks.end());
+        remove_block(sys_data, iter->second);
+    }
+}
+
+static void complete_transfer(MXFFileSysData *sys_data, CURLReceiveInfo *info, CURLcode result)
+{
+    curl_multi_remove_handle(sys_data->multi, info->curl);
+    sys_data->free_handles.push_back(info->curl);
+
+    // errors are only reported for data that a read is waiting for; prefetched blocks that failed are
+    // dropped and fetched again if needed
+    bool demand = false;
+    size_t i;
+    for (i = 0; i < info->blocks.size(); i++)
+        demand = demand || info->blocks[i]->demand;
+
+    bool success = check_transfer_result(sys_data, info, result, demand);
+    if (!success && result == CURLE_HTTP_RETURNED_ERROR) {
+        long code;
+        curl_easy_getinfo(info->curl, CURLINFO_RESPONSE_CODE, &code);
+        if (code == 416 && (sys_data->known_size < 0 || info->range_first < sys_data->known_size))
+            sys_data->known_size = info->range_first; // range not satisfiable, i.e. starts beyond the end
+    }
+    for (i = 0; i < info->blocks.size(); i++) {
+        HTTPBlock *block = info->blocks[i];
+        if (success) {
+            block->state = HTTP_BLOCK_DONE;
+            touch_block(sys_data, block);
+        } else if (block->demand) {
+            block->state = HTTP_BLOCK_FAILED;
+        } else {
+            remove_block(sys_data, block);
+        }
+    }
+
+    for (i = 0; i < sys_data->transfers.size(); i++) {
+        if (sys_data->transfers[i] == info) {
+            sys_data->transfers.erase(sys_data->transfers.begin() + i);
+            break;
+        }
+    }
+    delete info;
+}
+
+static void run_transfers(MXFFileSysData *sys_data, bool wait)
+{
+    int running;
+    curl_multi_perform(sys_data->multi, &running);
+
+    CURLMsg *msg;
+    int msgs_left;
+    bool completed = false;
+    while ((msg = curl_multi_info_read(sys_data->multi, &msgs_left)) != 0) {
+        if (msg->msg != CURLMSG_DONE)
+            continue;
+        CURLReceiveInfo *info = 0;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&info);
+        BMX_ASSERT(info);
+        complete_transfer(sys_data, info, msg->data.result);
+        completed = true;
+    }
+
+    if (wait && !completed && running > 0)
+        curl_multi_wait(sys_data->multi, 0, 0, 1000, 0);
+}
+
+static void start_transfer(MXFFileSysData *sys_data, int64_t first_index, int64_t last_index, bool demand)
+{
+    if (sys_data->known_size >= 0) {
+        int64_t last_file_index = (sys_data->known_size - 1) / sys_data->block_size;
+        if (last_index > last_file_index)
+            last_index = last_file_index;
+    }
+    if (first_index > last_index)
+        return;
+
+    CURL *curl;
+    if (sys_data->free_handles.empty()) {
+        curl = curl_easy_init();
+        if (!curl) {
+            log_error("Failed to initialise curl handle\n");
+            return;
+        }
+    } else {
+        curl = sys_data->free_handles.back();
+        sys_data->free_handles.pop_back();
+    }
+
+    CURLReceiveInfo *info = new CURLReceiveInfo;
+    info->sys_data           = sys_data;
+    info->curl               = curl;
+    info->range_first        = first_index * sys_data->block_size;
+    info->range_last         = (last_index + 1) * sys_data->block_size - 1;
+    info->client_data        = 0;
+    info->client_rem_count   = 0;
+    info->read_count         = 0;
+    info->accept_range_recv  = false;
+    info->accept_bytes_range = false;
+    info->error_buf[0]       = 0;
+
+    int64_t index;
+    for (index = first_index; index <= last_index; index++) {
+        HTTPBlock *block = new HTTPBlock;
+        block->index  = index;
+        block->data   = new unsigned char[sys_data->block_size];
+        block->size   = 0;
+        block->state  = HTTP_BLOCK_PENDING;
+        block->demand = demand;
+        block->in_lru = false;
+        sys_data->blocks[index] = block;
+        info->blocks.push_back(block);
+    }
+
+    setup_transfer(sys_data, info->curl, info);
+
+    sys_data->transfers.push_back(info);
+    curl_multi_add_handle(sys_data->multi, info->curl);
+}
+
+static void request_blocks(MXFFileSysData *sys_data, int64_t first_index, int64_t last_index, bool demand)
+{
+    // a single request for each run of blocks that are not in the cache
+    int64_t index = first_index;
+    while (index <= last_index) {
+        while (index <= last_index && sys_data->blocks.count(index))
+            index++;
+        if (index > last_index)
+            break;
+
+        int64_t run_first_index = index;
+        while (index <= last_index && !sys_data->blocks.count(index))
+            index++;
+        start_transfer(sys_data, run_first_index, index - 1, demand);
+    }
+}
+
+static void forget_known_size(MXFFileSysData *sys_data)
+{
+    // the file may have grown since the end was revealed. Forget the size and drop the completed blocks at and
+    // beyond the end so that they are requested again
+    map<int64_t, HTTPBlock*>::iterator iter = sys_data->blocks.lower_bound(sys_data->known_size / sys_data->block_size);
+    while (iter != sys_data->blocks.end()) {
+        HTTPBlock *block = iter->second;
+        iter++;
+        if (block->state != HTTP_BLOCK_PENDING)
+            remove_block(sys_data, block);
+    }
+
+    sys_data->known_size = -1;
+}
+
+static void update_prefetch(MXFFileSysData *sys_data, int64_t read_position, int64_t read_end)
+{
+    // prefetching uses the block cache, which is disabled if the block size is 0
+    if (sys_data->prefetch_count == 0 || sys_data->block_size == 0)
+        return;
+
+    // drop hints for data that has been read
+    while (!sys_data->hint_ranges.empty() &&
+           sys_data->hint_ranges.front().first + sys_data->hint_ranges.front().second <= read_end)
+    {
+        sys_data->hint_ranges.pop_front();
+    }
+
+    // prefetch the hinted ranges, or else the next blocks if reading sequentially, leaving room in the cache
+    // for the blocks being read
+    uint32_t max_pending_blocks = sys_data->max_blocks / 2;
+    size_t num_pending_blocks = sys_data->blocks.size() - sys_data->lru.size();
+    size_t i;
+    for (i = 0; i < sys_data->hint_ranges.size(); i++) {
+        if (sys_data->transfers.size() >= sys_data->prefetch_count || num_pending_blocks >= max_pending_blocks)
+            return;
+
+        int64_t first_index = sys_data->hint_ranges[i].first / sys_data->block_size;
+        int64_t last_index  = (sys_data->hint_ranges[i].first + sys_data->hint_ranges[i].second - 1) /
+                                    sys_data->block_size;
+        if (last_index - first_index + 1 > (int64_t)(max_pending_blocks - num_pending_blocks))
+            last_index = first_index + (max_pending_blocks - num_pending_blocks) - 1;
+        request_blocks(sys_data, first_index, last_index, false);
+        num_pending_blocks = sys_data->blocks.size() - sys_data->lru.size();
+    }
+    if (!sys_data->hint_ranges.empty() || read_position != sys_data->last_read_end)
+        return;
+
+    int64_t next_index = (read_end + sys_data->block_size - 1) / sys_data->block_size;
+    for (i = 0; i < sys_data->prefetch_count; i++) {
+        if (sys_data->transfers.size() >= sys_data->prefetch_count || num_pending_blocks >= max_pending_blocks)
+            break;
+        if (sys_data->known_size >= 0 && next_index * sys_data->block_size >= sys_data->known_size)
+            break;
+        if (!sys_data->blocks.count(next_index)) {
+            start_transfer(sys_data, next_index, next_index, false);
+            num_pending_blocks++;
+        }
+        next_index++;
+    }
 }
 
 
 static void http_file_close(MXFFileSysData *sys_data)
 {
+    while (!sys_data->transfers.empty()) {
+        CURLReceiveInfo *info = sys_data->transfers.back();
+        curl_multi_remove_handle(sys_data->multi, info->curl);
+        curl_easy_cleanup(info->curl);
+        sys_data->transfers.pop_back();
+        delete info;
+    }
+    while (!sys_data->blocks.empty())
+        remove_block(sys_data, sys_data->blocks.begin()->second);
+    size_t i;
+    for (i = 0; i < sys_data->free_handles.size(); i++)
+        curl_easy_cleanup(sys_data->free_handles[i]);
+    sys_data->free_handles.clear();
+
+    if (sys_data->multi)
+        curl_multi_cleanup(sys_data->multi);
     if (sys_data->curl)
         curl_easy_cleanup(sys_data->curl);
-    delete [] sys_data->buffer;
 }
 
-static uint32_t http_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
+static uint32_t http_file_direct_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
 {
-    uint8_t *data_ptr  = data;
-    uint32_t rem_count = count;
+    CURLReceiveInfo info;
+    info.sys_data           = sys_data;
+    info.curl               = sys_data->curl;
+    info.range_first        = sys_data->position;
+    info.range_last         = sys_data->position + count - 1;
+    info.client_data        = data;
+    info.client_rem_count   = count;
+    info.read_count         = 0;
+    info.accept_range_recv  = false;
+    info.accept_bytes_range = false;
+    info.error_buf[0]       = 0;
+    setup_transfer(sys_data, sys_data->curl, &info);
 
+    CURLcode result = curl_easy_perform(sys_data->curl);
+    if (!check_transfer_result(sys_data, &info, result, true)) {
+        sys_data->position -= info.read_count;
+        return 0;
+    }
+
+    return info.read_count;
+}
+
+static uint32_t http_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
+{
     sys_data->eof = 0;
+    if (count == 0)
+        return 0;
 
-    uint32_t buffer_copy_size = 0;
-    if (sys_data->buffer_pos < sys_data->buffer_size) {
-        buffer_copy_size = sys_data->buffer_size - sys_data->buffer_pos;
-        if (buffer_copy_size > rem_count)
-            buffer_copy_size = rem_count;
-        if (buffer_copy_size > 0) {
-            memcpy(data_ptr, &sys_data->buffer[sys_data->buffer_pos], buffer_copy_size);
-            sys_data->buffer_pos += buffer_copy_size;
-            sys_data->position   += buffer_copy_size;
-            data_ptr             += buffer_copy_size;
-            rem_count            -= buffer_copy_size;
+    int64_t read_position = sys_data->position;
+
+    // large reads bypass the cache
+    if (sys_data->block_size == 0 || count / sys_data->block_size >= sys_data->max_blocks / 2) {
+        uint32_t num_read = http_file_direct_read(sys_data, data, count);
+        sys_data->last_read_end = sys_data->position;
+        update_prefetch(sys_data, read_position, sys_data->position);
+        return num_read;
+    }
+
+    if (sys_data->known_size >= 0 && sys_data->position + count > sys_data->known_size)
+        forget_known_size(sys_data);
+
+    int64_t first_index = sys_data->position / sys_data->block_size;
+    int64_t last_index  = (sys_data->position + count - 1) / sys_data->block_size;
+    request_blocks(sys_data, first_index, last_index, true);
+    update_prefetch(sys_data, read_position, read_position + count);
+
+    uint32_t num_read = 0;
+    int64_t index;
+    for (index = first_index; index <= last_index && num_read < count; index++) {
+        map<int64_t, HTTPBlock*>::iterator iter = sys_data->blocks.find(index);
+        if (iter == sys_data->blocks.end()) {
+            // a failed prefetch was dropped
+            request_blocks(sys_data, index, last_index, true);
+            iter = sys_data->blocks.find(index);
+            if (iter == sys_data->blocks.end())
+                break; // beyond the end of the file
         }
+
+        HTTPBlock *block = iter->second;
+        block->demand = true;
+        while (block->state == HTTP_BLOCK_PENDING)
+            run_transfers(sys_data, true);
+        if (block->state == HTTP_BLOCK_FAILED)
+            break;
+        touch_block(sys_data, block);
+
+        uint32_t block_offset = (uint32_t)(sys_data->position - index * sys_data->block_size);
+        if (block_offset >= block->size)
+            break;
+        uint32_t copy_count = block->size - block_offset;
+        if (copy_count > count - num_read)
+            copy_count = count - num_read;
+        memcpy(&data[num_read], &block->data[block_offset], copy_count);
+        num_read           += copy_count;
+        sys_data->position += copy_count;
+        if (block->size < sys_data->block_size)
+            break;
     }
 
-    if (rem_count > 0) {
-        char error_buf[CURL_ERROR_SIZE];
-
-        sys_data->buffer_pos  = 0;
-        sys_data->buffer_size = 0;
-
-        CURLReceiveInfo info;
-        memset(&info, 0, sizeof(info));
-        info.sys_data         = sys_data;
-        info.client_data      = data_ptr;
-        info.client_rem_count = rem_count;
-        info.range_first      = sys_data->position;
-        info.range_last       = sys_data->position;
-        if (rem_count > sys_data->buffer_alloc_size)
-            info.range_last += rem_count - 1;
+    // drop failed blocks so that they are requested again by the next read
+    map<int64_t, HTTPBlock*>::iterator iter = sys_data->blocks.begin();
+    while (iter != sys_data->blocks.end()) {
+        HTTPBlock *block = iter->second;
+        iter++;
+        if (block->state == HTTP_BLOCK_FAILED)
+            remove_block(sys_data, block);
         else
-            info.range_last += sys_data->buffer_alloc_size - 1;
-
-        char range_buf[64];
-        bmx_snprintf(range_buf, sizeof(range_buf), "%" PRId64 "-%" PRId64,
-                     info.range_first, info.range_last);
-
-        curl_easy_reset(sys_data->curl);
-        curl_easy_setopt(sys_data->curl, CURLOPT_ERRORBUFFER, error_buf);
-        curl_easy_setopt(sys_data->curl, CURLOPT_NOPROGRESS, 1);
-        curl_easy_setopt(sys_data->curl, CURLOPT_URL, sys_data->url_str.c_str());
-        curl_easy_setopt(sys_data->curl, CURLOPT_RANGE, range_buf);
-        curl_easy_setopt(sys_data->curl, CURLOPT_WRITEFUNCTION, curl_data_cb);
-        curl_easy_setopt(sys_data->curl, CURLOPT_WRITEDATA, (void*)&info);
-        curl_easy_setopt(sys_data->curl, CURLOPT_HEADERFUNCTION, curl_header_cb);
-        curl_easy_setopt(sys_data->curl, CURLOPT_HEADERDATA, (void*)&info);
-        curl_easy_setopt(sys_data->curl, CURLOPT_FAILONERROR, 1);
-
-        CURLcode result = curl_easy_perform(sys_data->curl);
-        rem_count = info.client_rem_count;
-
-        if (result != 0) {
-            if (result != CURLE_PARTIAL_FILE) {
-                if (result == CURLE_WRITE_ERROR) {
-                    if (!info.accept_range_recv || !info.accept_bytes_range) {
-                        if (info.range_first != 0)
-                            rem_count = count;
-                        bmx::log((info.range_first == 0 ? WARN_LOG: ERROR_LOG),
-                                 "HTTP server does not support byte range requests\n");
-                    } else {
-                        log_error("HTTP server returned more data than requested\n");
-                    }
-                } else {
-                    log_error("HTTP request failed: %s (curl result %d)\n", error_buf, result);
-                }
-            }
-        } else {
-            long code;
-            curl_easy_getinfo(sys_data->curl, CURLINFO_RESPONSE_CODE, &code);
-            if (code != 206) { // 206 = partial content
-                if (!sys_data->disable_response_code_warn) {
-                    if (info.accept_range_recv && !info.accept_bytes_range)
-                        log_warn("HTTP server does not support byte range requests\n");
-                    else if (!info.accept_range_recv)
-                        log_warn("HTTP server does not indicate support for byte range requests\n");
-                    else
-                        log_warn("Unexpected HTTP response code %ld\n", code);
-                    sys_data->disable_response_code_warn = true;
-                }
-            } else {
-                sys_data->disable_response_code_warn = false;
-            }
-        }
+            block->demand = false;
     }
 
-    return count - rem_count;
+    // progress the prefetch transfers
+    if (!sys_data->transfers.empty())
+        run_transfers(sys_data, false);
+
+    evict_blocks(sys_data);
+    sys_data->last_read_end = sys_data->position;
+
+    return num_read;
 }
 
 static uint32_t http_file_write(MXFFileSysData *sys_data, const uint8_t *data, uint32_t count)
@@ -354,22 +714,8 @@ static int http_file_seek(MXFFileSysData *sys_data, int64_t offset, int whence)
         return 0;
     }
 
-    if (sys_data->position != new_position) {
-        int64_t pos_diff = new_position - sys_data->position;
-        if (sys_data->buffer_size > 0 &&
-            pos_diff >= - (int64_t)sys_data->buffer_pos &&
-            pos_diff < (int64_t)(sys_data->buffer_size - sys_data->buffer_pos))
-        {
-            sys_data->buffer_pos = (uint32_t)(sys_data->buffer_pos + pos_diff);
-        }
-        else
-        {
-            sys_data->buffer_size = 0;
-            sys_data->buffer_pos  = 0;
-        }
-        sys_data->position = new_position;
-    }
-
+    // cached blocks remain valid after a seek
+    sys_data->position = new_position;
     sys_data->eof = false;
 
     return 1;
@@ -393,6 +739,12 @@ bool bmx::mxf_http_is_url(const string &url_str)
 }
 
 MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_size)
+{
+    return mxf_http_file_open_read(url_str, min_read_size, DEFAULT_CACHE_BLOCKS, 0);
+}
+
+MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_size, uint32_t cache_blocks,
+                                      uint32_t prefetch_count)
 {
     MXFFile *http_file = 0;
     try
@@ -405,18 +757,18 @@ MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_s
         http_file->sysData->http_file.mxf_file = http_file;
         http_file->sysData->url_str = url_str;
         http_file->sysData->curl = 0;
+        http_file->sysData->multi = 0;
         http_file->sysData->position = 0;
         http_file->sysData->eof = false;
-        http_file->sysData->buffer = 0;
-        http_file->sysData->buffer_pos = 0;
-        http_file->sysData->buffer_size = 0;
-        http_file->sysData->buffer_alloc_size = 0;
+        http_file->sysData->block_size = min_read_size;
+        http_file->sysData->max_blocks = (cache_blocks < 2 ? 2 : cache_blocks);
+        http_file->sysData->prefetch_count = prefetch_count;
+        http_file->sysData->known_size = -1;
+        http_file->sysData->last_read_end = -1;
+        http_file->sysData->disable_response_code_warn = false;
 
         BMX_CHECK((http_file->sysData->curl = curl_easy_init()) != 0);
-        if (min_read_size > 0) {
-            http_file->sysData->buffer            = new unsigned char[min_read_size];
-            http_file->sysData->buffer_alloc_size = min_read_size;
-        }
+        BMX_CHECK((http_file->sysData->multi = curl_multi_init()) != 0);
 
         http_file->close         = http_file_close;
         http_file->read          = http_file_read;
@@ -440,6 +792,17 @@ MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_s
     }
 }
 
+bool bmx::mxf_http_file_hint_ranges(MXFFile *mxf_file, const vector<pair<int64_t, uint32_t> > &ranges)
+{
+    if (mxf_file->close != http_file_close)
+        return false;
+
+    MXFFileSysData *sys_data = mxf_file->sysData;
+    sys_data->hint_ranges.assign(ranges.begin(), ranges.end());
+
+    return true;
+}
+
 
 #else // ifdef HAVE_LIBCURL
 
@@ -472,5 +835,22 @@ MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_s
     BMX_EXCEPTION(("HTTP file access is not supported in this build"));
 }
 
+MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_size, uint32_t cache_blocks,
+                                      uint32_t prefetch_count)
+{
+    (void)url_str;
+    (void)min_read_size;
+    (void)cache_blocks;
+    (void)prefetch_count;
+    BMX_EXCEPTION(("HTTP file access is not supported in this build"));
+}
+
+bool bmx::mxf_http_file_hint_ranges(MXFFile *mxf_file, const vector<pair<int64_t, uint32_t> > &ranges)
+{
+    (void)mxf_file;
+    (void)ranges;
+    return false;
+}
+
 
 #endif
@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if !defined(_WIN32)
+
+#define __STDC_LIMIT_MACROS
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <mxf/mxf.h>
+
+#include <bmx/MXFMMapFile.h>
+#include <bmx/Utils.h>
+#include <bmx/Logging.h>
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+// size of the region ahead of the read position that is advised to be needed
+#define WILLNEED_WINDOW_SIZE    (32 * 1024 * 1024)
+
+
+typedef struct
+{
+    MXFFile *mxf_file;
+} MXFMMapFile;
+
+struct MXFFileSysData
+{
+    MXFMMapFile mmap_file;
+    int fd;
+    unsigned char *data;
+    int64_t size;
+    int64_t position;
+    int eof;
+    int64_t page_size;
+    int64_t advise_start;
+    int64_t advise_end;
+    int64_t willneed_end;
+};
+
+
+static void advise(MXFFileSysData *sys_data, int64_t start, int64_t end, int advice)
+{
+    if (end > sys_data->size)
+        end = sys_data->size;
+    start -= start % sys_data->page_size;
+    if (start >= end)
+        return;
+
+    if (madvise(&sys_data->data[start], (size_t)(end - start), advice) != 0)
+        log_warn("Failed to madvise memory-mapped file: %s\n", bmx_strerror(errno).c_str());
+}
+
+static void advise_willneed(MXFFileSysData *sys_data, int64_t position)
+{
+    // keep at least half the window ahead of the read position advised as needed
+    if (position < sys_data->advise_start ||
+        position >= sys_data->advise_end ||
+        sys_data->willneed_end >= sys_data->advise_end ||
+        sys_data->willneed_end - position >= WILLNEED_WINDOW_SIZE / 2)
+    {
+        return;
+    }
+
+    int64_t start = sys_data->willneed_end;
+    if (start < position)
+        start = position;
+    int64_t end = position + WILLNEED_WINDOW_SIZE;
+    if (end > sys_data->advise_end)
+        end = sys_data->advise_end;
+
+    advise(sys_data, start, end, MADV_WILLNEED);
+    sys_data->willneed_end = end;
+}
+
+
+static void mmap_file_close(MXFFileSysData *sys_data)
+{
+    if (sys_data->data) {
+        munmap(sys_data->data, (size_t)sys_data->size);
+        sys_data->data = 0;
+    }
+    if (sys_data->fd >= 0) {
+        close(sys_data->fd);
+        sys_data->fd = -1;
+    }
+}
+
+static uint32_t mmap_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
+{
+    if (sys_data->position >= sys_data->size) {
+        sys_data->eof = 1;
+        return 0;
+    }
+
+    uint32_t num_read = count;
+    if (num_read > sys_data->size - sys_data->position)
+        num_read = (uint32_t)(sys_data->size - sys_data->position);
+
+    advise_willneed(sys_data, sys_data->position);
+
+    memcpy(data, &sys_data->data[sys_data->position], num_read);
+    sys_data->position += num_read;
+    if (num_read < count)
+        sys_data->eof = 1;
+
+    return num_read;
+}
+
+static uint32_t mmap_file_write(MXFFileSysData *sys_data, const uint8_t *data, uint32_t count)
+{
+    (void)sys_data;
+    (void)data;
+    (void)count;
+    return 0;
+}
+
+static int mmap_file_getc(MXFFileSysData *sys_data)
+{
+    if (sys_data->position >= sys_data->size) {
+        sys_data->eof = 1;
+        return EOF;
+    }
+
+    return sys_data->data[sys_data->position++];
+}
+
+static int mmap_file_putc(MXFFileSysData *sys_data, int c)
+{
+    (void)sys_data;
+    (void)c;
+    return EOF;
+}
+
+static int mmap_file_eof(MXFFileSysData *sys_data)
+{
+    return sys_data->eof;
+}
+
+static int64_t mmap_file_tell(MXFFileSysData *sys_data)
+{
+    return sys_data->position;
+}
+
+static int mmap_file_is_seekable(MXFFileSysData *sys_data)
+{
+    (void)sys_data;
+    return 1;
+}
+
+static int64_t mmap_file_size(MXFFileSysData *sys_data)
+{
+    return sys_data->size;
+}
+
+static int mmap_file_seek(MXFFileSysData *sys_data, int64_t offset, int whence)
+{
+    int64_t new_position;
+    if (whence == SEEK_CUR)
+        new_position = sys_data->position + offset;
+    else if (whence == SEEK_SET)
+        new_position = offset;
+    else if (whence == SEEK_END)
+        new_position = sys_data->size + offset;
+    else
+        return 0;
+
+    if (new_position < 0)
+        return 0;
+
+    sys_data->position = new_position;
+    sys_data->eof = 0;
+
+    return 1;
+}
+
+static void free_mmap_file(MXFFileSysData *sys_data)
+{
+    delete sys_data;
+}
+
+
+bool bmx::mxf_mmap_is_supported()
+{
+    return true;
+}
+
+MXFFile* bmx::mxf_mmap_file_open_read(const string &filename)
+{
+    MXFFile *mmap_file = 0;
+    try
+    {
+        // using malloc() because mxf_file_close will call free()
+        BMX_CHECK((mmap_file = (MXFFile*)malloc(sizeof(MXFFile))) != 0);
+        memset(mmap_file, 0, sizeof(MXFFile));
+
+        mmap_file->sysData = new MXFFileSysData;
+        mmap_file->sysData->mmap_file.mxf_file = mmap_file;
+        mmap_file->sysData->fd = -1;
+        mmap_file->sysData->data = 0;
+        mmap_file->sysData->size = 0;
+        mmap_file->sysData->position = 0;
+        mmap_file->sysData->eof = 0;
+        mmap_file->sysData->page_size = sysconf(_SC_PAGESIZE);
+        mmap_file->sysData->advise_start = 0;
+        mmap_file->sysData->advise_end = 0;
+        mmap_file->sysData->willneed_end = 0;
+        if (mmap_file->sysData->page_size <= 0)
+            mmap_file->sysData->page_size = 4096;
+
+        mmap_file->close         = mmap_file_close;
+        mmap_file->read          = mmap_file_read;
+        mmap_file->write         = mmap_file_write;
+        mmap_file->get_char      = mmap_file_getc;
+        mmap_file->put_char      = mmap_file_putc;
+        mmap_file->eof           = mmap_file_eof;
+        mmap_file->seek          = mmap_file_seek;
+        mmap_file->tell          = mmap_file_tell;
+        mmap_file->is_seekable   = mmap_file_is_seekable;
+        mmap_file->size          = mmap_file_size;
+        mmap_file->free_sys_data = free_mmap_file;
+
+        MXFFileSysData *sys_data = mmap_file->sysData;
+
+        sys_data->fd = open(filename.c_str(), O_RDONLY);
+        if (sys_data->fd < 0) {
+            BMX_EXCEPTION(("Failed to open file '%s' for memory-mapped reading: %s",
+                           filename.c_str(), bmx_strerror(errno).c_str()));
+        }
+
+        struct stat st;
+        if (fstat(sys_data->fd, &st) != 0) {
+            BMX_EXCEPTION(("Failed to stat file '%s': %s",
+                           filename.c_str(), bmx_strerror(errno).c_str()));
+        }
+        if ((uint64_t)st.st_size > SIZE_MAX)
+            BMX_EXCEPTION(("File '%s' is too large to be memory-mapped", filename.c_str()));
+        sys_data->size = st.st_size;
+
+        if (sys_data->size > 0) {
+            void *data = mmap(0, (size_t)sys_data->size, PROT_READ, MAP_SHARED, sys_data->fd, 0);
+            if (data == MAP_FAILED) {
+                BMX_EXCEPTION(("Failed to memory-map file '%s': %s",
+                               filename.c_str(), bmx_strerror(errno).c_str()));
+            }
+            sys_data->data = (unsigned char*)data;
+
+            // the header metadata and index table segments are read before any read limits are known
+            advise(sys_data, 0, sys_data->size, MADV_SEQUENTIAL);
+        }
+
+        return mmap_file;
+    }
+    catch (...)
+    {
+        if (mmap_file)
+            mxf_file_close(&mmap_file);
+        throw;
+    }
+}
+
+bool bmx::mxf_mmap_file_advise_read_range(MXFFile *mxf_file, int64_t start, int64_t end)
+{
+    if (!mxf_file || mxf_file->read != mmap_file_read)
+        return false;
+
+    MXFFileSysData *sys_data = mxf_file->sysData;
+    if (sys_data->size == 0)
+        return true;
+
+    if (start < 0)
+        start = 0;
+    if (end > sys_data->size)
+        end = sys_data->size;
+
+    advise(sys_data, 0, sys_data->size, MADV_NORMAL);
+    if (start < end) {
+        advise(sys_data, start, end, MADV_SEQUENTIAL);
+        sys_data->advise_start = start;
+        sys_data->advise_end   = end;
+        sys_data->willneed_end = start;
+        advise_willneed(sys_data, start);
+    } else {
+        sys_data->advise_start = 0;
+        sys_data->advise_end   = 0;
+        sys_data->willneed_end = 0;
+    }
+
+    return true;
+}
+
+
+#else // !defined(_WIN32)
+
+
+#include <mxf/mxf.h>
+
+#include <bmx/MXFMMapFile.h>
+#include <bmx/Logging.h>
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+bool bmx::mxf_mmap_is_supported()
+{
+    return false;
+}
+
+MXFFile* bmx::mxf_mmap_file_open_read(const string &filename)
+{
+    (void)filename;
+    BMX_EXCEPTION(("POSIX memory-mapped file access is not supported in this build"));
+}
+
+bool bmx::mxf_mmap_file_advise_read_range(MXFFile *mxf_file, int64_t start, int64_t end)
+{
+    (void)mxf_file;
+    (void)start;
+    (void)end;
+    return false;
+}
+
+
+#endif
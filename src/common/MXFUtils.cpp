@@ -153,3 +153,33 @@ MXFDataDefEnum bmx::convert_essence_type_to_data_def(EssenceType essence_type)
         default:              return MXF_UNKNOWN_DDEF;
     }
 }
+
+bool bmx::get_kl(const unsigned char *data, uint64_t size, mxfKey *key, uint8_t *llen, uint64_t *len)
+{
+    if (size < mxfKey_extlen + 1)
+        return false;
+
+    mxf_get_ul(data, (mxfUL*)key);
+
+    const unsigned char *ber = &data[mxfKey_extlen];
+    if (ber[0] < 0x80) {
+        *llen = 1;
+        *len  = ber[0];
+        return true;
+    }
+
+    uint8_t num_bytes = ber[0] & 0x7f;
+    if (num_bytes == 0 || num_bytes > 8)
+        BMX_EXCEPTION(("Invalid BER length byte 0x%02x", ber[0]));
+    if (size < (uint64_t)(mxfKey_extlen + 1 + num_bytes))
+        return false;
+
+    uint64_t value = 0;
+    uint8_t i;
+    for (i = 1; i <= num_bytes; i++)
+        value = (value << 8) | ber[i];
+
+    *llen = num_bytes + 1;
+    *len  = value;
+    return true;
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <mxf/mxf.h>
+
+#include <bmx/MXFWriteBehindFile.h>
+#include <bmx/ByteArray.h>
+#include <bmx/Logging.h>
+#include <bmx/BMXException.h>
+
+
+using namespace std;
+using namespace bmx;
+
+
+struct MXFFileSysData
+{
+    MXFFile *target;
+    uint32_t buffer_size;
+    uint32_t num_buffers;
+    int64_t position;
+
+    ByteArray *buffer;          // buffer being filled by the caller
+    uint32_t buffer_limit;
+
+    mutex buffers_mutex;
+    condition_variable write_cond;
+    condition_variable done_cond;
+    deque<ByteArray*> write_buffers;
+    vector<ByteArray*> free_buffers;
+    uint32_t num_allocated;
+    bool writing;
+    bool write_error;
+    bool stop;
+
+    thread writer;
+};
+
+
+static void write_thread(MXFFileSysData *sys_data)
+{
+    unique_lock<mutex> lock(sys_data->buffers_mutex);
+    while (true) {
+        while (sys_data->write_buffers.empty() && !sys_data->stop)
+            sys_data->write_cond.wait(lock);
+        if (sys_data->write_buffers.empty())
+            break;
+
+        ByteArray *buffer = sys_data->write_buffers.front();
+        sys_data->write_buffers.pop_front();
+        sys_data->writing = true;
+        bool write_error = sys_data->write_error;
+        lock.unlock();
+
+        // the data is dropped once a write has failed
+        if (!write_error)
+            write_error = (mxf_file_write(sys_data->target, buffer->GetBytes(), buffer->GetSize()) != buffer->GetSize());
+
+        lock.lock();
+        if (write_error)
+            sys_data->write_error = true;
+        sys_data->writing = false;
+        buffer->SetSize(0);
+        sys_data->free_buffers.push_back(buffer);
+        sys_data->done_cond.notify_all();
+    }
+}
+
+static bool get_free_buffer(MXFFileSysData *sys_data)
+{
+    unique_lock<mutex> lock(sys_data->buffers_mutex);
+    while (sys_data->free_buffers.empty() &&
+           sys_data->num_allocated >= sys_data->num_buffers &&
+           !sys_data->write_error)
+    {
+        sys_data->done_cond.wait(lock);
+    }
+    if (sys_data->write_error)
+        return false;
+
+    if (sys_data->free_buffers.empty()) {
+        sys_data->buffer = new ByteArray(sys_data->buffer_size);
+        sys_data->num_allocated++;
+    } else {
+        sys_data->buffer = sys_data->free_buffers.back();
+        sys_data->free_buffers.pop_back();
+    }
+
+    // the first buffer after a seek is limited so that the following writes are aligned
+    sys_data->buffer_limit = sys_data->buffer_size - (uint32_t)(sys_data->position % sys_data->buffer_size);
+
+    return true;
+}
+
+static void queue_buffer(MXFFileSysData *sys_data)
+{
+    {
+        lock_guard<mutex> lock(sys_data->buffers_mutex);
+        if (sys_data->buffer->GetSize() > 0)
+            sys_data->write_buffers.push_back(sys_data->buffer);
+        else
+            sys_data->free_buffers.push_back(sys_data->buffer);
+        sys_data->buffer = 0;
+    }
+    sys_data->write_cond.notify_one();
+}
+
+static bool flush_buffers(MXFFileSysData *sys_data)
+{
+    if (sys_data->buffer)
+        queue_buffer(sys_data);
+
+    unique_lock<mutex> lock(sys_data->buffers_mutex);
+    while (!sys_data->write_buffers.empty() || sys_data->writing)
+        sys_data->done_cond.wait(lock);
+
+    return !sys_data->write_error;
+}
+
+
+static void write_behind_file_close(MXFFileSysData *sys_data)
+{
+    if (sys_data->writer.joinable()) {
+        if (!flush_buffers(sys_data))
+            log_error("Failed to write buffered data to file\n");
+
+        {
+            lock_guard<mutex> lock(sys_data->buffers_mutex);
+            sys_data->stop = true;
+        }
+        sys_data->write_cond.notify_one();
+        sys_data->writer.join();
+    }
+
+    if (sys_data->target)
+        mxf_file_close(&sys_data->target);
+}
+
+static uint32_t write_behind_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
+{
+    if (!flush_buffers(sys_data))
+        return 0;
+
+    uint32_t result = mxf_file_read(sys_data->target, data, count);
+    sys_data->position += result;
+
+    return result;
+}
+
+static uint32_t write_behind_file_write(MXFFileSysData *sys_data, const uint8_t *data, uint32_t count)
+{
+    const uint8_t *data_ptr = data;
+    uint32_t rem_count = count;
+    while (rem_count > 0) {
+        if (!sys_data->buffer && !get_free_buffer(sys_data))
+            break;
+
+        uint32_t append_count = sys_data->buffer_limit - sys_data->buffer->GetSize();
+        if (append_count > rem_count)
+            append_count = rem_count;
+        sys_data->buffer->Append(data_ptr, append_count);
+        sys_data->position += append_count;
+        data_ptr           += append_count;
+        rem_count          -= append_count;
+
+        if (sys_data->buffer->GetSize() >= sys_data->buffer_limit)
+            queue_buffer(sys_data);
+    }
+
+    return count - rem_count;
+}
+
+static int write_behind_file_getc(MXFFileSysData *sys_data)
+{
+    if (!flush_buffers(sys_data))
+        return EOF;
+
+    int result = mxf_file_getc(sys_data->target);
+    if (result != EOF)
+        sys_data->position++;
+
+    return result;
+}
+
+static int write_behind_file_putc(MXFFileSysData *sys_data, int c)
+{
+    uint8_t byte = (uint8_t)c;
+    if (write_behind_file_write(sys_data, &byte, 1) != 1)
+        return EOF;
+
+    return c;
+}
+
+static int write_behind_file_eof(MXFFileSysData *sys_data)
+{
+    if (!flush_buffers(sys_data))
+        return 1;
+
+    return mxf_file_eof(sys_data->target);
+}
+
+static int write_behind_file_seek(MXFFileSysData *sys_data, int64_t offset, int whence)
+{
+    if (!flush_buffers(sys_data))
+        return 0;
+
+    int result = mxf_file_seek(sys_data->target, offset, whence);
+    if (result)
+        sys_data->position = mxf_file_tell(sys_data->target);
+
+    return result;
+}
+
+static int64_t write_behind_file_tell(MXFFileSysData *sys_data)
+{
+    return sys_data->position;
+}
+
+static int write_behind_file_is_seekable(MXFFileSysData *sys_data)
+{
+    return mxf_file_is_seekable(sys_data->target);
+}
+
+static int64_t write_behind_file_size(MXFFileSysData *sys_data)
+{
+    if (!flush_buffers(sys_data))
+        return -1;
+
+    return mxf_file_size(sys_data->target);
+}
+
+
+static void free_write_behind_file(MXFFileSysData *sys_data)
+{
+    if (sys_data) {
+        delete sys_data->buffer;
+        size_t i;
+        for (i = 0; i < sys_data->write_buffers.size(); i++)
+            delete sys_data->write_buffers[i];
+        for (i = 0; i < sys_data->free_buffers.size(); i++)
+            delete sys_data->free_buffers[i];
+        delete sys_data;
+    }
+}
+
+
+MXFFile* bmx::mxf_write_behind_file_open(MXFFile *target, uint32_t buffer_size, uint32_t num_buffers)
+{
+    BMX_CHECK(buffer_size > 0 && num_buffers > 0);
+
+    MXFFile *write_behind_file = 0;
+    try
+    {
+        // using malloc() because mxf_file_close will call free()
+        BMX_CHECK((write_behind_file = (MXFFile*)malloc(sizeof(MXFFile))) != 0);
+        memset(write_behind_file, 0, sizeof(MXFFile));
+
+        write_behind_file->sysData = new MXFFileSysData;
+        write_behind_file->sysData->target        = target;
+        write_behind_file->sysData->buffer_size   = buffer_size;
+        write_behind_file->sysData->num_buffers   = num_buffers;
+        write_behind_file->sysData->position      = mxf_file_tell(target);
+        write_behind_file->sysData->buffer        = 0;
+        write_behind_file->sysData->buffer_limit  = 0;
+        write_behind_file->sysData->num_allocated = 0;
+        write_behind_file->sysData->writing       = false;
+        write_behind_file->sysData->write_error   = false;
+        write_behind_file->sysData->stop          = false;
+
+        write_behind_file->close         = write_behind_file_close;
+        write_behind_file->read          = write_behind_file_read;
+        write_behind_file->write         = write_behind_file_write;
+        write_behind_file->get_char      = write_behind_file_getc;
+        write_behind_file->put_char      = write_behind_file_putc;
+        write_behind_file->eof           = write_behind_file_eof;
+        write_behind_file->seek          = write_behind_file_seek;
+        write_behind_file->tell          = write_behind_file_tell;
+        write_behind_file->is_seekable   = write_behind_file_is_seekable;
+        write_behind_file->size          = write_behind_file_size;
+        write_behind_file->free_sys_data = free_write_behind_file;
+
+        write_behind_file->minLLen       = target->minLLen;
+        write_behind_file->runinLen      = target->runinLen;
+
+        write_behind_file->sysData->writer = thread(write_thread, write_behind_file->sysData);
+
+        return write_behind_file;
+    }
+    catch (...)
+    {
+        if (write_behind_file) {
+            if (write_behind_file->sysData)
+                write_behind_file->sysData->target = 0; // ownership returns to the caller
+            mxf_file_close(&write_behind_file);
+        }
+        throw;
+    }
+}
+
+bool bmx::mxf_write_behind_file_flush(MXFFile *mxf_file)
+{
+    if (mxf_file->write != write_behind_file_write)
+        return true;
+
+    return flush_buffers(mxf_file->sysData);
+}
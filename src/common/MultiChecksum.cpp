@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+
+#include <bmx/MultiChecksum.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+MultiChecksum::MultiChecksum(const vector<ChecksumType> &types, uint32_t chunk_size, uint32_t num_buffers)
+{
+    BMX_CHECK(!types.empty());
+    BMX_CHECK(chunk_size > 0 && num_buffers > 0);
+
+    mChunkSize = chunk_size;
+    mParallel = (types.size() > 1);
+    mFinal = false;
+    mFillChunk = 0;
+    mSubmitCount = 0;
+    mStop = false;
+
+    try
+    {
+        size_t i;
+        for (i = 0; i < types.size(); i++) {
+            Lane *lane = new Lane;
+            lane->checksum.Init(types[i]);
+            lane->processed_count = 0;
+            mLanes.push_back(lane);
+        }
+
+        // the single type case allocates its chunk in GetBuffer if needed
+        if (mParallel) {
+            for (i = 0; i < num_buffers; i++) {
+                Chunk chunk;
+                chunk.data = new unsigned char[mChunkSize];
+                chunk.size = 0;
+                mChunks.push_back(chunk);
+            }
+
+            for (i = 0; i < mLanes.size(); i++)
+                mLanes[i]->thread = thread(&MultiChecksum::LaneThread, this, mLanes[i]);
+        }
+    }
+    catch (...)
+    {
+        StopLanes();
+        size_t i;
+        for (i = 0; i < mLanes.size(); i++)
+            delete mLanes[i];
+        for (i = 0; i < mChunks.size(); i++)
+            delete [] mChunks[i].data;
+        throw;
+    }
+}
+
+MultiChecksum::~MultiChecksum()
+{
+    StopLanes();
+
+    size_t i;
+    for (i = 0; i < mLanes.size(); i++)
+        delete mLanes[i];
+    for (i = 0; i < mChunks.size(); i++)
+        delete [] mChunks[i].data;
+}
+
+void MultiChecksum::Update(const unsigned char *data, uint32_t size)
+{
+    BMX_CHECK(!mFinal);
+
+    if (!mParallel) {
+        mLanes[0]->checksum.Update(data, size);
+        return;
+    }
+
+    uint32_t offset = 0;
+    while (offset < size) {
+        if (!mFillChunk)
+            AcquireFillChunk();
+
+        uint32_t count = mChunkSize - mFillChunk->size;
+        if (count > size - offset)
+            count = size - offset;
+        memcpy(&mFillChunk->data[mFillChunk->size], &data[offset], count);
+        mFillChunk->size += count;
+        offset += count;
+
+        if (mFillChunk->size == mChunkSize)
+            SubmitFillChunk();
+    }
+}
+
+unsigned char* MultiChecksum::GetBuffer(uint32_t *size)
+{
+    BMX_CHECK(!mFinal);
+
+    if (!mParallel) {
+        if (mChunks.empty()) {
+            Chunk chunk;
+            chunk.data = new unsigned char[mChunkSize];
+            chunk.size = 0;
+            mChunks.push_back(chunk);
+        }
+        *size = mChunkSize;
+        return mChunks[0].data;
+    }
+
+    if (!mFillChunk)
+        AcquireFillChunk();
+
+    *size = mChunkSize - mFillChunk->size;
+    return &mFillChunk->data[mFillChunk->size];
+}
+
+void MultiChecksum::CommitBuffer(uint32_t size)
+{
+    if (!mParallel) {
+        BMX_CHECK(!mChunks.empty() && size <= mChunkSize);
+        mLanes[0]->checksum.Update(mChunks[0].data, size);
+        return;
+    }
+
+    BMX_CHECK(mFillChunk && mFillChunk->size + size <= mChunkSize);
+    mFillChunk->size += size;
+    if (mFillChunk->size == mChunkSize)
+        SubmitFillChunk();
+}
+
+void MultiChecksum::Final()
+{
+    if (mFinal)
+        return;
+
+    if (mParallel) {
+        if (mFillChunk && mFillChunk->size > 0)
+            SubmitFillChunk();
+        StopLanes();
+    }
+
+    size_t i;
+    for (i = 0; i < mLanes.size(); i++)
+        mLanes[i]->checksum.Final();
+
+    mFinal = true;
+}
+
+ChecksumType MultiChecksum::GetType(size_t index) const
+{
+    BMX_CHECK(index < mLanes.size());
+    return mLanes[index]->checksum.GetType();
+}
+
+bool MultiChecksum::HaveType(ChecksumType type) const
+{
+    size_t i;
+    for (i = 0; i < mLanes.size(); i++) {
+        if (mLanes[i]->checksum.GetType() == type)
+            return true;
+    }
+
+    return false;
+}
+
+const Checksum* MultiChecksum::GetChecksum(ChecksumType type) const
+{
+    size_t i;
+    for (i = 0; i < mLanes.size(); i++) {
+        if (mLanes[i]->checksum.GetType() == type)
+            return &mLanes[i]->checksum;
+    }
+
+    BMX_EXCEPTION(("Checksum type %d was not calculated", type));
+}
+
+void MultiChecksum::LaneThread(Lane *lane)
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && lane->processed_count == mSubmitCount)
+            mSubmitCond.wait(lock);
+        if (lane->processed_count == mSubmitCount)
+            break;
+
+        const Chunk &chunk = mChunks[lane->processed_count % mChunks.size()];
+        lock.unlock();
+        lane->checksum.Update(chunk.data, chunk.size);
+        lock.lock();
+
+        lane->processed_count++;
+        mProcessedCond.notify_all();
+    }
+}
+
+void MultiChecksum::AcquireFillChunk()
+{
+    unique_lock<mutex> lock(mMutex);
+
+    // wait until every lane has processed the chunk that previously used the slot
+    size_t i;
+    for (i = 0; i < mLanes.size(); i++) {
+        while (mLanes[i]->processed_count + mChunks.size() <= mSubmitCount)
+            mProcessedCond.wait(lock);
+    }
+
+    mFillChunk = &mChunks[mSubmitCount % mChunks.size()];
+    mFillChunk->size = 0;
+}
+
+void MultiChecksum::SubmitFillChunk()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mSubmitCount++;
+        mFillChunk = 0;
+    }
+    mSubmitCond.notify_all();
+}
+
+void MultiChecksum::StopLanes()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mSubmitCond.notify_all();
+
+    size_t i;
+    for (i = 0; i < mLanes.size(); i++) {
+        if (mLanes[i]->thread.joinable())
+            mLanes[i]->thread.join();
+    }
+}
@@ -40,6 +40,8 @@
 // * Changed 'unsigned long' to 'uint32_t' (otherwise calculation is
 //   wrong)
 // * Changed sha1_update 'len' parameter type to 'uint32_t'
+// * Use a stack workspace in sha1_transform rather than a static to allow concurrent use
+// * Added an x86 SHA extensions transform, used when supported by the CPU
 
 
 #ifdef HAVE_CONFIG_H
@@ -50,12 +52,26 @@
 #include <cstring>
 #include <cerrno>
 
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && \
+        (defined(_MSC_VER) || defined(__clang__) || \
+            (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define BMX_SHA_NI_SHA1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define BMX_TARGET_SHA_NI
+#else
+#define BMX_TARGET_SHA_NI   __attribute__((target("sha,ssse3,sse4.1")))
+#endif
+#endif
+
 #include <bmx/SHA1.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
 using namespace std;
+using namespace bmx;
 
 
 #define SHA1HANDSOFF /* Copies data before messing with it. */
@@ -93,8 +109,8 @@ typedef union {
 } CHAR64LONG16;
 CHAR64LONG16* block;
 #ifdef SHA1HANDSOFF
-static unsigned char workspace[64];
-    block = (CHAR64LONG16*)workspace;
+CHAR64LONG16 workspace;
+    block = &workspace;
     memcpy(block, buffer, 64);
 #else
     block = (CHAR64LONG16*)buffer;
@@ -137,6 +153,93 @@ static unsigned char workspace[64];
 }
 
 
+#if defined(BMX_SHA_NI_SHA1)
+
+/* Hash 512-bit blocks using the x86 SHA extensions. Each group of 4 rounds uses the message words in msg[g % 4]
+   and the message schedule for the following groups is computed in parallel with the rounds. */
+
+#define SHA_NI_ROUNDS(g, e_cur, e_next, func)                                                  \
+    e_cur = _mm_sha1nexte_epu32(e_cur, msg[(g) & 3]);                                         \
+    e_next = abcd;                                                                             \
+    if ((g) >= 3 && (g) <= 18)                                                                 \
+        msg[((g) + 1) & 3] = _mm_sha1msg2_epu32(msg[((g) + 1) & 3], msg[(g) & 3]);            \
+    abcd = _mm_sha1rnds4_epu32(abcd, e_cur, func);                                             \
+    if ((g) >= 1 && (g) <= 16)                                                                 \
+        msg[((g) + 3) & 3] = _mm_sha1msg1_epu32(msg[((g) + 3) & 3], msg[(g) & 3]);            \
+    if ((g) >= 2 && (g) <= 17)                                                                 \
+        msg[((g) + 2) & 3] = _mm_xor_si128(msg[((g) + 2) & 3], msg[(g) & 3]);
+
+BMX_TARGET_SHA_NI
+static void sha_ni_sha1_transform(uint32_t state[5], const unsigned char *data, uint32_t num_blocks)
+{
+    const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+    __m128i abcd, abcd_save, e0, e0_save, e1;
+    __m128i msg[4];
+    int i;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1b);
+    e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    while (num_blocks > 0) {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        for (i = 0; i < 4; i++)
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&data[i * 16]), byte_swap);
+
+        e0 = _mm_add_epi32(e0, msg[0]);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        SHA_NI_ROUNDS( 1, e1, e0, 0);
+        SHA_NI_ROUNDS( 2, e0, e1, 0);
+        SHA_NI_ROUNDS( 3, e1, e0, 0);
+        SHA_NI_ROUNDS( 4, e0, e1, 0);
+        SHA_NI_ROUNDS( 5, e1, e0, 1);
+        SHA_NI_ROUNDS( 6, e0, e1, 1);
+        SHA_NI_ROUNDS( 7, e1, e0, 1);
+        SHA_NI_ROUNDS( 8, e0, e1, 1);
+        SHA_NI_ROUNDS( 9, e1, e0, 1);
+        SHA_NI_ROUNDS(10, e0, e1, 2);
+        SHA_NI_ROUNDS(11, e1, e0, 2);
+        SHA_NI_ROUNDS(12, e0, e1, 2);
+        SHA_NI_ROUNDS(13, e1, e0, 2);
+        SHA_NI_ROUNDS(14, e0, e1, 2);
+        SHA_NI_ROUNDS(15, e1, e0, 3);
+        SHA_NI_ROUNDS(16, e0, e1, 3);
+        SHA_NI_ROUNDS(17, e1, e0, 3);
+        SHA_NI_ROUNDS(18, e0, e1, 3);
+        SHA_NI_ROUNDS(19, e1, e0, 3);
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+
+        data += 64;
+        num_blocks--;
+    }
+
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(e0, 12));
+}
+
+#endif // BMX_SHA_NI_SHA1
+
+
+static void sha1_transform_blocks(uint32_t state[5], const unsigned char *data, uint32_t num_blocks)
+{
+#if defined(BMX_SHA_NI_SHA1)
+    if (cpu_has_feature(CPU_FEATURE_SHA) && cpu_has_feature(CPU_FEATURE_SSE41)) {
+        sha_ni_sha1_transform(state, data, num_blocks);
+        return;
+    }
+#endif
+
+    uint32_t i;
+    for (i = 0; i < num_blocks; i++)
+        sha1_transform(state, &data[i * 64]);
+}
+
+
 /* sha1_init - Initialize new context */
 
 void bmx::sha1_init(SHA1Context *context)
@@ -162,9 +265,10 @@ size_t i, j;
     context->count[1] += (len >> 29);
     if ((j + len) > 63) {
         memcpy(&context->buffer[j], data, (i = 64-j));
-        sha1_transform(context->state, context->buffer);
-        for ( ; i + 63 < len; i += 64) {
-            sha1_transform(context->state, &data[i]);
+        sha1_transform_blocks(context->state, context->buffer, 1);
+        if (i + 63 < len) {
+            sha1_transform_blocks(context->state, &data[i], (uint32_t)((len - i) / 64));
+            i += (len - i) & ~(size_t)63;
         }
         j = 0;
     }
@@ -199,9 +303,6 @@ unsigned char finalcount[8];
     memset(context->state, 0, 20);
     memset(context->count, 0, 8);
     memset(&finalcount, 0, 8);
-#ifdef SHA1HANDSOFF  /* make sha1_transform overwrite it's own static vars */
-    sha1_transform(context->state, context->buffer);
-#endif
 }
 
 string bmx::sha1_digest_str(const unsigned char digest[20])
@@ -254,7 +355,7 @@ string bmx::sha1_calc_file(FILE *file)
             sha1_update(&context, buffer, (uint32_t)num_read);
     }
 
-    unsigned char digest[16];
+    unsigned char digest[20];
     sha1_final(digest, &context);
 
     return sha1_digest_str(digest);
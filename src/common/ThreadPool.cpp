@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <bmx/ThreadPool.h>
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+ThreadPool::ThreadPool(uint32_t num_threads)
+{
+    mTask = 0;
+    mNumTasks = 0;
+    mNextTask = 0;
+    mNumDone = 0;
+    mExceptionIndex = 0;
+    mStop = false;
+
+    uint32_t i;
+    for (i = 1; i < num_threads; i++)
+        mThreads.push_back(thread(&ThreadPool::WorkerThread, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mTaskCond.notify_all();
+
+    size_t i;
+    for (i = 0; i < mThreads.size(); i++)
+        mThreads[i].join();
+}
+
+void ThreadPool::Run(size_t num_tasks, const function<void(size_t)> &task)
+{
+    if (num_tasks == 0)
+        return;
+
+    if (mThreads.empty() || num_tasks == 1) {
+        size_t i;
+        for (i = 0; i < num_tasks; i++)
+            task(i);
+        return;
+    }
+
+    exception_ptr task_exception;
+    {
+        unique_lock<mutex> lock(mMutex);
+        BMX_ASSERT(!mTask);
+        mTask           = &task;
+        mNumTasks       = num_tasks;
+        mNextTask       = 0;
+        mNumDone        = 0;
+        mException      = exception_ptr();
+        mExceptionIndex = 0;
+        mTaskCond.notify_all();
+
+        RunTasks(lock);
+        while (mNumDone < mNumTasks)
+            mDoneCond.wait(lock);
+
+        task_exception = mException;
+        mException = exception_ptr();
+        mTask      = 0;
+        mNumTasks  = 0;
+        mNextTask  = 0;
+    }
+
+    if (task_exception)
+        rethrow_exception(task_exception);
+}
+
+void ThreadPool::WorkerThread()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && mNextTask >= mNumTasks)
+            mTaskCond.wait(lock);
+        if (mStop)
+            break;
+
+        RunTasks(lock);
+    }
+}
+
+void ThreadPool::RunTasks(unique_lock<mutex> &lock)
+{
+    while (mNextTask < mNumTasks) {
+        size_t index = mNextTask++;
+        const function<void(size_t)> *task = mTask;
+        lock.unlock();
+
+        exception_ptr task_exception;
+        try
+        {
+            (*task)(index);
+        }
+        catch (...)
+        {
+            task_exception = current_exception();
+        }
+
+        lock.lock();
+        if (task_exception && (!mException || index < mExceptionIndex)) {
+            mException      = task_exception;
+            mExceptionIndex = index;
+        }
+        mNumDone++;
+        if (mNumDone == mNumTasks)
+            mDoneCond.notify_all();
+    }
+}
@@ -35,13 +35,211 @@
 
 #define __STDC_LIMIT_MACROS
 
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BMX_SSE2_MARKER_SEARCH
+#include <emmintrin.h>
+#if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define BMX_AVX2_MARKER_SEARCH
+#include <immintrin.h>
+#endif
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(BMX_AVX2_MARKER_SEARCH) && !defined(_MSC_VER)
+#define BMX_TARGET_AVX2     __attribute__((target("avx2")))
+#else
+#define BMX_TARGET_AVX2
+#endif
+
 #include "EssenceParserUtils.h"
+#include <bmx/essence_parser/EssenceParser.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
 using namespace bmx;
 
 
+typedef uint32_t (*FindMarkerFunc)(const unsigned char *data, uint32_t data_size,
+                                   const unsigned char *marker, uint32_t marker_size);
+
+static const unsigned char START_CODE_PREFIX[] = {0x00, 0x00, 0x01};
+
+
+
+static uint32_t scalar_find_marker(const unsigned char *data, uint32_t data_size,
+                                   const unsigned char *marker, uint32_t marker_size)
+{
+    // search for the last marker byte, which is the least common byte in start code prefixes
+    uint32_t last = marker_size - 1;
+    uint32_t offset = 0;
+    while (offset + marker_size <= data_size) {
+        const unsigned char *last_byte = (const unsigned char*)memchr(&data[offset + last], marker[last],
+                                                                      data_size - (offset + last));
+        if (!last_byte)
+            break;
+        offset = (uint32_t)(last_byte - data) - last;
+        if (memcmp(&data[offset], marker, last) == 0)
+            return offset;
+        offset++;
+    }
+
+    return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+
+#if defined(BMX_SSE2_MARKER_SEARCH)
+
+static inline uint32_t lowest_bit_index(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz(mask);
+#endif
+}
+
+// candidate positions are where both the first and last marker bytes match and the bytes in between are then
+// compared
+
+static uint32_t sse2_find_marker(const unsigned char *data, uint32_t data_size,
+                                 const unsigned char *marker, uint32_t marker_size)
+{
+    uint32_t last = marker_size - 1;
+    const __m128i first_bytes = _mm_set1_epi8((char)marker[0]);
+    const __m128i last_bytes  = _mm_set1_epi8((char)marker[last]);
+
+    uint32_t offset = 0;
+    while (data_size >= 16 + last && offset <= data_size - (16 + last)) {
+        __m128i first_eq = _mm_cmpeq_epi8(first_bytes, _mm_loadu_si128((const __m128i*)&data[offset]));
+        __m128i last_eq  = _mm_cmpeq_epi8(last_bytes,  _mm_loadu_si128((const __m128i*)&data[offset + last]));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(first_eq, last_eq));
+        while (mask) {
+            uint32_t candidate = offset + lowest_bit_index(mask);
+            if (memcmp(&data[candidate + 1], &marker[1], last - 1) == 0)
+                return candidate;
+            mask &= mask - 1;
+        }
+        offset += 16;
+    }
+
+    uint32_t result = scalar_find_marker(&data[offset], data_size - offset, marker, marker_size);
+    if (result == ESSENCE_PARSER_NULL_OFFSET)
+        return result;
+    return offset + result;
+}
+
+#endif // BMX_SSE2_MARKER_SEARCH
+
+
+#if defined(BMX_AVX2_MARKER_SEARCH)
+
+BMX_TARGET_AVX2
+static uint32_t avx2_find_marker(const unsigned char *data, uint32_t data_size,
+                                 const unsigned char *marker, uint32_t marker_size)
+{
+    uint32_t last = marker_size - 1;
+    const __m256i first_bytes = _mm256_set1_epi8((char)marker[0]);
+    const __m256i last_bytes  = _mm256_set1_epi8((char)marker[last]);
+
+    uint32_t offset = 0;
+    while (data_size >= 32 + last && offset <= data_size - (32 + last)) {
+        __m256i first_eq = _mm256_cmpeq_epi8(first_bytes, _mm256_loadu_si256((const __m256i*)&data[offset]));
+        __m256i last_eq  = _mm256_cmpeq_epi8(last_bytes,  _mm256_loadu_si256((const __m256i*)&data[offset + last]));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(first_eq, last_eq));
+        while (mask) {
+            uint32_t candidate = offset + lowest_bit_index(mask);
+            if (memcmp(&data[candidate + 1], &marker[1], last - 1) == 0)
+                return candidate;
+            mask &= mask - 1;
+        }
+        offset += 32;
+    }
+
+    uint32_t result = sse2_find_marker(&data[offset], data_size - offset, marker, marker_size);
+    if (result == ESSENCE_PARSER_NULL_OFFSET)
+        return result;
+    return offset + result;
+}
+
+#endif // BMX_AVX2_MARKER_SEARCH
+
+
+static MarkerSearchISA detect_marker_search_isa()
+{
+    if (marker_search_isa_supported(AVX2_MARKER_SEARCH_ISA))
+        return AVX2_MARKER_SEARCH_ISA;
+    if (marker_search_isa_supported(SSE2_MARKER_SEARCH_ISA))
+        return SSE2_MARKER_SEARCH_ISA;
+    return SCALAR_MARKER_SEARCH_ISA;
+}
+
+static FindMarkerFunc get_find_marker_func(MarkerSearchISA isa)
+{
+    switch (isa)
+    {
+#if defined(BMX_AVX2_MARKER_SEARCH)
+        case AVX2_MARKER_SEARCH_ISA:
+            return avx2_find_marker;
+#endif
+#if defined(BMX_SSE2_MARKER_SEARCH)
+        case SSE2_MARKER_SEARCH_ISA:
+            return sse2_find_marker;
+#endif
+        default:
+            return scalar_find_marker;
+    }
+}
+
+static MarkerSearchISA g_marker_search_isa = detect_marker_search_isa();
+static FindMarkerFunc g_find_marker = get_find_marker_func(g_marker_search_isa);
+
+
+
+bool bmx::marker_search_isa_supported(MarkerSearchISA isa)
+{
+    switch (isa)
+    {
+        case SCALAR_MARKER_SEARCH_ISA:
+            return true;
+        case SSE2_MARKER_SEARCH_ISA:
+#if defined(BMX_SSE2_MARKER_SEARCH)
+            return cpu_has_feature(CPU_FEATURE_SSE2);
+#else
+            return false;
+#endif
+        case AVX2_MARKER_SEARCH_ISA:
+#if defined(BMX_AVX2_MARKER_SEARCH)
+            return cpu_has_feature(CPU_FEATURE_SSE2) && cpu_has_feature(CPU_FEATURE_AVX2);
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+bool bmx::set_marker_search_isa(MarkerSearchISA isa)
+{
+    if (!marker_search_isa_supported(isa))
+        return false;
+
+    g_marker_search_isa = isa;
+    g_find_marker = get_find_marker_func(isa);
+    return true;
+}
+
+MarkerSearchISA bmx::get_marker_search_isa()
+{
+    return g_marker_search_isa;
+}
+
 
 uint32_t bmx::get_bits(const unsigned char *data, uint32_t data_size, uint32_t bit_offset, uint8_t num_bits)
 {
@@ -63,3 +261,28 @@ uint32_t bmx::get_bits(const unsigned char *data, uint32_t data_size, uint32_t b
     return (uint32_t)buffer;
 }
 
+uint32_t bmx::find_marker(const unsigned char *data, uint32_t data_size, const unsigned char *marker,
+                          uint32_t marker_size)
+{
+    BMX_ASSERT(marker_size > 0);
+
+    if (data_size < marker_size) {
+        return ESSENCE_PARSER_NULL_OFFSET;
+    } else if (marker_size == 1) {
+        const unsigned char *byte = (const unsigned char*)memchr(data, marker[0], data_size);
+        if (byte)
+            return (uint32_t)(byte - data);
+        else
+            return ESSENCE_PARSER_NULL_OFFSET;
+    }
+
+    return g_find_marker(data, data_size, marker, marker_size);
+}
+
+uint32_t bmx::find_start_code_prefix(const unsigned char *data, uint32_t data_size)
+{
+    // exclude the last byte so that the prefix is followed by the start code value
+    if (data_size == 0)
+        return ESSENCE_PARSER_NULL_OFFSET;
+    return find_marker(data, data_size - 1, START_CODE_PREFIX, sizeof(START_CODE_PREFIX));
+}
@@ -41,8 +41,30 @@ namespace bmx
 {
 
 
+typedef enum
+{
+    SCALAR_MARKER_SEARCH_ISA,
+    SSE2_MARKER_SEARCH_ISA,
+    AVX2_MARKER_SEARCH_ISA,
+} MarkerSearchISA;
+
+// the default is the best instruction set supported by the build and the CPU
+// the scalar code is always supported and gives the same results
+bool marker_search_isa_supported(MarkerSearchISA isa);
+bool set_marker_search_isa(MarkerSearchISA isa);
+MarkerSearchISA get_marker_search_isa();
+
+
 uint32_t get_bits(const unsigned char *data, uint32_t data_size, uint32_t bit_offset, uint8_t num_bits);
 
+// returns the offset of the first occurrence of marker in data or ESSENCE_PARSER_NULL_OFFSET if not found.
+// SSE2 or AVX2 is used if supported by the CPU
+uint32_t find_marker(const unsigned char *data, uint32_t data_size, const unsigned char *marker, uint32_t marker_size);
+
+// returns the offset of the first 0x000001 start code prefix in data that is followed by at least 1 byte,
+// i.e. the start code value, or ESSENCE_PARSER_NULL_OFFSET if not found
+uint32_t find_start_code_prefix(const unsigned char *data, uint32_t data_size);
+
 
 
 };
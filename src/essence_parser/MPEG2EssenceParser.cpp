@@ -50,6 +50,9 @@ using namespace bmx;
 #define MIN_SLICE_START_CODE    0x00000101
 #define MAX_SLICE_START_CODE    0x000001af
 
+#define START_CODE(data)        ((((uint32_t)(data)[0]) << 24) | (((uint32_t)(data)[1]) << 16) | \
+                                 (((uint32_t)(data)[2]) << 8)  |  ((uint32_t)(data)[3]))
+
 
 typedef struct
 {
@@ -120,15 +123,19 @@ uint32_t MPEG2EssenceParser::ParseFrameStart(const unsigned char *data, uint32_t
 {
     BMX_CHECK(data_size != ESSENCE_PARSER_NULL_OFFSET);
 
-    uint32_t state = 0xffffffff;
     uint32_t offset = 0;
     while (offset < data_size) {
-        state = (state << 8) | data[offset];
-        if (state == SEQUENCE_HEADER_CODE ||
-            state == GROUP_HEADER_CODE ||
-            state == PICTURE_START_CODE)
+        uint32_t prefix = find_start_code_prefix(&data[offset], data_size - offset);
+        if (prefix == ESSENCE_PARSER_NULL_OFFSET)
+            break;
+        offset += prefix;
+
+        uint32_t code = START_CODE(&data[offset]);
+        if (code == SEQUENCE_HEADER_CODE ||
+            code == GROUP_HEADER_CODE ||
+            code == PICTURE_START_CODE)
         {
-            return offset - 3;
+            return offset;
         }
 
         offset++;
@@ -145,8 +152,32 @@ uint32_t MPEG2EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t
     if (data_size < 4)
         return ESSENCE_PARSER_NULL_OFFSET;
 
+    // mOffset is the offset of the next byte that could complete a start code
+    if (mOffset < 4) {
+        mState = START_CODE(data);
+        if (mState != SEQUENCE_HEADER_CODE &&
+            mState != GROUP_HEADER_CODE &&
+            mState != PICTURE_START_CODE)
+        {
+            // not a valid frame start
+            ResetFrameSize();
+            return ESSENCE_PARSER_NULL_FRAME_SIZE;
+        }
+
+        mSequenceHeader = (mState == SEQUENCE_HEADER_CODE);
+        mGroupHeader = (mState == GROUP_HEADER_CODE);
+        mPictureStart = (mState == PICTURE_START_CODE);
+        mOffset = 4;
+    }
+
     while (mOffset < data_size) {
-        mState = (mState << 8) | data[mOffset];
+        uint32_t prefix = find_start_code_prefix(&data[mOffset - 3], data_size - (mOffset - 3));
+        if (prefix == ESSENCE_PARSER_NULL_OFFSET)
+            break;
+        uint32_t code_offset = mOffset - 3 + prefix;
+        mOffset = code_offset + 4;
+
+        mState = START_CODE(&data[code_offset]);
         if (mState == SEQUENCE_HEADER_CODE ||
             mState == GROUP_HEADER_CODE ||
             mState == PICTURE_START_CODE)
@@ -155,25 +186,19 @@ uint32_t MPEG2EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t
                 (mState == GROUP_HEADER_CODE && (mGroupHeader || mPictureStart)) ||
                 (mState == PICTURE_START_CODE && mPictureStart))
             {
-                uint32_t frame_size = mOffset - 3;
                 ResetFrameSize();
-                return frame_size;
+                return code_offset;
             }
 
             mSequenceHeader = mSequenceHeader || (mState == SEQUENCE_HEADER_CODE);
             mGroupHeader = mGroupHeader || (mState == GROUP_HEADER_CODE);
             mPictureStart = mPictureStart || (mState == PICTURE_START_CODE);
         }
-        else if (mOffset == 3)
-        {
-            // not a valid frame start
-            ResetFrameSize();
-            return ESSENCE_PARSER_NULL_FRAME_SIZE;
-        }
-
-        mOffset++;
     }
 
+    // start codes ending before data_size have been processed
+    mOffset = data_size;
+
     return ESSENCE_PARSER_NULL_OFFSET;
 }
 
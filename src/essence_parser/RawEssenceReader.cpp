@@ -53,7 +53,7 @@ using namespace std;
 using namespace bmx;
 
 
-#define READ_BLOCK_SIZE         8192
+#define READ_BLOCK_SIZE         (1024 * 1024)
 #define PARSE_FRAME_START_SIZE  8192
 
 
@@ -63,9 +63,11 @@ RawEssenceReader::RawEssenceReader(EssenceSource *essence_source)
     mEssenceSource = essence_source;
     mMaxReadLength = 0;
     mTotalReadLength = 0;
+    mReadBlockSize = READ_BLOCK_SIZE;
     mMaxSampleSize = 0;
     mFixedSampleSize = 0;
     mEssenceParser = 0;
+    mSampleDataOffset = 0;
     mSampleDataSize = 0;
     mNumSamples = 0;
     mReadFirstSample = false;
@@ -85,6 +87,13 @@ void RawEssenceReader::SetMaxReadLength(int64_t len)
     mMaxReadLength = len;
 }
 
+void RawEssenceReader::SetReadBlockSize(uint32_t size)
+{
+    BMX_CHECK(size > 0);
+    mReadBlockSize = size;
+    mSampleBuffer.SetAllocBlockSize(size);
+}
+
 void RawEssenceReader::SetFixedSampleSize(uint32_t size)
 {
     mFixedSampleSize = size;
@@ -105,12 +114,10 @@ uint32_t RawEssenceReader::ReadSamples(uint32_t num_samples)
     if (mLastSampleRead)
         return 0;
 
-    // shift data from previous read to start of sample data
-    // note that this is needed even if mFixedSampleSize > 0 because the previous read could have occurred
-    // when mFixedSampleSize == 0
-    ShiftSampleData(0, mSampleDataSize);
-    mSampleDataSize = 0;
-    mNumSamples = 0;
+    // discard the sample data from the previous read
+    // note that the remaining data is kept even if mFixedSampleSize > 0 because the previous read could have
+    // occurred when mFixedSampleSize == 0
+    ConsumeSampleData();
 
 
     if (mFixedSampleSize == 0) {
@@ -120,12 +127,15 @@ uint32_t RawEssenceReader::ReadSamples(uint32_t num_samples)
                 break;
         }
     } else {
-        ReadBytes(mFixedSampleSize * num_samples - mSampleBuffer.GetSize());
-        if (mSampleBuffer.GetSize() < mFixedSampleSize * num_samples)
+        uint32_t read_size = mFixedSampleSize * num_samples;
+        if (GetBufferedSize() < read_size)
+            ReadBytes(read_size - GetBufferedSize());
+        if (GetBufferedSize() < read_size) {
             mLastSampleRead = true;
+            read_size = GetBufferedSize();
+        }
 
-        mNumSamples = mSampleBuffer.GetSize() / mFixedSampleSize;
-        mSampleBuffer.SetSize(mNumSamples * mFixedSampleSize);
+        mNumSamples = read_size / mFixedSampleSize;
         mSampleDataSize = mNumSamples * mFixedSampleSize;
     }
 
@@ -145,6 +155,7 @@ void RawEssenceReader::Reset()
 
     mTotalReadLength = 0;
     mSampleBuffer.SetSize(0);
+    mSampleDataOffset = 0;
     mSampleDataSize = 0;
     mNumSamples = 0;
     mReadFirstSample = false;
@@ -156,14 +167,14 @@ bool RawEssenceReader::ReadAndParseSample()
     BMX_CHECK(mEssenceParser);
 
     uint32_t sample_start_offset = mSampleDataSize;
-    uint32_t sample_num_read = mSampleBuffer.GetSize() - sample_start_offset;
+    uint32_t sample_num_read = GetBufferedSize() - sample_start_offset;
     uint32_t num_read;
 
     if (!mReadFirstSample) {
         // find the start of the first sample
 
         sample_num_read += ReadBytes(PARSE_FRAME_START_SIZE);
-        uint32_t offset = mEssenceParser->ParseFrameStart(mSampleBuffer.GetBytes() + sample_start_offset, sample_num_read);
+        uint32_t offset = mEssenceParser->ParseFrameStart(GetSampleData() + sample_start_offset, sample_num_read);
         if (offset == ESSENCE_PARSER_NULL_OFFSET) {
             log_warn("Failed to find start of raw essence sample\n");
             mLastSampleRead = true;
@@ -177,20 +188,22 @@ bool RawEssenceReader::ReadAndParseSample()
         }
 
         mReadFirstSample = true;
-    } else {
-        sample_num_read += ReadBytes(READ_BLOCK_SIZE);
+    } else if (sample_num_read == 0) {
+        sample_num_read += ReadBytes(mReadBlockSize);
     }
 
+    // the remaining data from the previous read is parsed first and more data is read only if it doesn't contain
+    // the complete sample
     uint32_t sample_size = 0;
     while (true) {
-        sample_size = mEssenceParser->ParseFrameSize(mSampleBuffer.GetBytes() + sample_start_offset, sample_num_read);
+        sample_size = mEssenceParser->ParseFrameSize(GetSampleData() + sample_start_offset, sample_num_read);
         if (sample_size != ESSENCE_PARSER_NULL_OFFSET)
             break;
 
-        BMX_CHECK_M(mMaxSampleSize == 0 || mSampleBuffer.GetSize() - sample_start_offset <= mMaxSampleSize,
+        BMX_CHECK_M(mMaxSampleSize == 0 || GetBufferedSize() - sample_start_offset <= mMaxSampleSize,
                    ("Max raw sample size (%u) exceeded", mMaxSampleSize));
 
-        num_read = ReadBytes(READ_BLOCK_SIZE);
+        num_read = ReadBytes(mReadBlockSize);
         if (num_read == 0)
             break;
 
@@ -205,7 +218,7 @@ bool RawEssenceReader::ReadAndParseSample()
         // assume remaining data is valid sample data
         mLastSampleRead = true;
         if (sample_num_read > 0) {
-            mSampleDataSize = mSampleBuffer.GetSize();
+            mSampleDataSize = GetBufferedSize();
             mNumSamples++;
         }
         return false;
@@ -226,7 +239,7 @@ uint32_t RawEssenceReader::ReadBytes(uint32_t size)
     if (actual_size == 0)
         return 0;
 
-    mSampleBuffer.Grow(actual_size);
+    GrowSampleBuffer(actual_size);
     uint32_t num_read = mEssenceSource->Read(mSampleBuffer.GetBytesAvailable(), actual_size);
     if (num_read < actual_size && mEssenceSource->HaveError())
         log_error("Failed to read from raw essence source: %s\n", mEssenceSource->GetStrError().c_str());
@@ -240,12 +253,49 @@ uint32_t RawEssenceReader::ReadBytes(uint32_t size)
 void RawEssenceReader::ShiftSampleData(uint32_t to_offset, uint32_t from_offset)
 {
     BMX_ASSERT(to_offset <= from_offset);
-    BMX_ASSERT(from_offset <= mSampleBuffer.GetSize());
+    BMX_ASSERT(from_offset <= GetBufferedSize());
+
+    if (to_offset == 0) {
+        // skip the data rather than moving it
+        mSampleDataOffset += from_offset;
+        if (mSampleDataOffset == mSampleBuffer.GetSize()) {
+            mSampleBuffer.SetSize(0);
+            mSampleDataOffset = 0;
+        }
+        return;
+    }
 
-    uint32_t size = mSampleBuffer.GetSize() - from_offset;
+    uint32_t size = GetBufferedSize() - from_offset;
     if (size > 0)
-        memmove(mSampleBuffer.GetBytes() + to_offset, mSampleBuffer.GetBytes() + from_offset, size);
-    mSampleBuffer.SetSize(to_offset + size);
+        memmove(GetSampleData() + to_offset, GetSampleData() + from_offset, size);
+    mSampleBuffer.SetSize(mSampleDataOffset + to_offset + size);
+}
+
+void RawEssenceReader::ConsumeSampleData()
+{
+    ShiftSampleData(0, mSampleDataSize);
+    mSampleDataSize = 0;
+    mNumSamples = 0;
+}
+
+void RawEssenceReader::GrowSampleBuffer(uint32_t size)
+{
+    // Move the remaining data to the start of the buffer if there is not enough space at the end and either the
+    // move is no larger than the data that has been consumed or the consumed data is at least a read block. The
+    // buffer size is then bounded by the sample size plus a few read blocks and the copy cost is bounded by the
+    // bytes read, whereas moving the remaining data after every read would copy up to a read block for each sample
+    if (mSampleDataOffset > 0 &&
+        mSampleBuffer.GetSizeAvailable() < size &&
+        (GetBufferedSize() <= mSampleDataOffset || mSampleDataOffset >= mReadBlockSize))
+    {
+        uint32_t buffered_size = GetBufferedSize();
+        if (buffered_size > 0)
+            memmove(mSampleBuffer.GetBytes(), GetSampleData(), buffered_size);
+        mSampleBuffer.SetSize(buffered_size);
+        mSampleDataOffset = 0;
+    }
+
+    mSampleBuffer.Grow(size);
 }
 
 uint32_t RawEssenceReader::AppendBytes(const unsigned char *bytes, uint32_t size)
@@ -258,7 +308,7 @@ uint32_t RawEssenceReader::AppendBytes(const unsigned char *bytes, uint32_t size
     if (actual_size == 0)
         return 0;
 
-    mSampleBuffer.Grow(actual_size);
+    GrowSampleBuffer(actual_size);
     memcpy(mSampleBuffer.GetBytesAvailable(), bytes, actual_size);
 
     mTotalReadLength += actual_size;
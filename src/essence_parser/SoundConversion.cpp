@@ -35,11 +35,645 @@
 
 #include <cstring>
 
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BMX_SSE2_SOUND_CONVERSION
+#include <emmintrin.h>
+#if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define BMX_AVX2_SOUND_CONVERSION
+#include <immintrin.h>
+#endif
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define BMX_NEON_SOUND_CONVERSION
+#include <arm_neon.h>
+#endif
+
+#if defined(BMX_AVX2_SOUND_CONVERSION) && !defined(_MSC_VER)
+#define BMX_TARGET_AVX2     __attribute__((target("avx2")))
+#else
+#define BMX_TARGET_AVX2
+#endif
+
 #include <bmx/essence_parser/SoundConversion.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
+using namespace std;
+using namespace bmx;
+
+
+/* An AES3 subframe is stored in a 32-bit little-endian word, with the (up to) 24-bit sample in bits 4 to 27.
+   A 16-bit sample is therefore (word >> 12) & 0xffff and a 24-bit sample is (word >> 4) & 0xffffff.
+   The D10 AES3 element has 8 subframes (channels) per sample. */
+
+#define AES3_ROW_SIZE   (8 * 4)
+
+#define AVX2_DEINTERLEAVE_BLOCK_SIZE    16384
+
+
+static SoundConversionISA detect_sound_conversion_isa()
+{
+#if defined(BMX_AVX2_SOUND_CONVERSION)
+    if (cpu_has_feature(CPU_FEATURE_AVX2))
+        return AVX2_SOUND_CONVERSION_ISA;
+#endif
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+    if (cpu_has_feature(CPU_FEATURE_SSE2))
+        return SSE2_SOUND_CONVERSION_ISA;
+#endif
+#if defined(BMX_NEON_SOUND_CONVERSION)
+    if (cpu_has_feature(CPU_FEATURE_NEON))
+        return NEON_SOUND_CONVERSION_ISA;
+#endif
+    return SCALAR_SOUND_CONVERSION_ISA;
+}
+
+static SoundConversionISA g_sound_conversion_isa = detect_sound_conversion_isa();
+
+
+static inline bool use_sse2()
+{
+    return g_sound_conversion_isa == SSE2_SOUND_CONVERSION_ISA || g_sound_conversion_isa == AVX2_SOUND_CONVERSION_ISA;
+}
+
+static inline bool use_avx2()
+{
+    return g_sound_conversion_isa == AVX2_SOUND_CONVERSION_ISA;
+}
+
+static inline bool use_neon()
+{
+    return g_sound_conversion_isa == NEON_SOUND_CONVERSION_ISA;
+}
+
+static inline int channel_mask(uint8_t valid_flags, int channel_num)
+{
+    return (valid_flags & (1 << channel_num)) ? -1 : 0;
+}
+
+
+
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+
+static inline uint32_t load_uint32(const unsigned char *data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline __m128i sse2_aes3_to_pcm16(__m128i words)
+{
+    return _mm_srai_epi32(_mm_slli_epi32(words, 4), 16);
+}
+
+static inline __m128i sse2_pack_24bit(__m128i values)
+{
+    // pack the low 3 bytes of each 32-bit value into the first 12 bytes
+    const __m128i dword0_mask = _mm_set_epi32(0, 0x00ffffff, 0, 0x00ffffff);
+    const __m128i dword1_mask = _mm_set_epi32(0x00ffffff, 0, 0x00ffffff, 0);
+    const __m128i qword0_mask = _mm_set_epi32(0, 0, -1, -1);
+    __m128i qwords = _mm_or_si128(_mm_and_si128(values, dword0_mask),
+                                  _mm_srli_epi64(_mm_and_si128(values, dword1_mask), 8));
+    return _mm_or_si128(_mm_and_si128(qwords, qword0_mask),
+                        _mm_srli_si128(_mm_andnot_si128(qword0_mask, qwords), 2));
+}
+
+static uint16_t sse2_aes3_to_pcm(const unsigned char *aes_data, uint16_t sample_count, uint32_t block_align,
+                                 unsigned char *pcm_data)
+{
+    uint16_t sample_num = 0;
+
+    if (block_align == 2) {
+        for (; sample_num + 8 <= sample_count; sample_num += 8) {
+            __m128i words_0 = _mm_set_epi32(load_uint32(&aes_data[3 * AES3_ROW_SIZE]),
+                                            load_uint32(&aes_data[2 * AES3_ROW_SIZE]),
+                                            load_uint32(&aes_data[1 * AES3_ROW_SIZE]),
+                                            load_uint32(&aes_data[0]));
+            __m128i words_1 = _mm_set_epi32(load_uint32(&aes_data[7 * AES3_ROW_SIZE]),
+                                            load_uint32(&aes_data[6 * AES3_ROW_SIZE]),
+                                            load_uint32(&aes_data[5 * AES3_ROW_SIZE]),
+                                            load_uint32(&aes_data[4 * AES3_ROW_SIZE]));
+            _mm_storeu_si128((__m128i*)pcm_data,
+                             _mm_packs_epi32(sse2_aes3_to_pcm16(words_0), sse2_aes3_to_pcm16(words_1)));
+            aes_data += 8 * AES3_ROW_SIZE;
+            pcm_data += 8 * 2;
+        }
+    } else {
+        // the 16 byte store writes 4 bytes beyond the 12 bytes of samples
+        for (; sample_num + 6 <= sample_count; sample_num += 4) {
+            __m128i words = _mm_set_epi32(load_uint32(&aes_data[3 * AES3_ROW_SIZE]),
+                                          load_uint32(&aes_data[2 * AES3_ROW_SIZE]),
+                                          load_uint32(&aes_data[1 * AES3_ROW_SIZE]),
+                                          load_uint32(&aes_data[0]));
+            _mm_storeu_si128((__m128i*)pcm_data, sse2_pack_24bit(_mm_srli_epi32(words, 4)));
+            aes_data += 4 * AES3_ROW_SIZE;
+            pcm_data += 4 * 3;
+        }
+    }
+
+    return sample_num;
+}
+
+static uint16_t sse2_aes3_to_mc_pcm(const unsigned char *aes_data, uint16_t sample_count, uint8_t channel_count,
+                                    uint8_t valid_flags, uint32_t bytes_per_sample, unsigned char *pcm_data)
+{
+    const __m128i mask_0 = _mm_set_epi32(channel_mask(valid_flags, 3), channel_mask(valid_flags, 2),
+                                         channel_mask(valid_flags, 1), channel_mask(valid_flags, 0));
+    const __m128i mask_1 = _mm_set_epi32(channel_mask(valid_flags, 7), channel_mask(valid_flags, 6),
+                                         channel_mask(valid_flags, 5), channel_mask(valid_flags, 4));
+    uint32_t row_size = channel_count * bytes_per_sample;
+    unsigned char row[32];
+    uint16_t sample_num;
+
+    for (sample_num = 0; sample_num < sample_count; sample_num++) {
+        __m128i words_0 = _mm_loadu_si128((const __m128i*)&aes_data[0]);
+        __m128i words_1 = _mm_loadu_si128((const __m128i*)&aes_data[16]);
+        if (bytes_per_sample == 2) {
+            __m128i samples = _mm_packs_epi32(_mm_and_si128(sse2_aes3_to_pcm16(words_0), mask_0),
+                                              _mm_and_si128(sse2_aes3_to_pcm16(words_1), mask_1));
+            if (channel_count == 8) {
+                _mm_storeu_si128((__m128i*)pcm_data, samples);
+            } else {
+                _mm_storeu_si128((__m128i*)row, samples);
+                memcpy(pcm_data, row, row_size);
+            }
+        } else {
+            __m128i samples_0 = sse2_pack_24bit(_mm_and_si128(_mm_srli_epi32(words_0, 4), mask_0));
+            __m128i samples_1 = sse2_pack_24bit(_mm_and_si128(_mm_srli_epi32(words_1, 4), mask_1));
+            if (channel_count == 8 && sample_num + 1 < sample_count) {
+                // the 4 bytes written beyond the row are overwritten by the next row
+                _mm_storeu_si128((__m128i*)pcm_data, samples_0);
+                _mm_storeu_si128((__m128i*)&pcm_data[12], samples_1);
+            } else {
+                _mm_storeu_si128((__m128i*)row, samples_0);
+                _mm_storeu_si128((__m128i*)&row[12], samples_1);
+                memcpy(pcm_data, row, row_size);
+            }
+        }
+        aes_data += AES3_ROW_SIZE;
+        pcm_data += row_size;
+    }
+
+    return sample_num;
+}
+
+static uint32_t sse2_deinterleave_audio(const unsigned char *input_data, uint32_t sample_count,
+                                        uint32_t block_align, uint16_t channel_count, uint16_t channel_num,
+                                        unsigned char *output_data)
+{
+    if (block_align != 2 || channel_count != 2)
+        return 0;
+
+    uint32_t i;
+    for (i = 0; i + 8 <= sample_count; i += 8) {
+        __m128i frames_0 = _mm_loadu_si128((const __m128i*)&input_data[i * 4]);
+        __m128i frames_1 = _mm_loadu_si128((const __m128i*)&input_data[i * 4 + 16]);
+        if (channel_num == 0) {
+            frames_0 = _mm_srai_epi32(_mm_slli_epi32(frames_0, 16), 16);
+            frames_1 = _mm_srai_epi32(_mm_slli_epi32(frames_1, 16), 16);
+        } else {
+            frames_0 = _mm_srai_epi32(frames_0, 16);
+            frames_1 = _mm_srai_epi32(frames_1, 16);
+        }
+        _mm_storeu_si128((__m128i*)&output_data[i * 2], _mm_packs_epi32(frames_0, frames_1));
+    }
+
+    return i;
+}
+
+static uint32_t sse2_interleave_audio(const unsigned char *input_data, uint32_t sample_count,
+                                      uint32_t block_align, uint16_t channel_count, uint16_t channel_num,
+                                      unsigned char *output_data)
+{
+    if (block_align != 2 || channel_count != 2)
+        return 0;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i keep_mask = (channel_num == 0 ? _mm_set1_epi32((int)0xffff0000) : _mm_set1_epi32(0x0000ffff));
+    uint32_t i;
+    for (i = 0; i + 4 <= sample_count; i += 4) {
+        __m128i samples = _mm_loadl_epi64((const __m128i*)&input_data[i * 2]);
+        if (channel_num == 0)
+            samples = _mm_unpacklo_epi16(samples, zero);
+        else
+            samples = _mm_unpacklo_epi16(zero, samples);
+        __m128i frames = _mm_loadu_si128((const __m128i*)&output_data[i * 4]);
+        _mm_storeu_si128((__m128i*)&output_data[i * 4], _mm_or_si128(_mm_and_si128(frames, keep_mask), samples));
+    }
+
+    return i;
+}
+
+static inline void sse2_store_channel(unsigned char * const *output_data, uint32_t channel_num, uint32_t sample_num,
+                                      __m128i samples)
+{
+    if (output_data[channel_num])
+        _mm_storeu_si128((__m128i*)&output_data[channel_num][sample_num * 2], samples);
+}
+
+static uint32_t sse2_deinterleave_audio_channels(const unsigned char *input_data, uint32_t sample_count,
+                                                 uint32_t block_align, uint16_t channel_count,
+                                                 unsigned char * const *output_data)
+{
+    if (block_align != 2 || (channel_count != 2 && channel_count != 4 && (channel_count % 8) != 0))
+        return 0;
+
+    // 8 frames are transposed to 8 samples per channel using 16-, 32- and 64-bit unpacks
+    uint32_t input_block_align = channel_count * 2;
+    uint32_t i, c;
+    for (i = 0; i + 8 <= sample_count; i += 8) {
+        const unsigned char *frames = &input_data[i * input_block_align];
+        if (channel_count == 2) {
+            __m128i frames_0 = _mm_loadu_si128((const __m128i*)frames);
+            __m128i frames_1 = _mm_loadu_si128((const __m128i*)&frames[16]);
+            sse2_store_channel(output_data, 0, i,
+                               _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(frames_0, 16), 16),
+                                               _mm_srai_epi32(_mm_slli_epi32(frames_1, 16), 16)));
+            sse2_store_channel(output_data, 1, i,
+                               _mm_packs_epi32(_mm_srai_epi32(frames_0, 16), _mm_srai_epi32(frames_1, 16)));
+        } else if (channel_count == 4) {
+            __m128i frames_01 = _mm_loadu_si128((const __m128i*)frames);
+            __m128i frames_23 = _mm_loadu_si128((const __m128i*)&frames[16]);
+            __m128i frames_45 = _mm_loadu_si128((const __m128i*)&frames[32]);
+            __m128i frames_67 = _mm_loadu_si128((const __m128i*)&frames[48]);
+            __m128i t0 = _mm_unpacklo_epi16(frames_01, frames_23);
+            __m128i t1 = _mm_unpackhi_epi16(frames_01, frames_23);
+            __m128i t2 = _mm_unpacklo_epi16(frames_45, frames_67);
+            __m128i t3 = _mm_unpackhi_epi16(frames_45, frames_67);
+            __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+            __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+            __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+            __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+            sse2_store_channel(output_data, 0, i, _mm_unpacklo_epi64(u0, u2));
+            sse2_store_channel(output_data, 1, i, _mm_unpackhi_epi64(u0, u2));
+            sse2_store_channel(output_data, 2, i, _mm_unpacklo_epi64(u1, u3));
+            sse2_store_channel(output_data, 3, i, _mm_unpackhi_epi64(u1, u3));
+        } else {
+            for (c = 0; c < channel_count; c += 8) {
+                __m128i r0 = _mm_loadu_si128((const __m128i*)&frames[0 * input_block_align + c * 2]);
+                __m128i r1 = _mm_loadu_si128((const __m128i*)&frames[1 * input_block_align + c * 2]);
+                __m128i r2 = _mm_loadu_si128((const __m128i*)&frames[2 * input_block_align + c * 2]);
+                __m128i r3 = _mm_loadu_si128((const __m128i*)&frames[3 * input_block_align + c * 2]);
+                __m128i r4 = _mm_loadu_si128((const __m128i*)&frames[4 * input_block_align + c * 2]);
+                __m128i r5 = _mm_loadu_si128((const __m128i*)&frames[5 * input_block_align + c * 2]);
+                __m128i r6 = _mm_loadu_si128((const __m128i*)&frames[6 * input_block_align + c * 2]);
+                __m128i r7 = _mm_loadu_si128((const __m128i*)&frames[7 * input_block_align + c * 2]);
+                __m128i a0 = _mm_unpacklo_epi16(r0, r1);
+                __m128i a1 = _mm_unpackhi_epi16(r0, r1);
+                __m128i a2 = _mm_unpacklo_epi16(r2, r3);
+                __m128i a3 = _mm_unpackhi_epi16(r2, r3);
+                __m128i a4 = _mm_unpacklo_epi16(r4, r5);
+                __m128i a5 = _mm_unpackhi_epi16(r4, r5);
+                __m128i a6 = _mm_unpacklo_epi16(r6, r7);
+                __m128i a7 = _mm_unpackhi_epi16(r6, r7);
+                __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+                __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+                __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+                __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+                __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+                __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+                __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+                __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+                sse2_store_channel(output_data, c + 0, i, _mm_unpacklo_epi64(b0, b4));
+                sse2_store_channel(output_data, c + 1, i, _mm_unpackhi_epi64(b0, b4));
+                sse2_store_channel(output_data, c + 2, i, _mm_unpacklo_epi64(b1, b5));
+                sse2_store_channel(output_data, c + 3, i, _mm_unpackhi_epi64(b1, b5));
+                sse2_store_channel(output_data, c + 4, i, _mm_unpacklo_epi64(b2, b6));
+                sse2_store_channel(output_data, c + 5, i, _mm_unpackhi_epi64(b2, b6));
+                sse2_store_channel(output_data, c + 6, i, _mm_unpacklo_epi64(b3, b7));
+                sse2_store_channel(output_data, c + 7, i, _mm_unpackhi_epi64(b3, b7));
+            }
+        }
+    }
+
+    return i;
+}
+
+#endif // BMX_SSE2_SOUND_CONVERSION
+
+
+
+#if defined(BMX_AVX2_SOUND_CONVERSION)
+
+BMX_TARGET_AVX2
+static inline __m256i avx2_aes3_to_pcm16(__m256i words)
+{
+    return _mm256_srai_epi32(_mm256_slli_epi32(words, 4), 16);
+}
+
+BMX_TARGET_AVX2
+static inline __m256i avx2_pack_24bit(__m256i values)
+{
+    // pack the low 3 bytes of each 32-bit value into the first 12 bytes of each 128-bit lane
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    return _mm256_shuffle_epi8(values, shuffle);
+}
+
+BMX_TARGET_AVX2
+static inline void avx2_store_24bit(unsigned char *data, __m256i packed)
+{
+    // writes 28 bytes, the last 4 bytes are not part of the 24 bytes of samples
+    _mm_storeu_si128((__m128i*)data, _mm256_castsi256_si128(packed));
+    _mm_storeu_si128((__m128i*)&data[12], _mm256_extracti128_si256(packed, 1));
+}
+
+BMX_TARGET_AVX2
+static uint16_t avx2_aes3_to_pcm(const unsigned char *aes_data, uint16_t sample_count, uint32_t block_align,
+                                 unsigned char *pcm_data)
+{
+    const __m256i row_index = _mm256_setr_epi32(0, 8, 16, 24, 32, 40, 48, 56);
+    uint16_t sample_num = 0;
+
+    if (block_align == 2) {
+        for (; sample_num + 8 <= sample_count; sample_num += 8) {
+            __m256i samples = avx2_aes3_to_pcm16(_mm256_i32gather_epi32((const int*)aes_data, row_index, 4));
+            samples = _mm256_permute4x64_epi64(_mm256_packs_epi32(samples, samples), 0x08);
+            _mm_storeu_si128((__m128i*)pcm_data, _mm256_castsi256_si128(samples));
+            aes_data += 8 * AES3_ROW_SIZE;
+            pcm_data += 8 * 2;
+        }
+    } else {
+        for (; sample_num + 10 <= sample_count; sample_num += 8) {
+            __m256i words = _mm256_i32gather_epi32((const int*)aes_data, row_index, 4);
+            avx2_store_24bit(pcm_data, avx2_pack_24bit(_mm256_srli_epi32(words, 4)));
+            aes_data += 8 * AES3_ROW_SIZE;
+            pcm_data += 8 * 3;
+        }
+    }
+
+    return sample_num;
+}
+
+BMX_TARGET_AVX2
+static uint16_t avx2_aes3_to_mc_pcm(const unsigned char *aes_data, uint16_t sample_count, uint8_t channel_count,
+                                    uint8_t valid_flags, uint32_t bytes_per_sample, unsigned char *pcm_data)
+{
+    if (channel_count != 8)
+        return 0;
+
+    const __m256i mask = _mm256_setr_epi32(channel_mask(valid_flags, 0), channel_mask(valid_flags, 1),
+                                           channel_mask(valid_flags, 2), channel_mask(valid_flags, 3),
+                                           channel_mask(valid_flags, 4), channel_mask(valid_flags, 5),
+                                           channel_mask(valid_flags, 6), channel_mask(valid_flags, 7));
+    uint16_t sample_num = 0;
+
+    if (bytes_per_sample == 2) {
+        for (; sample_num + 2 <= sample_count; sample_num += 2) {
+            __m256i samples_0 = _mm256_and_si256(avx2_aes3_to_pcm16(_mm256_loadu_si256((const __m256i*)aes_data)),
+                                                 mask);
+            __m256i samples_1 = _mm256_and_si256(avx2_aes3_to_pcm16(_mm256_loadu_si256((const __m256i*)&aes_data[AES3_ROW_SIZE])),
+                                                 mask);
+            // packs operates within 128-bit lanes and the permute restores the channel order
+            __m256i samples = _mm256_permute4x64_epi64(_mm256_packs_epi32(samples_0, samples_1), 0xd8);
+            _mm256_storeu_si256((__m256i*)pcm_data, samples);
+            aes_data += 2 * AES3_ROW_SIZE;
+            pcm_data += 2 * 8 * 2;
+        }
+    } else {
+        for (; sample_num + 1 < sample_count; sample_num++) {
+            __m256i words = _mm256_and_si256(_mm256_srli_epi32(_mm256_loadu_si256((const __m256i*)aes_data), 4), mask);
+            avx2_store_24bit(pcm_data, avx2_pack_24bit(words));
+            aes_data += AES3_ROW_SIZE;
+            pcm_data += 8 * 3;
+        }
+    }
+
+    return sample_num;
+}
+
+BMX_TARGET_AVX2
+static uint32_t avx2_deinterleave_audio(const unsigned char *input_data, uint32_t input_data_size,
+                                        uint32_t sample_count, uint32_t block_align,
+                                        uint16_t channel_count, uint16_t channel_num,
+                                        unsigned char *output_data)
+{
+    uint32_t input_block_align = channel_count * block_align;
+    uint32_t channel_offset = channel_num * block_align;
+    if (channel_count < 2 || (block_align != 2 && block_align != 3))
+        return 0;
+
+    const __m256i frame_index = _mm256_setr_epi32(0,                     (int)input_block_align,
+                                                  2 * input_block_align, 3 * input_block_align,
+                                                  4 * input_block_align, 5 * input_block_align,
+                                                  6 * input_block_align, 7 * input_block_align);
+    uint32_t i = 0;
+
+    // each gathered 32-bit value extends beyond the sample and must stay within the input data
+    if (block_align == 2) {
+        for (; i + 8 <= sample_count &&
+               (uint64_t)(i + 7) * input_block_align + channel_offset + 4 <= input_data_size; i += 8)
+        {
+            __m256i samples = _mm256_i32gather_epi32((const int*)&input_data[i * input_block_align + channel_offset],
+                                                     frame_index, 1);
+            samples = _mm256_srai_epi32(_mm256_slli_epi32(samples, 16), 16);
+            samples = _mm256_permute4x64_epi64(_mm256_packs_epi32(samples, samples), 0x08);
+            _mm_storeu_si128((__m128i*)&output_data[i * 2], _mm256_castsi256_si128(samples));
+        }
+    } else {
+        for (; i + 10 <= sample_count &&
+               (uint64_t)(i + 7) * input_block_align + channel_offset + 4 <= input_data_size; i += 8)
+        {
+            __m256i samples = _mm256_i32gather_epi32((const int*)&input_data[i * input_block_align + channel_offset],
+                                                     frame_index, 1);
+            avx2_store_24bit(&output_data[i * 3], avx2_pack_24bit(samples));
+        }
+    }
+
+    return i;
+}
+
+BMX_TARGET_AVX2
+static uint32_t avx2_deinterleave_audio_channels(const unsigned char *input_data, uint32_t input_data_size,
+                                                 uint32_t sample_count, uint32_t block_align,
+                                                 uint16_t channel_count, unsigned char * const *output_data)
+{
+    uint32_t input_block_align = channel_count * block_align;
+    if (channel_count < 2 || (block_align != 2 && block_align != 3))
+        return 0;
+
+    // the channels are gathered from blocks of frames that fit in the L1 data cache so that the input is only
+    // read from memory once
+    uint32_t block_sample_count = (AVX2_DEINTERLEAVE_BLOCK_SIZE / input_block_align) & ~7U;
+    if (block_sample_count < 8)
+        block_sample_count = 8;
+
+    uint32_t i, c, k, j;
+    for (i = 0; i < sample_count; i += block_sample_count) {
+        uint32_t count = sample_count - i;
+        if (count > block_sample_count)
+            count = block_sample_count;
+        const unsigned char *block_input = &input_data[i * input_block_align];
+        for (c = 0; c < channel_count; c++) {
+            if (!output_data[c])
+                continue;
+            unsigned char *block_output = &output_data[c][i * block_align];
+            k = avx2_deinterleave_audio(block_input, input_data_size - i * input_block_align, count, block_align,
+                                        channel_count, (uint16_t)c, block_output);
+            for (; k < count; k++) {
+                for (j = 0; j < block_align; j++)
+                    block_output[k * block_align + j] = block_input[k * input_block_align + c * block_align + j];
+            }
+        }
+    }
+
+    return sample_count;
+}
+
+#endif // BMX_AVX2_SOUND_CONVERSION
+
+
+
+#if defined(BMX_NEON_SOUND_CONVERSION)
+
+static uint16_t neon_aes3_to_mc_pcm(const unsigned char *aes_data, uint16_t sample_count, uint8_t channel_count,
+                                    uint8_t valid_flags, uint32_t bytes_per_sample, unsigned char *pcm_data)
+{
+    uint8_t mask_bytes[16];
+    int i;
+    for (i = 0; i < 16; i++)
+        mask_bytes[i] = (uint8_t)channel_mask(valid_flags, i % 8);
+    const uint8x16_t mask = vld1q_u8(mask_bytes);
+    uint32_t row_size = channel_count * bytes_per_sample;
+    unsigned char rows[2 * 8 * 3];
+    uint16_t sample_num;
+
+    // 2 rows of 8 subframes are loaded with the bytes of each subframe de-interleaved
+    for (sample_num = 0; sample_num + 2 <= sample_count; sample_num += 2) {
+        uint8x16x4_t bytes = vld4q_u8(aes_data);
+        unsigned char *output = (channel_count == 8 ? pcm_data : rows);
+        if (bytes_per_sample == 2) {
+            uint8x16x2_t samples;
+            samples.val[0] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[1], 4), vshlq_n_u8(bytes.val[2], 4)), mask);
+            samples.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[2], 4), vshlq_n_u8(bytes.val[3], 4)), mask);
+            vst2q_u8(output, samples);
+        } else {
+            uint8x16x3_t samples;
+            samples.val[0] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[0], 4), vshlq_n_u8(bytes.val[1], 4)), mask);
+            samples.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[1], 4), vshlq_n_u8(bytes.val[2], 4)), mask);
+            samples.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[2], 4), vshlq_n_u8(bytes.val[3], 4)), mask);
+            vst3q_u8(output, samples);
+        }
+        if (channel_count != 8) {
+            memcpy(pcm_data, rows, row_size);
+            memcpy(&pcm_data[row_size], &rows[8 * bytes_per_sample], row_size);
+        }
+        aes_data += 2 * AES3_ROW_SIZE;
+        pcm_data += 2 * row_size;
+    }
+
+    return sample_num;
+}
+
+static uint32_t neon_deinterleave_audio(const unsigned char *input_data, uint32_t sample_count,
+                                        uint32_t block_align, uint16_t channel_count, uint16_t channel_num,
+                                        unsigned char *output_data)
+{
+    if (block_align != 2 || channel_count < 2 || channel_count > 4)
+        return 0;
+
+    const uint16_t *input = (const uint16_t*)input_data;
+    uint16_t *output = (uint16_t*)output_data;
+    uint32_t i;
+    for (i = 0; i + 8 <= sample_count; i += 8) {
+        if (channel_count == 2) {
+            uint16x8x2_t frames = vld2q_u16(input);
+            vst1q_u16(output, frames.val[channel_num]);
+        } else if (channel_count == 3) {
+            uint16x8x3_t frames = vld3q_u16(input);
+            vst1q_u16(output, frames.val[channel_num]);
+        } else {
+            uint16x8x4_t frames = vld4q_u16(input);
+            vst1q_u16(output, frames.val[channel_num]);
+        }
+        input  += 8 * channel_count;
+        output += 8;
+    }
+
+    return i;
+}
+
+static uint32_t neon_interleave_audio(const unsigned char *input_data, uint32_t sample_count,
+                                      uint32_t block_align, uint16_t channel_count, uint16_t channel_num,
+                                      unsigned char *output_data)
+{
+    if (block_align != 2 || channel_count < 2 || channel_count > 4)
+        return 0;
+
+    const uint16_t *input = (const uint16_t*)input_data;
+    uint16_t *output = (uint16_t*)output_data;
+    uint32_t i;
+    for (i = 0; i + 8 <= sample_count; i += 8) {
+        if (channel_count == 2) {
+            uint16x8x2_t frames = vld2q_u16(output);
+            frames.val[channel_num] = vld1q_u16(input);
+            vst2q_u16(output, frames);
+        } else if (channel_count == 3) {
+            uint16x8x3_t frames = vld3q_u16(output);
+            frames.val[channel_num] = vld1q_u16(input);
+            vst3q_u16(output, frames);
+        } else {
+            uint16x8x4_t frames = vld4q_u16(output);
+            frames.val[channel_num] = vld1q_u16(input);
+            vst4q_u16(output, frames);
+        }
+        input  += 8;
+        output += 8 * channel_count;
+    }
+
+    return i;
+}
+
+#endif // BMX_NEON_SOUND_CONVERSION
+
+
+
+bool bmx::sound_conversion_isa_supported(SoundConversionISA isa)
+{
+    switch (isa)
+    {
+        case SCALAR_SOUND_CONVERSION_ISA:
+            return true;
+        case SSE2_SOUND_CONVERSION_ISA:
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+            return cpu_has_feature(CPU_FEATURE_SSE2);
+#else
+            return false;
+#endif
+        case AVX2_SOUND_CONVERSION_ISA:
+#if defined(BMX_AVX2_SOUND_CONVERSION)
+            return cpu_has_feature(CPU_FEATURE_SSE2) && cpu_has_feature(CPU_FEATURE_AVX2);
+#else
+            return false;
+#endif
+        case NEON_SOUND_CONVERSION_ISA:
+#if defined(BMX_NEON_SOUND_CONVERSION)
+            return cpu_has_feature(CPU_FEATURE_NEON);
+#else
+            return false;
+#endif
+    }
 
+    return false;
+}
+
+bool bmx::set_sound_conversion_isa(SoundConversionISA isa)
+{
+    if (!sound_conversion_isa_supported(isa))
+        return false;
+
+    g_sound_conversion_isa = isa;
+    return true;
+}
+
+SoundConversionISA bmx::get_sound_conversion_isa()
+{
+    return g_sound_conversion_isa;
+}
 
 uint8_t bmx::get_aes3_channel_valid_flags(const unsigned char *aes3_data, uint32_t aes3_data_size)
 {
@@ -73,10 +707,23 @@ uint32_t bmx::convert_aes3_to_pcm(const unsigned char *aes3_data, uint32_t aes3_
 
     const unsigned char *aes_data_ptr = &aes3_data[4];
     unsigned char *pcm_data_ptr = &pcm_data[0];
-    uint16_t sample_num;
+    uint16_t sample_num = 0;
+
+#if defined(BMX_AVX2_SOUND_CONVERSION)
+    if (use_avx2())
+        sample_num = avx2_aes3_to_pcm(aes_data_ptr + channel_num * 4, sample_count, block_align, pcm_data_ptr);
+#endif
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+    if (use_sse2())
+        sample_num += sse2_aes3_to_pcm(aes_data_ptr + sample_num * AES3_ROW_SIZE + channel_num * 4,
+                                       sample_count - sample_num, block_align,
+                                       pcm_data_ptr + sample_num * block_align);
+#endif
+    aes_data_ptr += sample_num * AES3_ROW_SIZE;
+    pcm_data_ptr += sample_num * block_align;
 
     if (block_align == 2) {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+        for (; sample_num < sample_count; sample_num++) {
             aes_data_ptr += channel_num * 4;
             pcm_data_ptr[0] = (aes_data_ptr[1] >> 4) |
                               (aes_data_ptr[2] << 4);
@@ -86,7 +733,7 @@ uint32_t bmx::convert_aes3_to_pcm(const unsigned char *aes3_data, uint32_t aes3_
             aes_data_ptr += (8 - channel_num) * 4;
         }
     } else {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+        for (; sample_num < sample_count; sample_num++) {
             aes_data_ptr += channel_num * 4;
             pcm_data_ptr[0] = (aes_data_ptr[0] >> 4) |
                               (aes_data_ptr[1] << 4);
@@ -117,10 +764,35 @@ uint32_t bmx::convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t ae
 
     const unsigned char *aes_data_ptr = &aes3_data[4];
     unsigned char *pcm_data_ptr = &pcm_data[0];
-    uint16_t sample_num, channel_num;
+    uint16_t sample_num = 0, channel_num;
+
+    if (channel_count > 0) {
+#if defined(BMX_AVX2_SOUND_CONVERSION)
+        if (use_avx2()) {
+            sample_num = avx2_aes3_to_mc_pcm(aes_data_ptr, sample_count, channel_count, valid_flags,
+                                             bytes_per_sample, pcm_data_ptr);
+        }
+#endif
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+        if (use_sse2()) {
+            sample_num += sse2_aes3_to_mc_pcm(aes_data_ptr + sample_num * AES3_ROW_SIZE,
+                                              sample_count - sample_num, channel_count, valid_flags,
+                                              bytes_per_sample,
+                                              pcm_data_ptr + sample_num * channel_count * bytes_per_sample);
+        }
+#endif
+#if defined(BMX_NEON_SOUND_CONVERSION)
+        if (use_neon()) {
+            sample_num = neon_aes3_to_mc_pcm(aes_data_ptr, sample_count, channel_count, valid_flags,
+                                             bytes_per_sample, pcm_data_ptr);
+        }
+#endif
+        aes_data_ptr += sample_num * AES3_ROW_SIZE;
+        pcm_data_ptr += sample_num * channel_count * bytes_per_sample;
+    }
 
     if (bytes_per_sample == 2) {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+        for (; sample_num < sample_count; sample_num++) {
             for (channel_num = 0; channel_num < channel_count; channel_num++) {
                 if (valid_flags & (1 << channel_num)) {
                     pcm_data_ptr[0] = (aes_data_ptr[1] >> 4) |
@@ -137,7 +809,7 @@ uint32_t bmx::convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t ae
             aes_data_ptr += (8 - channel_count) * 4;
         }
     } else {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+        for (; sample_num < sample_count; sample_num++) {
             for (channel_num = 0; channel_num < channel_count; channel_num++) {
                 if (valid_flags & (1 << channel_num)) {
                     pcm_data_ptr[0] = (aes_data_ptr[0] >> 4) |
@@ -161,6 +833,75 @@ uint32_t bmx::convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t ae
     return 4 + sample_count * 4 * 8;
 }
 
+uint32_t bmx::convert_aes3_to_pcm_channels(const unsigned char *aes3_data, uint32_t aes3_data_size,
+                                          bool ignore_valid_flags, uint32_t bits_per_sample, uint8_t channel_count,
+                                          unsigned char * const *pcm_data, uint32_t pcm_data_size)
+{
+    uint16_t sample_count   = get_aes3_sample_count(aes3_data, aes3_data_size);
+    uint8_t valid_flags     = (ignore_valid_flags ? 0xff : get_aes3_channel_valid_flags(aes3_data, aes3_data_size));
+    uint32_t block_align    = (bits_per_sample + 7) / 8;
+
+    BMX_CHECK(sample_count <= (aes3_data_size - 4) / (8 * 4)); // 4 bytes per sample, 8 channels
+    BMX_CHECK(block_align == 2 || block_align == 3); // only 16-bit to 24-bit sample size allowed
+    BMX_CHECK(channel_count <= 8);
+    BMX_CHECK(pcm_data_size >= block_align * sample_count);
+
+    // invalid channels are zeroed up front so that the sample loop only visits the channels that are output
+    unsigned char *channel_pcm_data[8];
+    uint32_t channel_offsets[8];
+    uint8_t num_channels = 0;
+    uint8_t channel_num;
+    for (channel_num = 0; channel_num < channel_count; channel_num++) {
+        if (!pcm_data[channel_num])
+            continue;
+        if (!(valid_flags & (1 << channel_num))) {
+            memset(pcm_data[channel_num], 0, sample_count * block_align);
+            continue;
+        }
+        channel_pcm_data[num_channels] = pcm_data[channel_num];
+        channel_offsets[num_channels]  = channel_num * 4;
+        num_channels++;
+    }
+    if (num_channels == 1) {
+        return convert_aes3_to_pcm(aes3_data, aes3_data_size, true, bits_per_sample,
+                                   (uint8_t)(channel_offsets[0] / 4), channel_pcm_data[0], pcm_data_size);
+    }
+
+    const unsigned char *aes_data_ptr = &aes3_data[4];
+    uint16_t sample_num;
+    uint8_t i;
+
+    if (block_align == 2) {
+        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+            for (i = 0; i < num_channels; i++) {
+                const unsigned char *aes_sample_ptr = &aes_data_ptr[channel_offsets[i]];
+                unsigned char *pcm_data_ptr = &channel_pcm_data[i][sample_num * 2];
+                pcm_data_ptr[0] = (aes_sample_ptr[1] >> 4) |
+                                  (aes_sample_ptr[2] << 4);
+                pcm_data_ptr[1] = (aes_sample_ptr[2] >> 4) |
+                                  (aes_sample_ptr[3] << 4);
+            }
+            aes_data_ptr += 8 * 4;
+        }
+    } else {
+        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+            for (i = 0; i < num_channels; i++) {
+                const unsigned char *aes_sample_ptr = &aes_data_ptr[channel_offsets[i]];
+                unsigned char *pcm_data_ptr = &channel_pcm_data[i][sample_num * 3];
+                pcm_data_ptr[0] = (aes_sample_ptr[0] >> 4) |
+                                  (aes_sample_ptr[1] << 4);
+                pcm_data_ptr[1] = (aes_sample_ptr[1] >> 4) |
+                                  (aes_sample_ptr[2] << 4);
+                pcm_data_ptr[2] = (aes_sample_ptr[2] >> 4) |
+                                  (aes_sample_ptr[3] << 4);
+            }
+            aes_data_ptr += 8 * 4;
+        }
+    }
+
+    return 4 + sample_count * 4 * 8;
+}
+
 void bmx::deinterleave_audio(const unsigned char *input_data, uint32_t input_data_size,
                             uint32_t bits_per_sample, uint16_t channel_count, uint16_t channel_num,
                             unsigned char *output_data, uint32_t output_data_size)
@@ -169,16 +910,107 @@ void bmx::deinterleave_audio(const unsigned char *input_data, uint32_t input_dat
     uint32_t output_block_align = (bits_per_sample + 7) / 8;
     uint32_t channel_offset = channel_num * output_block_align;
     uint32_t sample_count = input_data_size / input_block_align;
-    uint32_t i, j;
+    uint32_t i = 0, j;
 
     BMX_CHECK(output_data_size >= sample_count * output_block_align);
 
-    for (i = 0; i < sample_count; i++) {
+    if (channel_num < channel_count) {
+#if defined(BMX_AVX2_SOUND_CONVERSION)
+        if (use_avx2()) {
+            i = avx2_deinterleave_audio(input_data, input_data_size, sample_count, output_block_align,
+                                        channel_count, channel_num, output_data);
+        }
+#endif
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+        if (use_sse2()) {
+            i += sse2_deinterleave_audio(&input_data[i * input_block_align], sample_count - i, output_block_align,
+                                         channel_count, channel_num, &output_data[i * output_block_align]);
+        }
+#endif
+#if defined(BMX_NEON_SOUND_CONVERSION)
+        if (use_neon()) {
+            i = neon_deinterleave_audio(input_data, sample_count, output_block_align, channel_count, channel_num,
+                                        output_data);
+        }
+#endif
+    }
+
+    for (; i < sample_count; i++) {
         for (j = 0; j < output_block_align; j++)
             output_data[i * output_block_align + j] = input_data[i * input_block_align + channel_offset + j];
     }
 }
 
+void bmx::deinterleave_audio_channels(const unsigned char *input_data, uint32_t input_data_size,
+                                     uint32_t bits_per_sample, uint16_t channel_count,
+                                     unsigned char * const *output_data, uint32_t output_data_size)
+{
+    uint32_t input_block_align = channel_count * ((bits_per_sample + 7) / 8);
+    uint32_t output_block_align = (bits_per_sample + 7) / 8;
+    uint32_t sample_count = input_data_size / input_block_align;
+
+    BMX_CHECK(output_data_size >= sample_count * output_block_align);
+
+    vector<unsigned char*> channel_output_data;
+    vector<uint32_t> channel_offsets;
+    uint16_t channel_num;
+    for (channel_num = 0; channel_num < channel_count; channel_num++) {
+        if (output_data[channel_num]) {
+            channel_output_data.push_back(output_data[channel_num]);
+            channel_offsets.push_back(channel_num * output_block_align);
+        }
+    }
+    if (channel_output_data.empty())
+        return;
+    if (channel_output_data.size() == 1) {
+        deinterleave_audio(input_data, input_data_size, bits_per_sample, channel_count,
+                           (uint16_t)(channel_offsets[0] / output_block_align),
+                           channel_output_data[0], output_data_size);
+        return;
+    }
+
+    uint32_t i = 0;
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+    if (use_sse2())
+        i = sse2_deinterleave_audio_channels(input_data, sample_count, output_block_align, channel_count, output_data);
+#endif
+#if defined(BMX_AVX2_SOUND_CONVERSION)
+    if (i == 0 && use_avx2()) {
+        i = avx2_deinterleave_audio_channels(input_data, input_data_size, sample_count, output_block_align,
+                                             channel_count, output_data);
+    }
+#endif
+
+    unsigned char * const *outputs = &channel_output_data[0];
+    const uint32_t *offsets = &channel_offsets[0];
+    uint32_t num_channels = (uint32_t)channel_output_data.size();
+    const unsigned char *input_data_ptr = &input_data[i * input_block_align];
+    uint32_t c, j;
+
+    // each input frame is read once and the sample sizes are fixed so that the copies are inlined
+    if (output_block_align == 2) {
+        for (; i < sample_count; i++) {
+            for (c = 0; c < num_channels; c++)
+                memcpy(&outputs[c][i * 2], &input_data_ptr[offsets[c]], 2);
+            input_data_ptr += input_block_align;
+        }
+    } else if (output_block_align == 3) {
+        for (; i < sample_count; i++) {
+            for (c = 0; c < num_channels; c++)
+                memcpy(&outputs[c][i * 3], &input_data_ptr[offsets[c]], 3);
+            input_data_ptr += input_block_align;
+        }
+    } else {
+        for (; i < sample_count; i++) {
+            for (c = 0; c < num_channels; c++) {
+                for (j = 0; j < output_block_align; j++)
+                    outputs[c][i * output_block_align + j] = input_data_ptr[offsets[c] + j];
+            }
+            input_data_ptr += input_block_align;
+        }
+    }
+}
+
 void bmx::interleave_audio(const unsigned char *input_data, uint32_t input_data_size,
                            uint32_t bits_per_sample, uint16_t channel_count, uint16_t channel_num,
                            unsigned char *output_data, uint32_t output_data_size)
@@ -187,11 +1019,26 @@ void bmx::interleave_audio(const unsigned char *input_data, uint32_t input_data_
     uint32_t output_block_align = channel_count * input_block_align;
     uint32_t channel_offset = channel_num * input_block_align;
     uint32_t sample_count = input_data_size / input_block_align;
-    uint32_t i, j;
+    uint32_t i = 0, j;
 
     BMX_CHECK(output_data_size >= sample_count * output_block_align);
 
-    for (i = 0; i < sample_count; i++) {
+    if (channel_num < channel_count) {
+#if defined(BMX_SSE2_SOUND_CONVERSION)
+        if (use_sse2()) {
+            i = sse2_interleave_audio(input_data, sample_count, input_block_align, channel_count, channel_num,
+                                      output_data);
+        }
+#endif
+#if defined(BMX_NEON_SOUND_CONVERSION)
+        if (use_neon()) {
+            i = neon_interleave_audio(input_data, sample_count, input_block_align, channel_count, channel_num,
+                                      output_data);
+        }
+#endif
+    }
+
+    for (; i < sample_count; i++) {
         for (j = 0; j < input_block_align; j++)
             output_data[i * output_block_align + channel_offset + j] = input_data[i * input_block_align + j];
     }
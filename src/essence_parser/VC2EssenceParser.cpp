@@ -41,6 +41,7 @@
 #include <limits.h>
 
 #include <bmx/essence_parser/VC2EssenceParser.h>
+#include "EssenceParserUtils.h"
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -53,6 +54,9 @@ using namespace bmx;
 #define MAX_SEARCH_COUNT    100000000   // 100MB
 
 
+static const unsigned char PARSE_INFO_PREFIX_BYTES[] = {0x42, 0x42, 0x43, 0x44};
+
+
 typedef struct
 {
     uint32_t luma_offset;
@@ -314,59 +318,45 @@ uint32_t VC2EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t da
                 mOffset = buffer.GetPos();
                 mParseState = PARSE_INFO_STATE;
             } else {
-                mSearchState = 0;
                 mSearchCount = (uint32_t)(buffer.GetPos() - mOffset);
                 mParseState = SEARCH_PARSE_INFO_STATE;
             }
         } else { // mParseState == SEARCH_PARSE_INFO_STATE
-            buffer.SetPos(mOffset + mSearchCount);
-            while (buffer.GetRemSize() > 0) {
-                uint32_t next_data;
-                uint32_t read_count;
-                while (mSearchState != PARSE_INFO_PREFIX && mSearchCount < MAX_SEARCH_COUNT) {
-                    if ((mSearchState & 0x00ffffff) == (PARSE_INFO_PREFIX >> 8))
-                        read_count = 1;
-                    else if ((mSearchState & 0x0000ffff) == (PARSE_INFO_PREFIX >> 16))
-                        read_count = 2;
-                    else if ((mSearchState & 0x000000ff) == (PARSE_INFO_PREFIX >> 24))
-                        read_count = 3;
-                    else
-                        read_count = 4;
-                    try {
-                        next_data = (uint32_t)buffer.GetUIntLit(read_count);
-                    } catch (...) {
-                        // end of buffer
-                        break;
-                    }
-                    if (read_count == 4)
-                        mSearchState = next_data;
-                    else
-                        mSearchState = (mSearchState << (read_count * 8)) | next_data;
-                    mSearchCount += read_count;
+            // mSearchCount is the offset from mOffset where the search for the next parse info prefix continues
+            while (true) {
+                uint32_t prefix = ESSENCE_PARSER_NULL_OFFSET;
+                if (mOffset + mSearchCount < data_size) {
+                    prefix = find_marker(&data[mOffset + mSearchCount], data_size - (mOffset + mSearchCount),
+                                         PARSE_INFO_PREFIX_BYTES, sizeof(PARSE_INFO_PREFIX_BYTES));
                 }
-                if (mSearchState != PARSE_INFO_PREFIX) {
-                    if (mSearchCount >= MAX_SEARCH_COUNT) {
-                        log_warn("Failed to find next parse info within maximum %u bytes\n", MAX_SEARCH_COUNT);
-                        return ESSENCE_PARSER_NULL_FRAME_SIZE;
-                    }
-                    break;
+                if (prefix == ESSENCE_PARSER_NULL_OFFSET) {
+                    // the last 3 bytes could be the start of a prefix that is completed by the next data
+                    if (data_size > mOffset + mSearchCount + 3)
+                        mSearchCount = data_size - 3 - mOffset;
+                } else {
+                    mSearchCount += prefix;
                 }
+                if (mSearchCount >= MAX_SEARCH_COUNT) {
+                    log_warn("Failed to find next parse info within maximum %u bytes\n", MAX_SEARCH_COUNT);
+                    return ESSENCE_PARSER_NULL_FRAME_SIZE;
+                }
+                if (prefix == ESSENCE_PARSER_NULL_OFFSET)
+                    break;
 
                 ParseInfo parse_info;
-                buffer.SetPos(buffer.GetPos() - 4);
+                buffer.SetPos(mOffset + mSearchCount);
                 uint32_t res = ParseParseInfo(&buffer, &parse_info);
-                if (res == 0) {
-                    mSearchState = 0;
-                } else {
-                    if (res != ESSENCE_PARSER_NULL_OFFSET &&
-                        parse_info.prev_parse_offset == VC2_PARSE_INFO_SIZE + mSearchCount - 4)
-                    {
-                        buffer.SetPos(buffer.GetPos() - VC2_PARSE_INFO_SIZE);
-                        mOffset = buffer.GetPos();
-                        mParseState = PARSE_INFO_STATE;
-                    }
+                if (res == ESSENCE_PARSER_NULL_OFFSET)
+                    break;
+                if (res != 0 && parse_info.prev_parse_offset == VC2_PARSE_INFO_SIZE + mSearchCount) {
+                    mOffset += mSearchCount;
+                    buffer.SetPos(mOffset);
+                    mParseState = PARSE_INFO_STATE;
                     break;
                 }
+
+                // the prefix bytes were part of the data unit payload
+                mSearchCount++;
             }
             if (mParseState == SEARCH_PARSE_INFO_STATE)
                 break; // reached end of buffer
@@ -715,7 +705,6 @@ void VC2EssenceParser::ResetFrameSize()
     memset(&mCurrentParseInfo, 0, sizeof(mCurrentParseInfo));
     mParseInfos.clear();
     mPictureCount = 0;
-    mSearchState = 0;
     mSearchCount = 0;
 }
 
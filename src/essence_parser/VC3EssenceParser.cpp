@@ -123,15 +123,20 @@ uint32_t VC3EssenceParser::ParseFrameStart(const unsigned char *data, uint32_t d
 {
     BMX_CHECK(data_size != ESSENCE_PARSER_NULL_OFFSET);
 
-    uint64_t state = 0;
-    uint32_t i;
-    for (i = 0; i < data_size; i++) {
-        state = (state << 8) | data[i];
-        if ((state & 0xffffffff0000LL) == HEADER_PREFIX_S &&
-            (state & 0x000000000003LL) < 3)    // coding unit is progressive frame or field 1
-        {
-            return i - 5;
-        }
+    static const unsigned char header_prefix[] = {0x00, 0x00, 0x02, 0x80};
+
+    // the header prefix is followed by a byte that is ignored and a byte containing the coding unit
+    uint32_t offset = 0;
+    while (offset + 6 <= data_size) {
+        uint32_t prefix = find_marker(&data[offset], data_size - offset - 2, header_prefix, sizeof(header_prefix));
+        if (prefix == ESSENCE_PARSER_NULL_OFFSET)
+            break;
+        offset += prefix;
+
+        if ((data[offset + 5] & 0x03) < 3)    // coding unit is progressive frame or field 1
+            return offset;
+
+        offset++;
     }
 
     return ESSENCE_PARSER_NULL_OFFSET;
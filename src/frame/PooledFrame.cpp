@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <new>
+
+#include <bmx/frame/PooledFrame.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+// the frame allocation is preceded by a header identifying the pool
+// the header size preserves the alignment of the allocated memory
+typedef struct
+{
+    FramePool *pool;
+    size_t size;
+} FrameHeader;
+
+#define FRAME_HEADER_SIZE   ((sizeof(FrameHeader) + 15) / 16 * 16)
+
+
+
+FramePool::FramePool(size_t max_free)
+{
+    mRefCount = 1;
+    mMaxFree = max_free;
+    mFrameAllocSize = 0;
+    mFreeBuffers.reserve(max_free);
+    mFreeFrames.reserve(max_free);
+
+    mStats.max_free    = max_free;
+    mStats.num_free    = 0;
+    mStats.num_in_use  = 0;
+    mStats.max_in_use  = 0;
+    mStats.num_created = 0;
+    mStats.num_reused  = 0;
+}
+
+FramePool::~FramePool()
+{
+    size_t i;
+    for (i = 0; i < mFreeBuffers.size(); i++)
+        delete mFreeBuffers[i];
+    for (i = 0; i < mFreeFrames.size(); i++)
+        ::operator delete(mFreeFrames[i]);
+}
+
+void FramePool::AddRef()
+{
+    lock_guard<mutex> lock(mMutex);
+    mRefCount++;
+}
+
+void FramePool::Release()
+{
+    bool delete_pool;
+    {
+        lock_guard<mutex> lock(mMutex);
+        BMX_ASSERT(mRefCount > 0);
+        mRefCount--;
+        delete_pool = (mRefCount == 0);
+    }
+    if (delete_pool)
+        delete this;
+}
+
+ByteArray* FramePool::AcquireBuffer()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (!mFreeBuffers.empty()) {
+            ByteArray *buffer = mFreeBuffers.back();
+            mFreeBuffers.pop_back();
+            buffer->SetSize(0);
+            return buffer;
+        }
+    }
+
+    return new ByteArray();
+}
+
+void FramePool::ReleaseBuffer(ByteArray *buffer)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (mFreeBuffers.size() < mMaxFree) {
+            mFreeBuffers.push_back(buffer);
+            return;
+        }
+    }
+
+    delete buffer;
+}
+
+void* FramePool::AllocateFrame(size_t size)
+{
+    unsigned char *block = 0;
+    {
+        lock_guard<mutex> lock(mMutex);
+
+        if (size > mFrameAllocSize) {
+            // frames of a different (smaller) size can't be re-used
+            size_t i;
+            for (i = 0; i < mFreeFrames.size(); i++)
+                ::operator delete(mFreeFrames[i]);
+            mFreeFrames.clear();
+            mFrameAllocSize = size;
+        }
+
+        if (!mFreeFrames.empty()) {
+            block = (unsigned char*)mFreeFrames.back();
+            mFreeFrames.pop_back();
+            mStats.num_reused++;
+        } else {
+            block = (unsigned char*)::operator new(FRAME_HEADER_SIZE + mFrameAllocSize);
+            mStats.num_created++;
+        }
+
+        mStats.num_in_use++;
+        if (mStats.num_in_use > mStats.max_in_use)
+            mStats.max_in_use = mStats.num_in_use;
+        mRefCount++;
+    }
+
+    FrameHeader *header = (FrameHeader*)block;
+    header->pool = this;
+    header->size = size;
+
+    return block + FRAME_HEADER_SIZE;
+}
+
+void FramePool::FreeFrame(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    unsigned char *block = (unsigned char*)ptr - FRAME_HEADER_SIZE;
+    FrameHeader *header = (FrameHeader*)block;
+    header->pool->ReleaseFrame(block);
+}
+
+FramePoolStats FramePool::GetStats()
+{
+    lock_guard<mutex> lock(mMutex);
+    mStats.num_free = mFreeFrames.size();
+    return mStats;
+}
+
+void FramePool::ReleaseFrame(void *block)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        BMX_ASSERT(mStats.num_in_use > 0);
+        mStats.num_in_use--;
+        if (((FrameHeader*)block)->size == mFrameAllocSize && mFreeFrames.size() < mMaxFree)
+            mFreeFrames.push_back(block);
+        else
+            ::operator delete(block);
+    }
+
+    // release the reference held by the frame allocation
+    Release();
+}
+
+
+
+PooledFrame::PooledFrame(FramePool *pool)
+: SharedBufferFrame(pool->AcquireBuffer())
+{
+    mPool = pool;
+    mPool->AddRef();
+}
+
+PooledFrame::PooledFrame(const PooledFrame &from)
+: SharedBufferFrame(from, from.mPool->AcquireBuffer())
+{
+    mPool = from.mPool;
+    mPool->AddRef();
+}
+
+PooledFrame::~PooledFrame()
+{
+    mPool->ReleaseBuffer(mData);
+    mPool->Release();
+}
+
+Frame* PooledFrame::Clone()
+{
+    return new (mPool) PooledFrame(*this);
+}
+
+void* PooledFrame::operator new(size_t size, FramePool *pool)
+{
+    return pool->AllocateFrame(size);
+}
+
+void PooledFrame::operator delete(void *ptr)
+{
+    FramePool::FreeFrame(ptr);
+}
+
+void PooledFrame::operator delete(void *ptr, FramePool *pool)
+{
+    (void)pool;
+    FramePool::FreeFrame(ptr);
+}
+
+
+
+PooledFrameFactory::PooledFrameFactory(size_t max_free_frames)
+{
+    mPool = new FramePool(max_free_frames);
+}
+
+PooledFrameFactory::~PooledFrameFactory()
+{
+    mPool->Release();
+}
+
+Frame* PooledFrameFactory::CreateFrame()
+{
+    return new (mPool) PooledFrame(mPool);
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <bmx/frame/SharedBufferFrame.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+SharedBuffer::SharedBuffer()
+{
+    mRefCount = 1;
+}
+
+SharedBuffer::~SharedBuffer()
+{
+}
+
+void SharedBuffer::AddRef()
+{
+    mRefCount++;
+}
+
+void SharedBuffer::Release()
+{
+    uint32_t prev_ref_count = mRefCount.fetch_sub(1);
+    BMX_ASSERT(prev_ref_count > 0);
+
+    if (prev_ref_count == 1)
+        delete this;
+}
+
+
+
+SharedBufferFrame::SharedBufferFrame()
+: Frame()
+{
+    mData = &mOwnedData;
+    mSharedBuffer = 0;
+    mSharedOffset = 0;
+    mSharedSize = 0;
+}
+
+SharedBufferFrame::SharedBufferFrame(const SharedBufferFrame &from)
+: Frame(from), mOwnedData(*from.mData)
+{
+    mData = &mOwnedData;
+    mSharedBuffer = from.mSharedBuffer;
+    mSharedOffset = from.mSharedOffset;
+    mSharedSize   = from.mSharedSize;
+    if (mSharedBuffer)
+        mSharedBuffer->AddRef();
+}
+
+SharedBufferFrame::SharedBufferFrame(ByteArray *data)
+: Frame()
+{
+    mData = data;
+    mSharedBuffer = 0;
+    mSharedOffset = 0;
+    mSharedSize = 0;
+}
+
+SharedBufferFrame::SharedBufferFrame(const SharedBufferFrame &from, ByteArray *data)
+: Frame(from)
+{
+    mData = data;
+    mData->CopyBytes(from.mData->GetBytes(), from.mData->GetSize());
+    mSharedBuffer = from.mSharedBuffer;
+    mSharedOffset = from.mSharedOffset;
+    mSharedSize   = from.mSharedSize;
+    if (mSharedBuffer)
+        mSharedBuffer->AddRef();
+}
+
+SharedBufferFrame::~SharedBufferFrame()
+{
+    if (mSharedBuffer)
+        mSharedBuffer->Release();
+}
+
+void SharedBufferFrame::SetSharedData(SharedBuffer *buffer, uint32_t offset, uint32_t size)
+{
+    BMX_CHECK(GetSize() == 0);
+    BMX_CHECK(offset + size <= buffer->GetData()->GetSize());
+
+    buffer->AddRef();
+    if (mSharedBuffer)
+        mSharedBuffer->Release();
+
+    mSharedBuffer = buffer;
+    mSharedOffset = offset;
+    mSharedSize   = size;
+}
+
+uint32_t SharedBufferFrame::GetSize() const
+{
+    if (mSharedBuffer)
+        return mSharedSize;
+    else
+        return mData->GetSize();
+}
+
+const unsigned char* SharedBufferFrame::GetBytes() const
+{
+    if (mSharedBuffer)
+        return mSharedBuffer->GetData()->GetBytes() + mSharedOffset;
+    else
+        return mData->GetBytes();
+}
+
+void SharedBufferFrame::Grow(uint32_t min_size)
+{
+    CopySharedData();
+    mData->Grow(min_size);
+}
+
+uint32_t SharedBufferFrame::GetSizeAvailable() const
+{
+    if (mSharedBuffer)
+        return 0;
+    else
+        return mData->GetSizeAvailable();
+}
+
+unsigned char* SharedBufferFrame::GetBytesAvailable() const
+{
+    if (mSharedBuffer)
+        return 0;
+    else
+        return mData->GetBytesAvailable();
+}
+
+void SharedBufferFrame::SetSize(uint32_t size)
+{
+    if (mSharedBuffer && size <= mSharedSize) {
+        mSharedSize = size;
+        return;
+    }
+
+    CopySharedData();
+    mData->SetSize(size);
+}
+
+void SharedBufferFrame::IncrementSize(uint32_t inc)
+{
+    CopySharedData();
+    mData->IncrementSize(inc);
+}
+
+Frame* SharedBufferFrame::Clone()
+{
+    return new SharedBufferFrame(*this);
+}
+
+void SharedBufferFrame::CopySharedData()
+{
+    if (!mSharedBuffer)
+        return;
+
+    // the frame data is going to be modified and so a private copy is required
+    mData->CopyBytes(mSharedBuffer->GetData()->GetBytes() + mSharedOffset, mSharedSize);
+
+    mSharedBuffer->Release();
+    mSharedBuffer = 0;
+    mSharedOffset = 0;
+    mSharedSize = 0;
+}
+
+
+
+Frame* SharedBufferFrameFactory::CreateFrame()
+{
+    return new SharedBufferFrame();
+}
@@ -56,6 +56,9 @@ using namespace mxfpp;
 #define SYS_META_SOUND_ITEM_FLAG    0x04
 #define SYS_META_DATA_ITEM_FLAG     0x02
 
+// essence data of at least this size is written directly rather than copied into the content package write buffer
+#define MIN_DIRECT_WRITE_SIZE       (64 * 1024)
+
 
 static const mxfKey MXF_EE_K(EmptyPackageMetadataSet) = MXF_SDTI_CP_PACKAGE_METADATA_KEY(0x00);
 
@@ -63,6 +66,10 @@ static const uint32_t SYSTEM_ITEM_TRACK_INDEX = (uint32_t)(-1);
 static const uint32_t SYSTEM_ITEM_METADATA_PACK_SIZE = 7 + 16 + 17 + 17;
 static const uint32_t NA_SYSTEM_ITEM_SIZE = mxfKey_extlen + FW_ESS_ELEMENT_LLEN + SYSTEM_ITEM_METADATA_PACK_SIZE +
                                             mxfKey_extlen + FW_ESS_ELEMENT_LLEN;
+static const uint32_t SYSTEM_ITEM_TIMESTAMP_SIZE = 17;
+static const uint32_t SYSTEM_ITEM_CONTINUITY_COUNT_OFFSET = mxfKey_extlen + FW_ESS_ELEMENT_LLEN + 5;
+static const uint32_t SYSTEM_ITEM_USER_TIMESTAMP_OFFSET = mxfKey_extlen + FW_ESS_ELEMENT_LLEN + 7 + 16 +
+                                                          SYSTEM_ITEM_TIMESTAMP_SIZE;
 
 
 
@@ -71,6 +78,52 @@ static bool compare_element(const OP1AContentPackageElement *left, const OP1ACon
   return left->element_type < right->element_type;
 }
 
+static void append_fixed_kl(ByteArray *buffer, const mxfKey *key, uint8_t llen, uint64_t len)
+{
+    BMX_ASSERT(llen > 0 && llen <= 9);
+    BMX_ASSERT((llen == 1 && len < 0x80) || (llen > 1 && (llen == 9 || (len >> ((llen - 1) * 8)) == 0)));
+
+    buffer->Grow(mxfKey_extlen + llen);
+    unsigned char *bytes = buffer->GetBytesAvailable();
+
+    memcpy(bytes, key, mxfKey_extlen);
+    if (llen == 1) {
+        bytes[mxfKey_extlen] = (unsigned char)len;
+    } else {
+        bytes[mxfKey_extlen] = 0x80 + llen - 1;
+        uint8_t i;
+        for (i = llen - 1; i > 0; i--) {
+            bytes[mxfKey_extlen + i] = (unsigned char)(len & 0xff);
+            len >>= 8;
+        }
+    }
+
+    buffer->IncrementSize(mxfKey_extlen + llen);
+}
+
+static void append_fill(File *mxf_file, ByteArray *buffer, uint32_t fill_size)
+{
+    BMX_ASSERT(fill_size > mxfKey_extlen);
+
+    // same KLV fill as File::writeFill
+    uint8_t llen = mxf_get_llen(mxf_file->getCFile(), fill_size - mxfKey_extlen);
+    BMX_ASSERT(fill_size >= mxfKey_extlen + llen);
+    append_fixed_kl(buffer, &g_KLVFill_key, llen, fill_size - mxfKey_extlen - llen);
+
+    uint32_t zeros_size = fill_size - mxfKey_extlen - llen;
+    buffer->Grow(zeros_size);
+    memset(buffer->GetBytesAvailable(), 0, zeros_size);
+    buffer->IncrementSize(zeros_size);
+}
+
+static void flush_write_buffer(File *mxf_file, ByteArray *buffer)
+{
+    if (buffer->GetSize() > 0) {
+        BMX_CHECK(mxf_file->write(buffer->GetBytes(), buffer->GetSize()) == buffer->GetSize());
+        buffer->SetSize(0);
+    }
+}
+
 
 
 OP1AContentPackageElement::OP1AContentPackageElement(uint32_t track_index_, ElementType element_type_,
@@ -250,19 +303,27 @@ uint32_t OP1AContentPackageElementData::GetWriteSize() const
     }
 }
 
-uint32_t OP1AContentPackageElementData::Write()
+uint32_t OP1AContentPackageElementData::Write(ByteArray *write_buffer)
 {
     uint32_t write_size = GetWriteSize();
 
     if (mElement->is_frame_wrapped) {
-        mElement->WriteKL(mMXFFile, mData.GetSize());
-        BMX_CHECK(mMXFFile->write(mData.GetBytes(), mData.GetSize()) == mData.GetSize());
+        // the KL and fill are serialized into the write buffer. Small essence data is copied into the buffer as well
+        // so that the content package is written in one go; larger data is written directly after a buffer flush
+        append_fixed_kl(write_buffer, &mElement->element_key, mElement->essence_llen, mData.GetSize());
+        if (mData.GetSize() >= MIN_DIRECT_WRITE_SIZE) {
+            flush_write_buffer(mMXFFile, write_buffer);
+            BMX_CHECK(mMXFFile->write(mData.GetBytes(), mData.GetSize()) == mData.GetSize());
+        } else {
+            write_buffer->Append(mData.GetBytes(), mData.GetSize());
+        }
         if (write_size > mxfKey_extlen + mElement->essence_llen + mData.GetSize())
-            mMXFFile->writeFill(write_size - (mxfKey_extlen + mElement->essence_llen + mData.GetSize()));
+            append_fill(mMXFFile, write_buffer, write_size - (mxfKey_extlen + mElement->essence_llen + mData.GetSize()));
         else
             BMX_ASSERT(write_size == mxfKey_extlen + mElement->essence_llen + mData.GetSize());
     } else {
         BMX_ASSERT(mTotalWriteSize == 0);
+        flush_write_buffer(mMXFFile, write_buffer);
         mElementStartPos = mMXFFile->tell();
         mElement->WriteKL(mMXFFile, 0);
         BMX_CHECK(mMXFFile->write(mData.GetBytes(), mData.GetSize()) == mData.GetSize());
@@ -325,6 +386,8 @@ OP1AContentPackage::OP1AContentPackage(File *mxf_file, OP1AIndexTable *index_tab
       mStartTimecode = start_timecode;
       mContentPackageRate = get_system_item_cp_rate(frame_rate);
       mUserTimecodeSet = false;
+
+      InitSystemItemTemplate();
     } else {
       mSystemItemSize = 0;
       mSystemMetadataBitmap = 0;
@@ -436,43 +499,35 @@ void OP1AContentPackage::UpdateIndexTable()
     mHaveUpdatedIndexTable = true;
 }
 
-uint32_t OP1AContentPackage::Write()
+uint32_t OP1AContentPackage::Write(ByteArray *write_buffer)
 {
     BMX_ASSERT(mHaveUpdatedIndexTable);
 
+    write_buffer->SetSize(0);
+
     if (mHaveSystemItem)
-        WriteSystemItem();
+        WriteSystemItem(write_buffer);
 
     uint32_t size = 0;
     size_t i;
     for (i = 0; i < mElementData.size(); i++)
-        size += mElementData[i]->Write();
+        size += mElementData[i]->Write(write_buffer);
+
+    flush_write_buffer(mMXFFile, write_buffer);
 
     return size;
 }
 
-void OP1AContentPackage::WriteSystemItem()
+void OP1AContentPackage::WriteSystemItem(ByteArray *write_buffer)
 {
-    mMXFFile->writeFixedKL(&MXF_EE_K(SDTI_CP_System_Pack), FW_ESS_ELEMENT_LLEN, SYSTEM_ITEM_METADATA_PACK_SIZE);
-
-    // core fields
-    mMXFFile->writeUInt8(mSystemMetadataBitmap);                        // system metadata bitmap
-    mMXFFile->writeUInt8(mContentPackageRate);                          // content package rate
-    mMXFFile->writeUInt8(0x00);                                         // content package type (default)
-    mMXFFile->writeUInt16(0x0000);                                      // channel handle (default)
-    mMXFFile->writeUInt16((uint16_t)(mPosition & 0xffff));              // continuity count
+    write_buffer->Append(mSystemItemTemplate.GetBytes(), mSystemItemTemplate.GetSize());
+    unsigned char *sys_item_bytes = write_buffer->GetBytes() + write_buffer->GetSize() - mSystemItemTemplate.GetSize();
 
-    // SMPTE Universal Label
-    mMXFFile->writeUL(&MXF_EC_L(MultipleWrappings));
-
-    // (null) Package creation date / time stamp
-    unsigned char ts_bytes[17];
-    memset(ts_bytes, 0, sizeof(ts_bytes));
-    BMX_CHECK(mMXFFile->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    // continuity count
+    mxf_set_uint16((uint16_t)(mPosition & 0xffff), &sys_item_bytes[SYSTEM_ITEM_CONTINUITY_COUNT_OFFSET]);
 
     // User date / time stamp
     Timecode user_timecode;
-    ts_bytes[0] = 0x81; // SMPTE 12-M timecode
     if (mHaveInputUserTimecode) {
         user_timecode = mUserTimecode;
     } else if (!mStartTimecode.IsInvalid()) {
@@ -481,14 +536,46 @@ void OP1AContentPackage::WriteSystemItem()
     } else {
         user_timecode.Init(get_rounded_tc_base(mFrameRate), false, mPosition);
     }
-    encode_smpte_timecode(user_timecode, false, &ts_bytes[1], sizeof(ts_bytes) - 1);
-    BMX_CHECK(mMXFFile->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    encode_smpte_timecode(user_timecode, false, &sys_item_bytes[SYSTEM_ITEM_USER_TIMESTAMP_OFFSET + 1],
+                          SYSTEM_ITEM_TIMESTAMP_SIZE - 1);
+}
+
+void OP1AContentPackage::InitSystemItemTemplate()
+{
+    // the system item bytes that are the same in every content package. WriteSystemItem sets the continuity count
+    // and user date / time stamp
+    mSystemItemTemplate.Allocate(mSystemItemSize);
+
+    append_fixed_kl(&mSystemItemTemplate, &MXF_EE_K(SDTI_CP_System_Pack), FW_ESS_ELEMENT_LLEN,
+                    SYSTEM_ITEM_METADATA_PACK_SIZE);
+
+    // core fields
+    unsigned char core_bytes[7];
+    mxf_set_uint8(mSystemMetadataBitmap,    &core_bytes[0]);            // system metadata bitmap
+    mxf_set_uint8(mContentPackageRate,      &core_bytes[1]);            // content package rate
+    mxf_set_uint8(0x00,                     &core_bytes[2]);            // content package type (default)
+    mxf_set_uint16(0x0000,                  &core_bytes[3]);            // channel handle (default)
+    mxf_set_uint16(0x0000,                  &core_bytes[5]);            // continuity count
+    mSystemItemTemplate.Append(core_bytes, sizeof(core_bytes));
+
+    // SMPTE Universal Label
+    mSystemItemTemplate.Append((const unsigned char*)&MXF_EC_L(MultipleWrappings), mxfUL_extlen);
+
+    // (null) Package creation date / time stamp
+    unsigned char ts_bytes[SYSTEM_ITEM_TIMESTAMP_SIZE];
+    memset(ts_bytes, 0, sizeof(ts_bytes));
+    mSystemItemTemplate.Append(ts_bytes, sizeof(ts_bytes));
+
+    // User date / time stamp
+    ts_bytes[0] = 0x81; // SMPTE 12-M timecode
+    mSystemItemTemplate.Append(ts_bytes, sizeof(ts_bytes));
 
     // empty Package Metadata Set
-    mMXFFile->writeFixedKL(&MXF_EE_K(EmptyPackageMetadataSet), FW_ESS_ELEMENT_LLEN, 0);
+    append_fixed_kl(&mSystemItemTemplate, &MXF_EE_K(EmptyPackageMetadataSet), FW_ESS_ELEMENT_LLEN, 0);
 
+    BMX_ASSERT(mSystemItemTemplate.GetSize() == NA_SYSTEM_ITEM_SIZE);
     if (mSystemItemSize > NA_SYSTEM_ITEM_SIZE)
-        mMXFFile->writeFill(mSystemItemSize - NA_SYSTEM_ITEM_SIZE);
+        append_fill(mMXFFile, &mSystemItemTemplate, mSystemItemSize - NA_SYSTEM_ITEM_SIZE);
 }
 
 void OP1AContentPackage::CompleteWrite()
@@ -761,7 +848,7 @@ void OP1AContentPackageManager::WriteNextContentPackage()
     BMX_ASSERT(HaveContentPackage());
 
     mContentPackages.front()->UpdateIndexTable();
-    mContentPackages.front()->Write();
+    mContentPackages.front()->Write(&mWriteBuffer);
 
     if (mFrameWrapped) {
         mFreeContentPackages.push_back(mContentPackages.front());
@@ -44,6 +44,7 @@
 #include <bmx/mxf_op1a/OP1ATimedTextTrack.h>
 #include <bmx/mxf_helper/MXFDescriptorHelper.h>
 #include <bmx/mxf_helper/MXFMCALabelHelper.h>
+#include <bmx/MXFWriteBehindFile.h>
 #include <bmx/MXFUtils.h>
 #include <bmx/Utils.h>
 #include <bmx/Version.h>
@@ -63,6 +64,8 @@ using namespace mxfpp;
 static const char TIMECODE_TRACK_NAME[]         = "TC1";
 static const uint8_t MIN_LLEN                   = 4;
 static const uint32_t MEMORY_WRITE_CHUNK_SIZE   = 8192;
+static const uint32_t WRITE_BEHIND_BUFFER_SIZE  = 8 * 1024 * 1024;
+static const uint32_t WRITE_BEHIND_NUM_BUFFERS  = 4;
 
 
 
@@ -113,6 +116,7 @@ OP1AFile::OP1AFile(int flavour, mxfpp::File *mxf_file, mxfRational frame_rate)
     mEssencePartitionKAGSize = mKAGSize;
     mSupportCompleteSinglePass = false;
     mFooterPartitionOffset = 0;
+    mWriteBehind = false;
     mMXFChecksumFile = 0;
     mCBEIndexPartitionIndex = 0;
     mSetPrimaryPackage = false;
@@ -233,6 +237,11 @@ void OP1AFile::SetPartitionInterval(int64_t frame_count)
     mPartitionInterval = frame_count;
 }
 
+void OP1AFile::SetWriteBehind(bool enable)
+{
+    mWriteBehind = enable;
+}
+
 void OP1AFile::SetClipWrapped(bool enable)
 {
     BMX_CHECK(mTracks.empty());
@@ -414,6 +423,12 @@ void OP1AFile::PrepareWrite()
     if (!mHavePreparedHeaderMetadata)
         PrepareHeaderMetadata();
 
+    if (mWriteBehind) {
+        // the write-behind file sits on top of the checksum file so that the md5 is also calculated in the writer thread
+        mMXFFile->swapCFile(mxf_write_behind_file_open(mMXFFile->getCFile(), WRITE_BEHIND_BUFFER_SIZE,
+                                                       WRITE_BEHIND_NUM_BUFFERS));
+    }
+
     CreateFile();
 }
 
@@ -619,6 +634,12 @@ void OP1AFile::CompleteWrite()
     }
 
 
+    // wait for the buffered data to be written
+
+    if (mWriteBehind && !mxf_write_behind_file_flush(mMXFFile->getCFile()))
+        BMX_EXCEPTION(("Failed to write buffered data to file"));
+
+
     // finalize md5
 
     if (mMXFChecksumFile) {
@@ -290,6 +290,17 @@ void EssenceChunkHelper::SetIsComplete()
     mIsComplete = true;
 }
 
+void EssenceChunkHelper::SetEssenceChunks(const vector<EssenceChunk> &chunks)
+{
+    mEssenceChunks = chunks;
+    mLastEssenceChunk = 0;
+    if (mEssenceChunks.empty())
+        mNumIndexedPartitions = 0;
+    else
+        mNumIndexedPartitions = mEssenceChunks.back().partition_id + 1;
+    mIsComplete = true;
+}
+
 bool EssenceChunkHelper::HaveFilePosition(int64_t essence_offset)
 {
     if (mEssenceChunks.empty())
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define __STDC_FORMAT_MACROS
+
+#include <bmx/mxf_reader/EssencePrefetcher.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+using namespace mxfpp;
+
+
+
+EssencePrefetcher::EssencePrefetcher(File *file, uint32_t max_requests)
+{
+    BMX_CHECK(max_requests > 0);
+
+    mFile = file;
+    mMaxRequests = max_requests;
+    mStop = false;
+
+    mThread = thread(&EssencePrefetcher::ReadThread, this);
+}
+
+EssencePrefetcher::~EssencePrefetcher()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mRequestCond.notify_all();
+    mThread.join();
+
+    size_t i;
+    for (i = 0; i < mRequests.size(); i++)
+        mRequests[i].buffer->Release();
+    for (i = 0; i < mFreeBuffers.size(); i++)
+        mFreeBuffers[i]->Release();
+}
+
+bool EssencePrefetcher::IsFull()
+{
+    lock_guard<mutex> lock(mMutex);
+    return mRequests.size() >= mMaxRequests;
+}
+
+bool EssencePrefetcher::IsNext(int64_t position)
+{
+    lock_guard<mutex> lock(mMutex);
+    return !mRequests.empty() && mRequests.front().position == position;
+}
+
+int64_t EssencePrefetcher::GetLastPosition()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mRequests.empty())
+        return -1;
+    else
+        return mRequests.back().position;
+}
+
+void EssencePrefetcher::Request(int64_t position, int64_t file_position, uint32_t size)
+{
+    SharedBuffer *buffer;
+    if (mFreeBuffers.empty()) {
+        buffer = new SharedBuffer();
+    } else {
+        buffer = mFreeBuffers.back();
+        mFreeBuffers.pop_back();
+    }
+
+    PrefetchRequest request;
+    request.position      = position;
+    request.file_position = file_position;
+    request.size          = size;
+    request.buffer        = buffer;
+    request.state         = REQUEST_QUEUED;
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        BMX_ASSERT(mRequests.size() < mMaxRequests);
+        mRequests.push_back(request);
+    }
+    mRequestCond.notify_one();
+}
+
+SharedBuffer* EssencePrefetcher::Take(int64_t position, int64_t *file_position, uint32_t *size)
+{
+    string read_error;
+    {
+        unique_lock<mutex> lock(mMutex);
+        BMX_CHECK(!mRequests.empty() && mRequests.front().position == position);
+
+        PrefetchRequest &request = mRequests.front();
+        while (request.state == REQUEST_QUEUED || request.state == REQUEST_READING)
+            mDoneCond.wait(lock);
+
+        if (request.state == REQUEST_DONE) {
+            SharedBuffer *buffer = request.buffer;
+            *file_position = request.file_position;
+            *size          = request.size;
+            mRequests.pop_front();
+            return buffer;
+        }
+
+        read_error = mReadError;
+    }
+
+    // the file position is unknown after a failed read and so all requests are dropped
+    Clear();
+    BMX_EXCEPTION(("%s", read_error.c_str()));
+}
+
+void EssencePrefetcher::Recycle(SharedBuffer *buffer)
+{
+    // the buffer can only be re-used once it is no longer referenced by frames
+    if (buffer->IsShared() || mFreeBuffers.size() >= mMaxRequests)
+        buffer->Release();
+    else
+        mFreeBuffers.push_back(buffer);
+}
+
+void EssencePrefetcher::Clear()
+{
+    deque<PrefetchRequest> requests;
+    {
+        unique_lock<mutex> lock(mMutex);
+
+        // the request being read can't be cancelled
+        size_t i;
+        for (i = 0; i < mRequests.size(); i++) {
+            if (mRequests[i].state == REQUEST_QUEUED)
+                mRequests[i].state = REQUEST_FAILED;
+        }
+        for (i = 0; i < mRequests.size(); i++) {
+            while (mRequests[i].state == REQUEST_READING)
+                mDoneCond.wait(lock);
+        }
+
+        requests.swap(mRequests);
+    }
+
+    size_t i;
+    for (i = 0; i < requests.size(); i++)
+        Recycle(requests[i].buffer);
+}
+
+void EssencePrefetcher::ReadThread()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        PrefetchRequest *request = 0;
+        while (!mStop) {
+            size_t i;
+            for (i = 0; i < mRequests.size(); i++) {
+                if (mRequests[i].state == REQUEST_QUEUED) {
+                    request = &mRequests[i];
+                    break;
+                }
+            }
+            if (request)
+                break;
+            mRequestCond.wait(lock);
+        }
+        if (mStop)
+            break;
+
+        // the request is not removed from the queue whilst it is being read
+        request->state = REQUEST_READING;
+        lock.unlock();
+
+        string read_error;
+        bool result = ReadRequest(request, &read_error);
+
+        lock.lock();
+        if (result) {
+            request->state = REQUEST_DONE;
+        } else {
+            request->state = REQUEST_FAILED;
+            mReadError = read_error;
+        }
+        mDoneCond.notify_all();
+    }
+}
+
+bool EssencePrefetcher::ReadRequest(PrefetchRequest *request, string *read_error)
+{
+    try
+    {
+        ByteArray *data = request->buffer->GetData();
+        data->Allocate(request->size);
+
+        if (mFile->tell() != request->file_position)
+            mFile->seek(request->file_position, SEEK_SET);
+
+        uint32_t num_read = mFile->read(data->GetBytes(), request->size);
+        if (num_read != request->size) {
+            char buffer[128];
+            bmx_snprintf(buffer, sizeof(buffer), "Failed to read content package (size 0x%x) at file position 0x%" PRIx64,
+                         request->size, request->file_position);
+            *read_error = buffer;
+            return false;
+        }
+        data->SetSize(request->size);
+
+        return true;
+    }
+    catch (const exception &ex)
+    {
+        *read_error = ex.what();
+    }
+    catch (...)
+    {
+        char buffer[128];
+        bmx_snprintf(buffer, sizeof(buffer), "Failed to read content package (size 0x%x) at file position 0x%" PRIx64,
+                     request->size, request->file_position);
+        *read_error = buffer;
+    }
+
+    return false;
+}
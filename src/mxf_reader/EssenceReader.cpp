@@ -40,12 +40,18 @@
 #include <cstdio>
 
 #include <memory>
+#include <vector>
 
 #include <bmx/mxf_reader/EssenceReader.h>
 #include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/mxf_reader/EssencePrefetcher.h>
+#include <bmx/mxf_reader/MXFIndexCache.h>
+#include <bmx/frame/SharedBufferFrame.h>
 #include <bmx/mxf_helper/PictureMXFDescriptorHelper.h>
 #include <bmx/mxf_helper/SoundMXFDescriptorHelper.h>
 #include <bmx/MXFUtils.h>
+#include <bmx/MXFMMapFile.h>
+#include <bmx/MXFHTTPFile.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -57,6 +63,10 @@ using namespace bmx;
 using namespace mxfpp;
 
 
+// maximum size of a read of multiple frame wrapped content packages
+#define MAX_BATCH_READ_SIZE     (32 * 1024 * 1024)
+
+
 EssenceReaderBuffer::EssenceReaderBuffer(MXFFileReader *file_reader)
 {
     mFileReader = file_reader;
@@ -256,6 +266,12 @@ EssenceReader::EssenceReader(MXFFileReader *file_reader, bool file_is_complete,
     mLastKnownBasePosition = -1;
     mHaveFooter = file_is_complete;
     mBaseReadError = false;
+    mRefreshFileSize = -1;
+    mContentPackage = new SharedBuffer();
+    mPrefetcher = 0;
+    mHintReadRanges = true;
+    mHintedStart = -1;
+    mHintedEnd = -1;
 
 
     // get ImageStartOffset and ImageEndOffset properties which are used in Avid uncompressed files
@@ -284,21 +300,29 @@ EssenceReader::EssenceReader(MXFFileReader *file_reader, bool file_is_complete,
     // if file is complete then read the index table segments, essence container layout and
     // determine the essence wrapping type
     if (file_is_complete) {
-        if (mFileReader->mIndexSID)
-            mIndexTableHelper.ExtractIndexTable();
-
-        // first edit unit size is used to determine the essence wrapping type
-        int64_t first_edit_unit_size = 0;
-        if (mIndexTableHelper.HaveEditUnitSize(0)) {
-            int64_t offset;
-            mIndexTableHelper.GetEditUnit(0, &offset, &first_edit_unit_size);
-        }
-        mEssenceChunkHelper.CreateEssenceChunkIndex(first_edit_unit_size);
-        BMX_ASSERT(mEssenceChunkHelper.IsComplete());
+        // the index table, essence container layout and wrapping type are restored from the cache if it is
+        // available and matches the file
+        MXFIndexCache *index_cache = mFileReader->mIndexCache;
+        if (!index_cache || !index_cache->Read(&mIndexTableHelper, &mEssenceChunkHelper)) {
+            if (mFileReader->mIndexSID)
+                mIndexTableHelper.ExtractIndexTable();
+
+            // first edit unit size is used to determine the essence wrapping type
+            int64_t first_edit_unit_size = 0;
+            if (mIndexTableHelper.HaveEditUnitSize(0)) {
+                int64_t offset;
+                mIndexTableHelper.GetEditUnit(0, &offset, &first_edit_unit_size);
+            }
+            mEssenceChunkHelper.CreateEssenceChunkIndex(first_edit_unit_size);
+            BMX_ASSERT(mEssenceChunkHelper.IsComplete());
+
+            // if the essence wrapping type still unknown then go with the guessed type
+            if (mFileReader->mWrappingType == MXF_UNKNOWN_WRAPPING_TYPE)
+                mFileReader->mWrappingType = mFileReader->mGuessedWrappingType;
 
-        // if the essence wrapping type still unknown then go with the guessed type
-        if (mFileReader->mWrappingType == MXF_UNKNOWN_WRAPPING_TYPE)
-            mFileReader->mWrappingType = mFileReader->mGuessedWrappingType;
+            if (index_cache)
+                index_cache->Write(&mIndexTableHelper, &mEssenceChunkHelper);
+        }
 
         if (mIndexTableHelper.IsComplete()) {
             BMX_CHECK(mIndexTableHelper.GetEditRate() == mFileReader->GetEditRate());
@@ -357,11 +381,15 @@ EssenceReader::EssenceReader(MXFFileReader *file_reader, bool file_is_complete,
         mReadDuration = mIndexTableHelper.GetDuration();
     else
         mReadDuration = INT64_MAX;
+
+    AdviseReadLimits();
 }
 
 EssenceReader::~EssenceReader()
 {
+    delete mPrefetcher;
     delete mFrameMetadataReader;
+    mContentPackage->Release();
 }
 
 void EssenceReader::SetReadLimits(int64_t start_position, int64_t duration)
@@ -382,6 +410,9 @@ void EssenceReader::SetReadLimits(int64_t start_position, int64_t duration)
         else
             mReadDuration = duration;
     }
+
+    ClearPrefetch();
+    AdviseReadLimits();
 }
 
 void EssenceReader::SetBufferFrames(bool enable)
@@ -389,6 +420,19 @@ void EssenceReader::SetBufferFrames(bool enable)
     mReadFrameBuffer.SetBufferFrames(enable);
 }
 
+void EssenceReader::SetReadAhead(uint32_t num_content_packages)
+{
+    if (mPrefetcher) {
+        delete mPrefetcher;
+        mPrefetcher = 0;
+        ResetState();
+    }
+
+    // content packages are read ahead in a separate thread for frame wrapped essence with a known size in the index
+    if (num_content_packages > 0 && mFileReader->IsFrameWrapped() && !mParseOnly && mFile->isSeekable())
+        mPrefetcher = new EssencePrefetcher(mFile, num_content_packages);
+}
+
 uint32_t EssenceReader::Read(uint32_t num_samples)
 {
     uint32_t actual_read_num_samples = 0;
@@ -469,6 +513,40 @@ void EssenceReader::Seek(int64_t position)
     mPosition = position;
 }
 
+void EssenceReader::Refresh()
+{
+    // clip wrapped essence is a single element and isn't scanned
+    if (IsComplete() || !mFileReader->IsFrameWrapped() || !mFile->isSeekable())
+        return;
+
+    // nothing to do if the file hasn't grown since the last refresh
+    int64_t file_size = mFile->size();
+    if (file_size == mRefreshFileSize)
+        return;
+    mRefreshFileSize = file_size;
+
+    // index content packages until the end of the data written so far is reached. The index is only
+    // extended by content packages that are followed by the start of the next content package or partition.
+    // A read failure is not fatal because SeekEssence resets the state so that the next read or refresh continues
+    // from the last known position
+    try
+    {
+        while (!mFileIsComplete) {
+            int64_t indexed_duration = mIndexTableHelper.GetDuration();
+            if (!SeekEssence(indexed_duration + 1) || mIndexTableHelper.GetDuration() == indexed_duration)
+                break;
+        }
+    }
+    catch (const MXFException &ex)
+    {
+        log_warn("Failed to index appended essence data: %s\n", ex.getMessage().c_str());
+    }
+    catch (const BMXException &ex)
+    {
+        log_warn("Failed to index appended essence data: %s\n", ex.what());
+    }
+}
+
 bool EssenceReader::GetIndexEntry(MXFIndexEntryExt *entry, int64_t position)
 {
     if (mIndexTableHelper.GetIndexEntry(entry, position)) {
@@ -570,6 +648,11 @@ uint32_t EssenceReader::ReadFrameWrappedSamples(uint32_t num_samples)
     map<uint32_t, MXFTrackReader*> enabled_track_readers;
     uint32_t i;
     for (i = 0; i < num_samples; i++) {
+        if (mPrefetcher && ReadPrefetchedContentPackage(start_position, &enabled_track_readers)) {
+            mPosition++;
+            continue;
+        }
+
         int64_t cp_file_position;
         int64_t size;
         if (!SeekEssence(mPosition))
@@ -587,6 +670,18 @@ uint32_t EssenceReader::ReadFrameWrappedSamples(uint32_t num_samples)
             cp_file_position = mFilePosition;
         }
 
+        // read the whole content package in a single read if the size is known
+        if (size > 0 && size <= UINT32_MAX && !mParseOnly) {
+            if (!mPrefetcher)
+                HintReadRanges();
+            // the prefetcher reads ahead the content packages that follow
+            uint32_t max_content_packages = (mPrefetcher ? 1 : num_samples - i);
+            uint32_t num_read = ReadContentPackages(start_position, cp_file_position, (uint32_t)size,
+                                                    max_content_packages, &enabled_track_readers);
+            i += num_read - 1;
+            continue;
+        }
+
         mxfKey key;
         uint8_t llen;
         uint64_t len;
@@ -599,39 +694,8 @@ uint32_t EssenceReader::ReadFrameWrappedSamples(uint32_t num_samples)
             bool processed_metadata = mFrameMetadataReader->ProcessFrameMetadata(&key, len);
 
             if (!processed_metadata && (mxf_is_gc_essence_element(&key) || mxf_avid_is_essence_element(&key))) {
-                uint32_t track_number = mxf_get_track_number(&key);
-                MXFTrackReader *track_reader = 0;
-                Frame *frame = 0;
-                if (enabled_track_readers.find(track_number) == enabled_track_readers.end()) {
-                    // frame does not yet exist - create it if track is enabled
-                    track_reader = mFileReader->GetInternalTrackReaderByNumber(track_number);
-                    if (start_position == mPosition && track_reader && track_reader->IsEnabled()) {
-                        frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
-
-                        BMX_CHECK(cp_num_read <= UINT32_MAX);
-
-                        frame->ec_position         = start_position;
-                        frame->cp_file_position    = cp_file_position;
-                        frame->file_position       = cp_file_position + cp_num_read - (mxfKey_extlen + llen);
-                        frame->kl_size             = mxfKey_extlen + llen;
-                        frame->file_id             = mFileReader->GetFileId();
-                        frame->element_key         = key;
-                        if (mIndexTableHelper.HaveEditUnit(start_position)) {
-                            frame->temporal_reordering =
-                                mIndexTableHelper.GetTemporalReordering((uint32_t)(cp_num_read - (mxfKey_extlen + llen)));
-                        }
-
-                        enabled_track_readers[track_number] = track_reader;
-                    } else {
-                        enabled_track_readers[track_number] = 0;
-                    }
-                } else {
-                    // frame exists if track is enabled - get it
-                    track_reader = enabled_track_readers[track_number];
-                    if (track_reader)
-                        frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
-                }
-
+                Frame *frame = GetElementFrame(&key, llen, start_position, cp_file_position,
+                                               cp_num_read - (mxfKey_extlen + llen), &enabled_track_readers);
                 if (frame) {
                     BMX_CHECK(len <= UINT32_MAX);
                     frame->Grow((uint32_t)len);
@@ -670,6 +734,209 @@ uint32_t EssenceReader::ReadFrameWrappedSamples(uint32_t num_samples)
     return num_samples;
 }
 
+uint32_t EssenceReader::ReadContentPackages(int64_t start_position, int64_t cp_file_position, uint32_t size,
+                                            uint32_t max_content_packages,
+                                            map<uint32_t, MXFTrackReader*> *enabled_track_readers)
+{
+    // extend the read to the indexed content packages that follow contiguously in the file so that they are
+    // all read into a single buffer using a single read
+    vector<uint32_t> cp_sizes;
+    cp_sizes.push_back(size);
+    uint32_t total_size = size;
+    int64_t next_file_position = cp_file_position + size;
+    while (cp_sizes.size() < max_content_packages && total_size < MAX_BATCH_READ_SIZE) {
+        int64_t file_position;
+        uint32_t next_size;
+        if (!GetPrefetchEditUnit(mPosition + (int64_t)cp_sizes.size(), &file_position, &next_size) ||
+            file_position != next_file_position ||
+            next_size > MAX_BATCH_READ_SIZE - total_size)
+        {
+            break;
+        }
+        cp_sizes.push_back(next_size);
+        total_size += next_size;
+        next_file_position += next_size;
+    }
+
+    // frames may still be referencing the previous content package's data
+    if (mContentPackage->IsShared()) {
+        mContentPackage->Release();
+        mContentPackage = new SharedBuffer();
+    }
+    ByteArray *cp_buffer = mContentPackage->GetData();
+
+    try
+    {
+        if (mFile->tell() != cp_file_position)
+            mFile->seek(cp_file_position, SEEK_SET);
+
+        cp_buffer->Allocate(total_size);
+        uint32_t num_read = mFile->read(cp_buffer->GetBytes(), total_size);
+        if (num_read != total_size) {
+            if (cp_sizes.size() > 1) {
+                BMX_EXCEPTION(("Failed to read %" PRIszt " content packages (size 0x%x) at file position 0x%" PRIx64,
+                               cp_sizes.size(), total_size, cp_file_position));
+            } else {
+                BMX_EXCEPTION(("Failed to read content package (size 0x%x) at file position 0x%" PRIx64,
+                               total_size, cp_file_position));
+            }
+        }
+        cp_buffer->SetSize(total_size);
+    }
+    catch (...)
+    {
+        ResetState();
+        mBaseReadError = true;
+        throw;
+    }
+    ResetState();
+
+    uint32_t buffer_offset = 0;
+    size_t i;
+    for (i = 0; i < cp_sizes.size(); i++) {
+        ParseContentPackage(start_position, cp_file_position + buffer_offset, buffer_offset, cp_sizes[i],
+                            enabled_track_readers);
+        buffer_offset += cp_sizes[i];
+        mPosition++;
+    }
+
+    return (uint32_t)cp_sizes.size();
+}
+
+bool EssenceReader::ReadPrefetchedContentPackage(int64_t start_position,
+                                                 map<uint32_t, MXFTrackReader*> *enabled_track_readers)
+{
+    // drop the read ahead content packages if not reading sequentially
+    if (!mPrefetcher->IsNext(mPosition))
+        ClearPrefetch();
+
+    int64_t next_position = mPrefetcher->GetLastPosition() + 1;
+    if (next_position <= mPosition)
+        next_position = mPosition;
+    while (!mPrefetcher->IsFull() && next_position < mReadStartPosition + mReadDuration) {
+        int64_t file_position;
+        uint32_t size;
+        if (!GetPrefetchEditUnit(next_position, &file_position, &size))
+            break;
+        mPrefetcher->Request(next_position, file_position, size);
+        next_position++;
+    }
+    if (!mPrefetcher->IsNext(mPosition))
+        return false;
+
+    int64_t cp_file_position;
+    uint32_t size;
+    SharedBuffer *content_package;
+    try
+    {
+        content_package = mPrefetcher->Take(mPosition, &cp_file_position, &size);
+    }
+    catch (...)
+    {
+        ResetState();
+        mBaseReadError = true;
+        throw;
+    }
+    ResetState();
+
+    mPrefetcher->Recycle(mContentPackage);
+    mContentPackage = content_package;
+
+    ParseContentPackage(start_position, cp_file_position, 0, size, enabled_track_readers);
+
+    return true;
+}
+
+void EssenceReader::ParseContentPackage(int64_t start_position, int64_t cp_file_position, uint32_t buffer_offset,
+                                        uint32_t size, map<uint32_t, MXFTrackReader*> *enabled_track_readers)
+{
+    const unsigned char *cp_data = mContentPackage->GetData()->GetBytes() + buffer_offset;
+    mxfKey key;
+    uint8_t llen;
+    uint64_t len;
+    uint32_t cp_num_read = 0;
+    while (cp_num_read < size) {
+        uint32_t element_offset = cp_num_read;
+        if (!get_kl(&cp_data[cp_num_read], size - cp_num_read, &key, &llen, &len) ||
+            len > size - cp_num_read - (mxfKey_extlen + llen))
+        {
+            BMX_EXCEPTION(("Content package element at file position 0x%" PRIx64 " exceeds "
+                           "content package size in index (0x%x)",
+                           cp_file_position + element_offset, size));
+        }
+        if (element_offset == 0) {
+            if (mEssenceStartKey == g_Null_Key)
+                mEssenceStartKey = key;
+            else if (key != mEssenceStartKey)
+                BMX_EXCEPTION(("First element in content package has different key than before"));
+        } else if (mxf_equals_key(&key, &mEssenceStartKey) || mxf_is_partition_pack(&key)) {
+            BMX_EXCEPTION(("Read content package size (0x%x) does not match size in index (0x%x) "
+                           "at file position 0x%" PRIx64,
+                           element_offset, size, cp_file_position));
+        }
+        cp_num_read += mxfKey_extlen + llen;
+
+        const unsigned char *value = &cp_data[cp_num_read];
+        bool processed_metadata = mFrameMetadataReader->ProcessFrameMetadata(&key, value, len);
+
+        if (!processed_metadata && (mxf_is_gc_essence_element(&key) || mxf_avid_is_essence_element(&key))) {
+            Frame *frame = GetElementFrame(&key, llen, start_position, cp_file_position, element_offset,
+                                           enabled_track_readers);
+            if (frame) {
+                SharedBufferFrame *shared_frame = dynamic_cast<SharedBufferFrame*>(frame);
+                if (shared_frame && frame->GetSize() == 0) {
+                    shared_frame->SetSharedData(mContentPackage, buffer_offset + cp_num_read, (uint32_t)len);
+                } else {
+                    frame->Grow((uint32_t)len);
+                    memcpy(frame->GetBytesAvailable(), value, (uint32_t)len);
+                    frame->IncrementSize((uint32_t)len);
+                }
+                frame->num_samples++;
+            }
+        }
+
+        cp_num_read += (uint32_t)len;
+    }
+}
+
+Frame* EssenceReader::GetElementFrame(const mxfKey *key, uint8_t llen, int64_t start_position,
+                                      int64_t cp_file_position, int64_t element_offset,
+                                      map<uint32_t, MXFTrackReader*> *enabled_track_readers)
+{
+    uint32_t track_number = mxf_get_track_number(key);
+    MXFTrackReader *track_reader = 0;
+    Frame *frame = 0;
+    if (enabled_track_readers->find(track_number) == enabled_track_readers->end()) {
+        // frame does not yet exist - create it if track is enabled
+        track_reader = mFileReader->GetInternalTrackReaderByNumber(track_number);
+        if (start_position == mPosition && track_reader && track_reader->IsEnabled()) {
+            frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
+
+            BMX_CHECK(element_offset <= UINT32_MAX);
+
+            frame->ec_position         = start_position;
+            frame->cp_file_position    = cp_file_position;
+            frame->file_position       = cp_file_position + element_offset;
+            frame->kl_size             = mxfKey_extlen + llen;
+            frame->file_id             = mFileReader->GetFileId();
+            frame->element_key         = *key;
+            if (mIndexTableHelper.HaveEditUnit(start_position))
+                frame->temporal_reordering = mIndexTableHelper.GetTemporalReordering((uint32_t)element_offset);
+
+            (*enabled_track_readers)[track_number] = track_reader;
+        } else {
+            (*enabled_track_readers)[track_number] = 0;
+        }
+    } else {
+        // frame exists if track is enabled - get it
+        track_reader = (*enabled_track_readers)[track_number];
+        if (track_reader)
+            frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
+    }
+
+    return frame;
+}
+
 void EssenceReader::GetEditUnit(int64_t position, mxfKey *element_key, int64_t *file_position, int64_t *size)
 {
     int64_t essence_offset, essence_size;
@@ -789,8 +1056,94 @@ uint32_t EssenceReader::GetConstantEditUnitSize()
     return edit_unit_size;
 }
 
+void EssenceReader::AdviseReadLimits()
+{
+    if (mReadDuration <= 0 || !mIndexTableHelper.IsComplete())
+        return;
+
+    // hint the file range that is going to be read to a memory-mapped file
+    int64_t last_position = mReadStartPosition + mReadDuration - 1;
+    int64_t start_file_position = GetIndexedFilePosition(mReadStartPosition);
+    int64_t last_file_position = GetIndexedFilePosition(last_position);
+    if (start_file_position < 0 || last_file_position < 0 || !mIndexTableHelper.HaveEditUnit(last_position))
+        return;
+
+    int64_t last_offset, last_size;
+    mIndexTableHelper.GetEditUnit(last_position, &last_offset, &last_size);
+    mxf_mmap_file_advise_read_range(mFile->getCFile(), start_file_position, last_file_position + last_size);
+}
+
+bool EssenceReader::GetPrefetchEditUnit(int64_t position, int64_t *file_position, uint32_t *size)
+{
+    if (!mIndexTableHelper.HaveEditUnit(position) || !mIndexTableHelper.HaveEditUnitSize(position))
+        return false;
+
+    // loading an index table segment reads the file and so the prefetcher's thread must not be using it
+    if (mIndexTableHelper.RequireSegmentLoad(position) || mIndexTableHelper.RequireSegmentLoad(position + 1))
+        ClearPrefetch();
+
+    int64_t cp_file_position = GetIndexedFilePosition(position);
+    if (cp_file_position < 0)
+        return false;
+
+    int64_t offset, cp_size;
+    mIndexTableHelper.GetEditUnit(position, &offset, &cp_size);
+    if (cp_size <= 0 || cp_size > UINT32_MAX)
+        return false;
+
+    *file_position = cp_file_position;
+    *size = (uint32_t)cp_size;
+    return true;
+}
+
+void EssenceReader::ClearPrefetch()
+{
+    // the file is only accessed by the prefetcher's thread whilst it has requests
+    if (mPrefetcher)
+        mPrefetcher->Clear();
+}
+
+void EssenceReader::HintReadRanges()
+{
+    if (!mHintReadRanges)
+        return;
+
+    // hint the content packages that will be read next to a HTTP file so that it can fetch them in parallel.
+    // The hints are renewed once half of them have been read
+    static const int64_t num_hint_positions = 16;
+    if (mPosition >= mHintedStart && mPosition < mHintedEnd - num_hint_positions / 2)
+        return;
+
+    vector<pair<int64_t, uint32_t> > ranges;
+    int64_t end_position = mPosition + num_hint_positions;
+    if (mReadDuration > 0 && end_position > mReadStartPosition + mReadDuration)
+        end_position = mReadStartPosition + mReadDuration;
+    int64_t position;
+    for (position = mPosition; position < end_position; position++) {
+        int64_t file_position;
+        uint32_t size;
+        if (!GetPrefetchEditUnit(position, &file_position, &size))
+            break;
+        if (!ranges.empty() && ranges.back().first + ranges.back().second == file_position &&
+            ranges.back().second <= UINT32_MAX - size)
+        {
+            ranges.back().second += size;
+        }
+        else
+        {
+            ranges.push_back(make_pair(file_position, size));
+        }
+    }
+
+    mHintReadRanges = mxf_http_file_hint_ranges(mFile->getCFile(), ranges);
+    mHintedStart = mPosition;
+    mHintedEnd = position;
+}
+
 bool EssenceReader::SeekEssence(int64_t base_position)
 {
+    ClearPrefetch();
+
     try
     {
         BMX_ASSERT(base_position >= 0);
@@ -61,9 +61,8 @@ static const mxfKey ESSENCE_MARK_UTF16_KEY =
 
 
 
-SystemScheme1Reader::SystemScheme1Reader(File *file, Rational frame_rate, bool is_bbc_preservation_file)
+SystemScheme1Reader::SystemScheme1Reader(Rational frame_rate, bool is_bbc_preservation_file)
 {
-    mFile = file;
     mFrameRate = frame_rate;
     mIsBBCPreservationFile = is_bbc_preservation_file;
     mTimecodeArray = 0;
@@ -82,11 +81,15 @@ void SystemScheme1Reader::Reset()
     mTrackNumbers.clear();
 }
 
-bool SystemScheme1Reader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
+bool SystemScheme1Reader::IsFrameMetadata(const mxfKey *key)
 {
-    if (!mxf_equals_key_prefix(key, &SS1_KEY_PREFIX, 14) ||
-        (key->octet14 != 0x01 && key->octet14 != 0x02))
-    {
+    return mxf_equals_key_prefix(key, &SS1_KEY_PREFIX, 14) &&
+           (key->octet14 == 0x01 || key->octet14 == 0x02);
+}
+
+bool SystemScheme1Reader::ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len)
+{
+    if (!IsFrameMetadata(key)) {
         if (mxf_is_gc_essence_element(key))
             mTrackNumbers.push_back(mxf_get_track_number(key));
         return false;
@@ -95,8 +98,13 @@ bool SystemScheme1Reader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
     uint64_t read_count = 0;
     uint16_t tag, tag_len;
     while (read_count < len) {
-        mFile->readLocalTL(&tag, &tag_len);
+        BMX_CHECK_M(read_count + 4 <= len,
+                    ("System scheme 1 element length mismatch"));
+        mxf_get_uint16(&value[read_count],     &tag);
+        mxf_get_uint16(&value[read_count + 2], &tag_len);
         read_count += 4;
+        BMX_CHECK_M(read_count + tag_len <= len,
+                    ("System scheme 1 element length mismatch"));
 
         switch (tag)
         {
@@ -106,18 +114,20 @@ bool SystemScheme1Reader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
                             ("Unexpected system scheme 1 timecode array data item length %u", len));
 
                 uint32_t array_len, element_len;
-                mFile->readBatchHeader(&array_len, &element_len);
+                mxf_get_array_header(&value[read_count], &array_len, &element_len);
                 read_count += 8;
 
                 SMPTE12MTimecode s12m;
                 BMX_CHECK_M(array_len == 0 || element_len == sizeof(s12m.bytes),
                             ("Unexpected system scheme 1 timecode array element length %u", element_len));
+                BMX_CHECK_M(8 + (uint64_t)array_len * element_len <= tag_len,
+                            ("Unexpected system scheme 1 timecode array data item length %u", len));
 
                 uint32_t i;
                 for (i = 0; i < array_len; i++) {
                     if (!mTimecodeArray)
                         mTimecodeArray = new SS1TimecodeArray(mFrameRate, mIsBBCPreservationFile);
-                    BMX_CHECK(mFile->read(s12m.bytes, sizeof(s12m.bytes)) == sizeof(s12m.bytes));
+                    memcpy(s12m.bytes, &value[read_count], sizeof(s12m.bytes));
                     read_count += sizeof(s12m.bytes);
                     mTimecodeArray->mS12MTimecodes.push_back(s12m);
                 }
@@ -129,23 +139,26 @@ bool SystemScheme1Reader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
                                 ("Unexpected BBC preservation CRC-32 array data item length %u", len));
 
                     uint32_t array_len, element_len;
-                    mFile->readBatchHeader(&array_len, &element_len);
+                    mxf_get_array_header(&value[read_count], &array_len, &element_len);
                     read_count += 8;
 
                     BMX_CHECK_M(array_len == 0 || element_len == 4,
                                 ("Unexpected BBC preservation CRC-32 array element length %u", element_len));
+                    BMX_CHECK_M(8 + (uint64_t)array_len * element_len <= tag_len,
+                                ("Unexpected BBC preservation CRC-32 array data item length %u", len));
 
                     uint32_t crc32;
                     uint32_t i;
                     for (i = 0; i < array_len; i++) {
-                        crc32 = mFile->readUInt32();
+                        mxf_get_uint32(&value[read_count], &crc32);
                         read_count += 4;
                         mCRC32s.push_back(crc32);
                     }
+                } else {
+                    read_count += tag_len;
                 }
                 break;
             default:
-                mFile->skip(tag_len);
                 read_count += tag_len;
                 break;
         }
@@ -174,9 +187,8 @@ void SystemScheme1Reader::InsertFrameMetadata(Frame *frame, uint32_t track_numbe
 
 
 
-SDTICPSystemMetadataReader::SDTICPSystemMetadataReader(File *file)
+SDTICPSystemMetadataReader::SDTICPSystemMetadataReader()
 {
-    mFile = file;
     mMetadata = 0;
 }
 
@@ -191,9 +203,14 @@ void SDTICPSystemMetadataReader::Reset()
     mMetadata = 0;
 }
 
-bool SDTICPSystemMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
+bool SDTICPSystemMetadataReader::IsFrameMetadata(const mxfKey *key)
 {
-    if (!mxf_equals_key(key, &MXF_EE_K(SDTI_CP_System_Pack)))
+    return mxf_equals_key(key, &MXF_EE_K(SDTI_CP_System_Pack));
+}
+
+bool SDTICPSystemMetadataReader::ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len)
+{
+    if (!IsFrameMetadata(key))
         return false;
 
     delete mMetadata;
@@ -205,7 +222,7 @@ bool SDTICPSystemMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64_
     uint32_t num_read = sizeof(bytes);
     if (num_read > len)
         num_read = (uint32_t)len;
-    BMX_CHECK(mFile->read(bytes, num_read) == num_read);
+    memcpy(bytes, value, num_read);
 
     // Package Rate. See SMPTE ST 326, section 7.2
     // b6 and b7 not defined; b1-b5, rate per second; b0, 1 or 1.001 factor flag
@@ -253,9 +270,8 @@ void SDTICPSystemMetadataReader::InsertFrameMetadata(Frame *frame, uint32_t trac
 
 
 
-SDTICPPackageMetadataReader::SDTICPPackageMetadataReader(File *file)
+SDTICPPackageMetadataReader::SDTICPPackageMetadataReader()
 {
-    mFile = file;
     mMetadata = 0;
 }
 
@@ -270,9 +286,14 @@ void SDTICPPackageMetadataReader::Reset()
     mMetadata = 0;
 }
 
-bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
+bool SDTICPPackageMetadataReader::IsFrameMetadata(const mxfKey *key)
+{
+    return mxf_equals_key_prefix(key, &SDTI_CP_PACKAGE_META_KEY_PREFIX, 15);
+}
+
+bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len)
 {
-    if (!mxf_equals_key_prefix(key, &SDTI_CP_PACKAGE_META_KEY_PREFIX, 15))
+    if (!IsFrameMetadata(key))
         return false;
 
     delete mMetadata;
@@ -281,11 +302,14 @@ bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64
     uint64_t read_count = 0;
     uint8_t block_tag;
     uint16_t item_len;
-    ByteArray value;
     while (read_count < len) {
-        block_tag = mFile->readUInt8();
-        item_len = mFile->readUInt16();
+        BMX_CHECK_M(read_count + 3 <= len,
+                    ("System item package metadata pack length mismatch"));
+        mxf_get_uint8(&value[read_count],      &block_tag);
+        mxf_get_uint16(&value[read_count + 1], &item_len);
         read_count += 3;
+        BMX_CHECK_M(read_count + item_len <= len,
+                    ("System item package metadata pack length mismatch"));
 
         switch (block_tag)
         {
@@ -293,7 +317,7 @@ bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64
             {
                 BMX_CHECK_M(item_len == 32 || item_len == 64,
                             ("Unexpected item len %u for UMID in system item package metadata", item_len));
-                BMX_CHECK(mFile->read(mMetadata->mUMID.bytes, item_len) == item_len);
+                memcpy(mMetadata->mUMID.bytes, &value[read_count], item_len);
                 mMetadata->mHaveUMID = true;
                 read_count += item_len;
                 break;
@@ -305,23 +329,18 @@ bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64
                 mxfKey key;
                 uint64_t len;
                 uint8_t llen;
-                mFile->readKL(&key, &llen, &len);
-                BMX_CHECK_M(item_len == 16 + llen + len,
+                BMX_CHECK_M(get_kl(&value[read_count], item_len, &key, &llen, &len) &&
+                                item_len == 16 + llen + len,
                             ("Unexpected item len %u for KLV in system item package metadata", item_len));
                 uint16_t u16_len = (uint16_t)len;
+                const unsigned char *item_value = &value[read_count + 16 + llen];
 
                 if (u16_len > 0) {
                     if (mxf_equals_key(&key, &ESSENCE_MARK_ISO7BIT_KEY)) {
-                        value.Allocate(u16_len + 1);
-                        mFile->read(value.GetBytes(), u16_len);
-                        value.GetBytes()[u16_len] = 0;
-                        mMetadata->mEssenceMark = (char*)value.GetBytes();
+                        mMetadata->mEssenceMark.assign((const char*)item_value,
+                                                       strnlen((const char*)item_value, u16_len));
                     } else if (mxf_equals_key(&key, &ESSENCE_MARK_UTF16_KEY)) {
-                        value.Allocate(u16_len);
-                        mFile->read(value.GetBytes(), u16_len);
-                        mMetadata->mEssenceMark = convert_utf16_string(value.GetBytes(), u16_len);
-                    } else {
-                        mFile->skip(u16_len);
+                        mMetadata->mEssenceMark = convert_utf16_string(item_value, u16_len);
                     }
                 }
 
@@ -329,7 +348,6 @@ bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64
                 break;
             }
             default:
-                mFile->skip(item_len);
                 read_count += item_len;
                 break;
         }
@@ -362,10 +380,11 @@ FrameMetadataReader::FrameMetadataReader(MXFFileReader *file_reader)
         }
     }
 
-    mReaders.push_back(new SystemScheme1Reader(file_reader->mFile, file_reader->GetEditRate(),
-                                               is_bbc_preservation_file));
-    mReaders.push_back(new SDTICPSystemMetadataReader(file_reader->mFile));
-    mReaders.push_back(new SDTICPPackageMetadataReader(file_reader->mFile));
+    mFile = file_reader->mFile;
+
+    mReaders.push_back(new SystemScheme1Reader(file_reader->GetEditRate(), is_bbc_preservation_file));
+    mReaders.push_back(new SDTICPSystemMetadataReader());
+    mReaders.push_back(new SDTICPPackageMetadataReader());
 }
 
 FrameMetadataReader::~FrameMetadataReader()
@@ -383,11 +402,29 @@ void FrameMetadataReader::Reset()
 }
 
 bool FrameMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
+{
+    // read the value into a buffer if it is metadata that will be processed
+    const unsigned char *value = 0;
+    size_t i;
+    for (i = 0; i < mReaders.size(); i++) {
+        if (mReaders[i]->IsFrameMetadata(key)) {
+            BMX_CHECK(len <= UINT32_MAX);
+            mValueBuffer.Allocate((uint32_t)len);
+            BMX_CHECK(mFile->read(mValueBuffer.GetBytes(), (uint32_t)len) == len);
+            value = mValueBuffer.GetBytes();
+            break;
+        }
+    }
+
+    return ProcessFrameMetadata(key, value, len);
+}
+
+bool FrameMetadataReader::ProcessFrameMetadata(const mxfKey *key, const unsigned char *value, uint64_t len)
 {
     bool result = false;
     size_t i;
     for (i = 0; i < mReaders.size(); i++) {
-        if (mReaders[i]->ProcessFrameMetadata(key, len))
+        if (mReaders[i]->ProcessFrameMetadata(key, value, len))
             result = true;
     }
     return result;
@@ -39,12 +39,15 @@
 #include <cstdio>
 #include <cstring>
 
+#include <algorithm>
+
 #include <libMXF++/MXF.h>
 
 #include <mxf/mxf_avid.h>
 
 #include <bmx/mxf_reader/IndexTableHelper.h>
 #include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/mxf_reader/MXFIndexCache.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -54,16 +57,8 @@ using namespace bmx;
 using namespace mxfpp;
 
 
-// temporal offset (1) + key frame offset (1) + flags (1) + stream offset (8)
-#define INTERNAL_INDEX_ENTRY_SIZE   11
-
 #define RUNTIME_INDEX_SEGMENT_SIZE  1500
 
-#define GET_TEMPORAL_OFFSET(pos)    (*((int8_t*)&mIndexEntries[(pos) * INTERNAL_INDEX_ENTRY_SIZE]))
-#define GET_KEY_FRAME_OFFSET(pos)   (*((int8_t*)&mIndexEntries[(pos) * INTERNAL_INDEX_ENTRY_SIZE + 1]))
-#define GET_FLAGS(pos)              (*((uint8_t*)&mIndexEntries[(pos) * INTERNAL_INDEX_ENTRY_SIZE + 2]))
-#define GET_STREAM_OFFSET(pos)      (*((int64_t*)&mIndexEntries[(pos) * INTERNAL_INDEX_ENTRY_SIZE + 3]))
-
 #define SEG_END(seg)    (seg->getIndexStartPosition() + seg->getIndexDuration())
 #define SEG_START(seg)  (seg->getIndexStartPosition())
 #define SEG_DUR(seg)    (seg->getIndexDuration())
@@ -88,12 +83,26 @@ static int add_frame_offset_index_entry(void *data, uint32_t num_entries, MXFInd
     return 1;
 }
 
+static int add_delta_entry(void *data, uint32_t num_entries, MXFIndexTableSegment *segment, int8_t pos_table_index,
+                           uint8_t slice, uint32_t element_delta)
+{
+    IndexTableHelperSegment *helper = static_cast<IndexTableHelperSegment*>(data);
+
+    // the delta entries are recorded so that they can be written to an index cache
+    helper->AppendDeltaEntry(pos_table_index, slice, element_delta);
+
+    return mxf_default_add_delta_entry(0, num_entries, segment, pos_table_index, slice, element_delta);
+}
+
 
 
 IndexTableHelperSegment::IndexTableHelperSegment()
 : IndexTableSegment()
 {
-    mIndexEntries = 0;
+    mStreamOffsets = 0;
+    mTemporalOffsets = 0;
+    mKeyFrameOffsets = 0;
+    mFlags = 0;
     mAllocIndexEntries = 0;
     mNumIndexEntries = 0;
     mEntriesStart = 0;
@@ -102,11 +111,13 @@ IndexTableHelperSegment::IndexTableHelperSegment()
     mIndexEndOffset = 0;
     mEssenceStartOffset = 0;
     mIsFileIndexSegment = false;
+    mIsLoaded = true;
+    mFilePosition = -1;
 }
 
 IndexTableHelperSegment::~IndexTableHelperSegment()
 {
-    delete [] mIndexEntries;
+    FreeIndexEntries();
 }
 
 void IndexTableHelperSegment::ReadIndexTableSegment(File *file, uint64_t segment_len)
@@ -115,10 +126,11 @@ void IndexTableHelperSegment::ReadIndexTableSegment(File *file, uint64_t segment
 
     // free existing segment which will be replaced
     mxf_free_index_table_segment(&_cSegment);
+    mDeltaEntries.clear();
 
     // use Avid function to support non-standard Avid index table segments
     BMX_CHECK(mxf_avid_read_index_table_segment_2(file->getCFile(), segment_len,
-                                                  mxf_default_add_delta_entry, 0,
+                                                  add_delta_entry, this,
                                                   add_frame_offset_index_entry, this,
                                                   &_cSegment));
 }
@@ -158,7 +170,7 @@ void IndexTableHelperSegment::ProcessIndexTableSegment(Rational expected_edit_ra
 
     if (mNumIndexEntries > 1 && mNumIndexEntries > getIndexDuration()) {
         // Avid adds an extra entry which provides the end offset or size for the last frame
-        if (GET_STREAM_OFFSET(0) == GET_STREAM_OFFSET(1)) {
+        if (mStreamOffsets[0] == mStreamOffsets[1]) {
             // eg. Avid MPEG-2 Long GOP (eg. XDCAM) has 2 identical entries per frame
             mHavePairedIndexEntries = true;
             if (getIndexDuration() * 2 > mNumIndexEntries) {
@@ -179,13 +191,148 @@ void IndexTableHelperSegment::ProcessIndexTableSegment(Rational expected_edit_ra
             }
             if (mNumIndexEntries > getIndexDuration() * 2) {
                 mHaveExtraIndexEntries = true;
-                mIndexEndOffset = GET_STREAM_OFFSET(getIndexDuration() * 2);
+                mIndexEndOffset = mStreamOffsets[getIndexDuration() * 2];
             }
         } else {
             mHaveExtraIndexEntries = true;
-            mIndexEndOffset = GET_STREAM_OFFSET(getIndexDuration());
+            mIndexEndOffset = mStreamOffsets[getIndexDuration()];
+        }
+    }
+}
+
+void IndexTableHelperSegment::ReadIndexTableSegmentInfo(File *file, uint64_t segment_len,
+                                                        uint32_t *num_index_entries)
+{
+    MXFFile *mxf_file = file->getCFile();
+    mxfLocalTag local_tag;
+    uint16_t local_len;
+    uint64_t total_len = 0;
+    mxfRational edit_rate;
+    int64_t int64_value;
+    uint32_t uint32_value;
+
+    mIsFileIndexSegment = true;
+    *num_index_entries = 0;
+
+    while (total_len < segment_len) {
+        BMX_CHECK(mxf_read_local_tl(mxf_file, &local_tag, &local_len));
+        total_len += 4;
+
+        switch (local_tag)
+        {
+            case 0x3f0b: // IndexEditRate
+                BMX_CHECK(local_len == 8);
+                BMX_CHECK(mxf_read_int32(mxf_file, &edit_rate.numerator));
+                BMX_CHECK(mxf_read_int32(mxf_file, &edit_rate.denominator));
+                setIndexEditRate(edit_rate);
+                total_len += local_len;
+                break;
+            case 0x3f0c: // IndexStartPosition
+                BMX_CHECK(local_len == 8);
+                BMX_CHECK(mxf_read_int64(mxf_file, &int64_value));
+                setIndexStartPosition(int64_value);
+                total_len += local_len;
+                break;
+            case 0x3f0d: // IndexDuration
+                BMX_CHECK(local_len == 8);
+                BMX_CHECK(mxf_read_int64(mxf_file, &int64_value));
+                setIndexDuration(int64_value);
+                total_len += local_len;
+                break;
+            case 0x3f05: // EditUnitByteCount
+                BMX_CHECK(local_len == 4);
+                BMX_CHECK(mxf_read_uint32(mxf_file, &uint32_value));
+                setEditUnitByteCount(uint32_value);
+                total_len += local_len;
+                break;
+            case 0x3f09: // DeltaEntryArray
+            {
+                // the delta entries are read so that GetTemporalReordering doesn't require the segment to be loaded
+                uint32_t array_len;
+                uint32_t array_item_len;
+                BMX_CHECK(mxf_read_uint32(mxf_file, &array_len));
+                BMX_CHECK(mxf_read_uint32(mxf_file, &array_item_len));
+                BMX_CHECK(array_len == 0 || array_item_len >= 6);
+                uint32_t i;
+                for (i = 0; i < array_len; i++) {
+                    uint8_t pos_table_index;
+                    uint8_t slice;
+                    uint32_t element_delta;
+                    BMX_CHECK(mxf_read_uint8(mxf_file, &pos_table_index));
+                    BMX_CHECK(mxf_read_uint8(mxf_file, &slice));
+                    BMX_CHECK(mxf_read_uint32(mxf_file, &element_delta));
+                    if (array_item_len > 6)
+                        BMX_CHECK(mxf_skip(mxf_file, array_item_len - 6));
+                    appendDeltaEntry((int8_t)pos_table_index, slice, element_delta);
+                    AppendDeltaEntry((int8_t)pos_table_index, slice, element_delta);
+                }
+                total_len += 8 + (uint64_t)array_len * array_item_len;
+                break;
+            }
+            case 0x3f0a: // IndexEntryArray
+            {
+                // use the array header because Avid index entry arrays can exceed the 16-bit local length
+                uint32_t array_len;
+                uint32_t array_item_len;
+                BMX_CHECK(mxf_read_uint32(mxf_file, &array_len));
+                BMX_CHECK(mxf_read_uint32(mxf_file, &array_item_len));
+                BMX_CHECK(mxf_skip(mxf_file, (uint64_t)array_len * array_item_len));
+                total_len += 8 + (uint64_t)array_len * array_item_len;
+                *num_index_entries = array_len;
+                break;
+            }
+            default:
+                BMX_CHECK(mxf_skip(mxf_file, local_len));
+                total_len += local_len;
+                break;
         }
     }
+
+    BMX_CHECK_M(total_len == segment_len,
+                ("Index table segment local set length %" PRIu64 " does not match KLV length %" PRIu64,
+                 total_len, segment_len));
+}
+
+void IndexTableHelperSegment::SetUnloaded(int64_t file_position)
+{
+    BMX_ASSERT(!mStreamOffsets);
+
+    mIsLoaded = false;
+    mFilePosition = file_position;
+}
+
+void IndexTableHelperSegment::Load(File *file)
+{
+    BMX_ASSERT(!mIsLoaded);
+
+    Rational edit_rate = getIndexEditRate();
+    int64_t start_position = getIndexStartPosition();
+    int64_t duration = getIndexDuration();
+
+    mxfKey key;
+    uint8_t llen;
+    uint64_t len;
+    file->seek(mFilePosition, SEEK_SET);
+    file->readKL(&key, &llen, &len);
+    BMX_CHECK(mxf_is_index_table_segment(&key));
+
+    ReadIndexTableSegment(file, len);
+    ProcessIndexTableSegment(edit_rate);
+    BMX_CHECK_M(getIndexStartPosition() == start_position && getIndexDuration() == duration &&
+                (int64_t)mNumIndexEntries == duration && !mHavePairedIndexEntries,
+                ("Index table segment at file position 0x%" PRIx64 " changed when it was loaded", mFilePosition));
+
+    mIsLoaded = true;
+}
+
+void IndexTableHelperSegment::Unload()
+{
+    BMX_ASSERT(mFilePosition >= 0);
+
+    FreeIndexEntries();
+    mNumIndexEntries = 0;
+    mEntriesStart = 0;
+    mIsLoaded = false;
 }
 
 int IndexTableHelperSegment::GetEditUnit(int64_t position, int8_t *temporal_offset, int8_t *key_frame_offset,
@@ -197,6 +344,8 @@ int IndexTableHelperSegment::GetEditUnit(int64_t position, int8_t *temporal_offs
         return position < getIndexStartPosition() ? -2 : -1;
     }
 
+    BMX_ASSERT(mIsLoaded);
+
     int64_t rel_position = position - getIndexStartPosition();
     if (mNumIndexEntries == 0) {
         *temporal_offset  = 0;
@@ -207,10 +356,11 @@ int IndexTableHelperSegment::GetEditUnit(int64_t position, int8_t *temporal_offs
         if (mHavePairedIndexEntries)
             rel_position *= 2;
 
-        *temporal_offset  = GET_TEMPORAL_OFFSET(rel_position);
-        *key_frame_offset = GET_KEY_FRAME_OFFSET(rel_position);
-        *flags            = GET_FLAGS(rel_position);
-        *stream_offset    = GET_STREAM_OFFSET(rel_position);
+        rel_position += mEntriesStart;
+        *temporal_offset  = mTemporalOffsets[rel_position];
+        *key_frame_offset = mKeyFrameOffsets[rel_position];
+        *flags            = mFlags[rel_position];
+        *stream_offset    = mStreamOffsets[rel_position];
 
         if (mHavePairedIndexEntries) {
             *temporal_offset  /= 2;
@@ -229,19 +379,18 @@ bool IndexTableHelperSegment::CanAppendIndexEntry() const
 void IndexTableHelperSegment::AppendIndexEntry(uint32_t num_entries, int8_t temporal_offset, int8_t key_frame_offset,
                                                uint8_t flags, int64_t stream_offset)
 {
-    if (!mIndexEntries) {
+    if (!mStreamOffsets) {
         BMX_CHECK(num_entries > 0);
-        mIndexEntries = new unsigned char[INTERNAL_INDEX_ENTRY_SIZE * num_entries];
-        mAllocIndexEntries = num_entries;
+        AllocIndexEntries(num_entries);
     }
 
     BMX_CHECK(CanAppendIndexEntry());
 
-    int64_t entry_pos = mEntriesStart + mNumIndexEntries;
-    GET_TEMPORAL_OFFSET(entry_pos)  = temporal_offset;
-    GET_KEY_FRAME_OFFSET(entry_pos) = key_frame_offset;
-    GET_FLAGS(entry_pos)            = flags;
-    GET_STREAM_OFFSET(entry_pos)    = stream_offset;
+    uint32_t entry_pos = mEntriesStart + mNumIndexEntries;
+    mTemporalOffsets[entry_pos] = temporal_offset;
+    mKeyFrameOffsets[entry_pos] = key_frame_offset;
+    mFlags[entry_pos]           = flags;
+    mStreamOffsets[entry_pos]   = stream_offset;
 
     mNumIndexEntries++;
 }
@@ -284,6 +433,7 @@ void IndexTableHelperSegment::UpdateStartPosition(int64_t position)
     if (mHavePairedIndexEntries)
         diff_entries *= 2;
     mEntriesStart += diff_entries;
+    mNumIndexEntries -= diff_entries;
     setIndexStartPosition(position);
 }
 
@@ -301,20 +451,139 @@ void IndexTableHelperSegment::UpdateDuration(int64_t duration)
 
 void IndexTableHelperSegment::CopyIndexEntries(const IndexTableHelperSegment *from_segment, uint32_t duration)
 {
-    BMX_ASSERT(!mIndexEntries);
-    BMX_ASSERT(from_segment->mIndexEntries);
+    BMX_ASSERT(!mStreamOffsets);
+    BMX_ASSERT(from_segment->mStreamOffsets);
 
     uint32_t num_entries = duration;
     if (from_segment->mHavePairedIndexEntries)
         num_entries *= 2;
 
-    mIndexEntries = new unsigned char[INTERNAL_INDEX_ENTRY_SIZE * num_entries];
-    memcpy(mIndexEntries, from_segment->mIndexEntries, INTERNAL_INDEX_ENTRY_SIZE * num_entries);
-    mAllocIndexEntries = num_entries;
+    AllocIndexEntries(num_entries);
+    uint32_t from_start = from_segment->mEntriesStart;
+    memcpy(mStreamOffsets,   &from_segment->mStreamOffsets[from_start],   num_entries * sizeof(*mStreamOffsets));
+    memcpy(mTemporalOffsets, &from_segment->mTemporalOffsets[from_start], num_entries * sizeof(*mTemporalOffsets));
+    memcpy(mKeyFrameOffsets, &from_segment->mKeyFrameOffsets[from_start], num_entries * sizeof(*mKeyFrameOffsets));
+    memcpy(mFlags,           &from_segment->mFlags[from_start],           num_entries * sizeof(*mFlags));
     mNumIndexEntries = num_entries;
     mHavePairedIndexEntries = from_segment->mHavePairedIndexEntries;
 }
 
+void IndexTableHelperSegment::AppendDeltaEntry(int8_t pos_table_index, uint8_t slice, uint32_t element_delta)
+{
+    DeltaEntry entry;
+    entry.pos_table_index = pos_table_index;
+    entry.slice           = slice;
+    entry.element_delta   = element_delta;
+    mDeltaEntries.push_back(entry);
+}
+
+void IndexTableHelperSegment::WriteCache(MXFIndexCacheWriter *writer)
+{
+    BMX_ASSERT(mIsLoaded);
+
+    writer->WriteRational(getIndexEditRate());
+    writer->WriteInt64(getIndexStartPosition());
+    writer->WriteInt64(getIndexDuration());
+    writer->WriteUInt32(getEditUnitByteCount());
+    writer->WriteInt64(mEssenceStartOffset);
+    writer->WriteBool(mHavePairedIndexEntries);
+    writer->WriteBool(mHaveExtraIndexEntries);
+    writer->WriteInt64(mIndexEndOffset);
+    writer->WriteBool(mIsFileIndexSegment);
+
+    writer->WriteUInt32((uint32_t)mDeltaEntries.size());
+    size_t i;
+    for (i = 0; i < mDeltaEntries.size(); i++) {
+        writer->WriteUInt8((uint8_t)mDeltaEntries[i].pos_table_index);
+        writer->WriteUInt8(mDeltaEntries[i].slice);
+        writer->WriteUInt32(mDeltaEntries[i].element_delta);
+    }
+
+    // the entry arrays are written one after the other, as they are stored
+    writer->WriteUInt32(mNumIndexEntries);
+    uint32_t j;
+    for (j = 0; j < mNumIndexEntries; j++)
+        writer->WriteInt64(mStreamOffsets[mEntriesStart + j]);
+    if (mNumIndexEntries > 0) {
+        writer->WriteBytes(&mTemporalOffsets[mEntriesStart], mNumIndexEntries);
+        writer->WriteBytes(&mKeyFrameOffsets[mEntriesStart], mNumIndexEntries);
+        writer->WriteBytes(&mFlags[mEntriesStart], mNumIndexEntries);
+    }
+}
+
+void IndexTableHelperSegment::ReadCache(MXFIndexCacheReader *reader)
+{
+    BMX_ASSERT(!mStreamOffsets);
+
+    setIndexEditRate(reader->ReadRational());
+    setIndexStartPosition(reader->ReadInt64());
+    setIndexDuration(reader->ReadInt64());
+    setEditUnitByteCount(reader->ReadUInt32());
+    mEssenceStartOffset     = reader->ReadInt64();
+    mHavePairedIndexEntries = reader->ReadBool();
+    mHaveExtraIndexEntries  = reader->ReadBool();
+    mIndexEndOffset         = reader->ReadInt64();
+    mIsFileIndexSegment     = reader->ReadBool();
+    BMX_CHECK(getIndexStartPosition() >= 0 && getIndexDuration() >= 0);
+
+    uint32_t num_delta_entries = reader->ReadCount(6);
+    uint32_t i;
+    for (i = 0; i < num_delta_entries; i++) {
+        int8_t pos_table_index = (int8_t)reader->ReadUInt8();
+        uint8_t slice          = reader->ReadUInt8();
+        uint32_t element_delta = reader->ReadUInt32();
+        appendDeltaEntry(pos_table_index, slice, element_delta);
+        AppendDeltaEntry(pos_table_index, slice, element_delta);
+    }
+
+    uint32_t num_entries = reader->ReadCount(8 + 3);
+    if (num_entries > 0) {
+        AllocIndexEntries(num_entries);
+        for (i = 0; i < num_entries; i++)
+            mStreamOffsets[i] = reader->ReadInt64();
+        reader->ReadBytes(mTemporalOffsets, num_entries);
+        reader->ReadBytes(mKeyFrameOffsets, num_entries);
+        reader->ReadBytes(mFlags, num_entries);
+        mNumIndexEntries = num_entries;
+    }
+
+    int64_t required_entries = getIndexDuration() * (mHavePairedIndexEntries ? 2 : 1);
+    BMX_CHECK(getEditUnitByteCount() > 0 || (int64_t)mNumIndexEntries >= required_entries);
+}
+
+void IndexTableHelperSegment::AllocIndexEntries(uint32_t num_entries)
+{
+    BMX_ASSERT(!mStreamOffsets);
+
+    // the entry properties are stored in separate arrays so that offset lookups only touch the stream offsets
+    try
+    {
+        mStreamOffsets   = new int64_t[num_entries];
+        mTemporalOffsets = new int8_t[num_entries];
+        mKeyFrameOffsets = new int8_t[num_entries];
+        mFlags           = new uint8_t[num_entries];
+    }
+    catch (...)
+    {
+        FreeIndexEntries();
+        throw;
+    }
+    mAllocIndexEntries = num_entries;
+}
+
+void IndexTableHelperSegment::FreeIndexEntries()
+{
+    delete [] mStreamOffsets;
+    delete [] mTemporalOffsets;
+    delete [] mKeyFrameOffsets;
+    delete [] mFlags;
+    mStreamOffsets   = 0;
+    mTemporalOffsets = 0;
+    mKeyFrameOffsets = 0;
+    mFlags           = 0;
+    mAllocIndexEntries = 0;
+}
+
 
 
 
@@ -328,6 +597,8 @@ IndexTableHelper::IndexTableHelper(MXFFileReader *file_reader)
     mEssenceDataSize = 0;
     mEditRate = ZERO_RATIONAL;
     mDuration = 0;
+    mLazyLoad = false;
+    mMaxLoadedSegments = 0;
 }
 
 IndexTableHelper::~IndexTableHelper()
@@ -343,6 +614,10 @@ void IndexTableHelper::ExtractIndexTable()
     uint8_t llen;
     uint64_t len;
 
+    // VBE index table segments are only parsed when first used if lazy loading is enabled
+    mMaxLoadedSegments = mFileReader->mLazyIndexSegments;
+    mLazyLoad = (mMaxLoadedSegments > 0);
+
     const vector<Partition*> &partitions = mFileReader->mFile->getPartitions();
     size_t i;
     for (i = 0; i < partitions.size(); i++) {
@@ -374,7 +649,8 @@ void IndexTableHelper::ExtractIndexTable()
             while (true)
             {
                 if (mxf_is_index_table_segment(&key)) {
-                    ReadIndexTableSegment(len);
+                    if (!mLazyLoad || !ReadUnloadedIndexTableSegment(llen, len))
+                        ReadIndexTableSegment(len);
                 } else if (mxf_is_filler(&key)) {
                     mFile->skip(len);
                 } else {
@@ -428,6 +704,7 @@ void IndexTableHelper::SetConstantEditUnitSize(Rational edit_rate, uint32_t size
     IndexTableHelperSegment *segment = mSegments.back();
     segment->setIndexEditRate(edit_rate);
     segment->setEditUnitByteCount(size);
+    mSegmentStarts.push_back(0);
 
     mEditRate = edit_rate;
     mEditUnitSize = size;
@@ -435,6 +712,10 @@ void IndexTableHelper::SetConstantEditUnitSize(Rational edit_rate, uint32_t size
 
 int64_t IndexTableHelper::ReadIndexTableSegment(uint64_t len)
 {
+    // existing segments could be modified by the new segment and so must be loaded
+    if (mLazyLoad)
+        LoadAllSegments();
+
     unique_ptr<IndexTableHelperSegment> new_segment(new IndexTableHelperSegment());
     new_segment->ReadIndexTableSegment(mFileReader->mFile, len);
     try
@@ -498,6 +779,7 @@ void IndexTableHelper::UpdateIndex(int64_t position, int64_t essence_offset, int
             mSegments.back()->AppendIndexEntry(0, 0, 0, 0, essence_offset);
 
         mSegments.push_back(segment.release());
+        mSegmentStarts.push_back(position);
     }
 
     mDuration++;
@@ -522,38 +804,19 @@ void IndexTableHelper::GetEditUnit(int64_t position, int8_t *temporal_offset, in
     BMX_ASSERT(!mSegments.empty());
     BMX_CHECK(mDuration == 0 || position < mDuration);
 
-    int result = mSegments[mLastEditUnitSegment]->GetEditUnit(position, temporal_offset, key_frame_offset, flags,
-                                                              offset);
-    if (result < 0) {
-        // TODO: binary search
-        if (result == -2) {
-            // segment is before mLastEditUnitSegment
-            size_t i;
-            for (i = mLastEditUnitSegment; i > 0; i--) {
-                result = mSegments[i - 1]->GetEditUnit(position, temporal_offset, key_frame_offset, flags,
-                                                       offset);
-                if (result >= 0) {
-                    mLastEditUnitSegment = i - 1;
-                    break;
-                } else if (result == -1) {
-                    break;
-                }
-            }
-        } else {
-            // segment is after mLastEditUnitSegment
-            size_t i;
-            for (i = mLastEditUnitSegment + 1; i < mSegments.size(); i++) {
-                result = mSegments[i]->GetEditUnit(position, temporal_offset, key_frame_offset, flags,
-                                                   offset);
-                if (result >= 0) {
-                    mLastEditUnitSegment = i;
-                    break;
-                } else if (result == -2) {
-                    break;
-                }
-            }
-        }
+    // check the last used segment and the one after it before searching for the segment
+    size_t index = mLastEditUnitSegment;
+    if (index >= mSegmentStarts.size() || position < mSegmentStarts[index]) {
+        index = FindSegment(position);
+    } else if (index + 1 < mSegmentStarts.size() && position >= mSegmentStarts[index + 1]) {
+        index++;
+        if (index + 1 < mSegmentStarts.size() && position >= mSegmentStarts[index + 1])
+            index = FindSegment(position);
     }
+
+    int result = GetSegmentEditUnit(index, position, temporal_offset, key_frame_offset, flags, offset);
+    if (result == 0)
+        mLastEditUnitSegment = index;
     BMX_CHECK_M(result == 0,
                ("Failed to find edit unit index information for position 0x%" PRIx64, position));
 
@@ -623,6 +886,8 @@ bool IndexTableHelper::GetTemporalReordering(uint32_t delta)
 {
     BMX_ASSERT(!mSegments.empty());
 
+    // segment 0 is not loaded here because ReadIndexTableSegmentInfo reads the delta entries of unloaded segments
+
     // TODO: is it possible to identify an element within the delta entry array with certainty when slice > 0?
     return mSegments[0]->haveDeltaEntryAtDelta(delta, 0) &&
            mSegments[0]->getDeltaEntryAtDelta(delta, 0)->posTableIndex == -1;
@@ -638,6 +903,76 @@ bool IndexTableHelper::GetIndexEntry(MXFIndexEntryExt *entry, int64_t position)
     return true;
 }
 
+bool IndexTableHelper::RequireSegmentLoad(int64_t position) const
+{
+    if (!mLazyLoad || position < 0 || position >= mDuration)
+        return false;
+
+    return !mSegments[FindSegment(position)]->IsLoaded();
+}
+
+bool IndexTableHelper::WriteCache(MXFIndexCacheWriter *writer) const
+{
+    size_t i;
+    for (i = 0; i < mSegments.size(); i++) {
+        if (!mSegments[i]->IsLoaded())
+            return false;
+    }
+
+    writer->WriteBool(mIsComplete);
+    writer->WriteRational(mEditRate);
+    writer->WriteUInt32(mEditUnitSize);
+    writer->WriteInt64(mDuration);
+
+    writer->WriteUInt32((uint32_t)mSegments.size());
+    for (i = 0; i < mSegments.size(); i++)
+        mSegments[i]->WriteCache(writer);
+
+    return true;
+}
+
+void IndexTableHelper::ReadCache(MXFIndexCacheReader *reader)
+{
+    BMX_ASSERT(mSegments.empty());
+
+    bool is_complete       = reader->ReadBool();
+    Rational edit_rate     = reader->ReadRational();
+    uint32_t edit_unit_size = reader->ReadUInt32();
+    int64_t duration       = reader->ReadInt64();
+
+    vector<IndexTableHelperSegment*> segments;
+    try
+    {
+        uint32_t num_segments = reader->ReadCount(50);
+        int64_t segments_duration = 0;
+        uint32_t i;
+        for (i = 0; i < num_segments; i++) {
+            segments.push_back(new IndexTableHelperSegment());
+            segments.back()->ReadCache(reader);
+            BMX_CHECK(SEG_START(segments.back()) == segments_duration);
+            segments_duration += SEG_DUR(segments.back());
+        }
+        BMX_CHECK(segments_duration == duration || (edit_unit_size > 0 && segments_duration == 0));
+    }
+    catch (...)
+    {
+        size_t i;
+        for (i = 0; i < segments.size(); i++)
+            delete segments[i];
+        throw;
+    }
+
+    // segments read from the cache are fully loaded and so lazy loading is not used
+    mSegments = segments;
+    mIsComplete = is_complete;
+    mEditRate = edit_rate;
+    mEditUnitSize = edit_unit_size;
+    mDuration = duration;
+    mLastEditUnitSegment = 0;
+    mLazyLoad = false;
+    UpdateSegmentStarts();
+}
+
 void IndexTableHelper::InsertCBEIndexSegment(unique_ptr<IndexTableHelperSegment> &new_segment_up)
 {
     IndexTableHelperSegment *new_segment = new_segment_up.get();
@@ -658,6 +993,7 @@ void IndexTableHelper::InsertCBEIndexSegment(unique_ptr<IndexTableHelperSegment>
             // replace runtime generated index segment
             delete mSegments.front();
             mSegments.clear();
+            mSegmentStarts.clear();
         } else {
             // existing CBE segments
 
@@ -681,6 +1017,7 @@ void IndexTableHelper::InsertCBEIndexSegment(unique_ptr<IndexTableHelperSegment>
 
     mSegments.push_back(new_segment);
     new_segment_up.release();
+    mSegmentStarts.push_back(SEG_START(new_segment));
 
     if (mSegments.size() == 1) {
         mEditUnitSize = new_segment->GetEditUnitSize();
@@ -699,6 +1036,23 @@ void IndexTableHelper::InsertVBEIndexSegment(unique_ptr<IndexTableHelperSegment>
     if (mEditUnitSize > 0)
         BMX_EXCEPTION(("Can't mix VBE and CBE index table segments"));
 
+    // append a segment that starts at or after the end of the last segment without checking each existing segment
+    // for overlap. This is the common case for files with a segment per partition
+    if (!mSegments.empty() &&
+        !mSegments.back()->HaveConstantEditUnitSize() &&
+        SEG_START(new_segment) >= SEG_END(mSegments.back()))
+    {
+        if (SEG_START(new_segment) != SEG_END(mSegments.back())) {
+            // TODO: add support for sparse index tables
+            BMX_EXCEPTION(("Sparse index table is not supported"));
+        }
+        mSegments.push_back(new_segment);
+        new_segment_up.release();
+        mSegmentStarts.push_back(SEG_START(new_segment));
+        mDuration += SEG_DUR(new_segment);
+        return;
+    }
+
     // update or remove existing segments
     int64_t new_duration = 0;
     vector<IndexTableHelperSegment*>::iterator iter = mSegments.begin();
@@ -759,6 +1113,7 @@ void IndexTableHelper::InsertVBEIndexSegment(unique_ptr<IndexTableHelperSegment>
     }
 
     mDuration = new_duration;
+    UpdateSegmentStarts();
 }
 
 IndexTableHelperSegment* IndexTableHelper::CreateStartSegment(IndexTableHelperSegment *segment, uint32_t duration)
@@ -772,3 +1127,119 @@ IndexTableHelperSegment* IndexTableHelper::CreateStartSegment(IndexTableHelperSe
     return new_segment.release();
 }
 
+
+bool IndexTableHelper::ReadUnloadedIndexTableSegment(uint8_t llen, uint64_t len)
+{
+    int64_t value_position = mFile->tell();
+
+    // a segment can be left unloaded if it is a VBE segment without extra Avid index entries that follows on from
+    // the previous segment. Otherwise lazy loading is disabled and the segments are read and inserted as normal
+    unique_ptr<IndexTableHelperSegment> new_segment(new IndexTableHelperSegment());
+    bool can_unload = false;
+    try
+    {
+        uint32_t num_index_entries;
+        new_segment->ReadIndexTableSegmentInfo(mFile, len, &num_index_entries);
+        new_segment->setIndexEditRate(normalize_rate(new_segment->getIndexEditRate()));
+
+        can_unload = new_segment->getEditUnitByteCount() == 0 &&
+                     new_segment->getIndexDuration() > 0 &&
+                     (int64_t)num_index_entries == new_segment->getIndexDuration() &&
+                     SEG_START(new_segment) == mDuration &&
+                     (mEditRate.numerator == 0 || new_segment->getIndexEditRate() == mEditRate);
+    }
+    catch (const BMXException&)
+    {
+        can_unload = false;
+    }
+
+    if (!can_unload) {
+        LoadAllSegments();
+        mFile->seek(value_position, SEEK_SET);
+        return false;
+    }
+
+    new_segment->SetUnloaded(value_position - mxfKey_extlen - llen);
+    mSegments.push_back(new_segment.release());
+    mSegmentStarts.push_back(SEG_START(mSegments.back()));
+    mDuration += mSegments.back()->getIndexDuration();
+    if (mSegments.size() == 1)
+        mEditRate = mSegments.back()->getIndexEditRate();
+
+    return true;
+}
+
+void IndexTableHelper::LoadSegment(IndexTableHelperSegment *segment)
+{
+    int64_t file_position = mFile->tell();
+    segment->Load(mFile);
+    mFile->seek(file_position, SEEK_SET);
+
+    if (mLazyLoad) {
+        mLoadedSegments.push_front(segment);
+        if (mLoadedSegments.size() > mMaxLoadedSegments) {
+            mLoadedSegments.back()->Unload();
+            mLoadedSegments.pop_back();
+        }
+    }
+}
+
+void IndexTableHelper::LoadAllSegments()
+{
+    mLazyLoad = false;
+    mLoadedSegments.clear();
+
+    size_t i;
+    for (i = 0; i < mSegments.size(); i++) {
+        if (!mSegments[i]->IsLoaded())
+            LoadSegment(mSegments[i]);
+    }
+}
+
+int IndexTableHelper::GetSegmentEditUnit(size_t index, int64_t position, int8_t *temporal_offset,
+                                         int8_t *key_frame_offset, uint8_t *flags, int64_t *stream_offset)
+{
+    IndexTableHelperSegment *segment = mSegments[index];
+    if (!segment->IsLoaded()) {
+        if (position < SEG_START(segment))
+            return -2;
+        else if (position >= SEG_END(segment))
+            return -1;
+        LoadSegment(segment);
+    }
+
+    int result = segment->GetEditUnit(position, temporal_offset, key_frame_offset, flags, stream_offset);
+
+    // move the segment to the front of the least recently used list
+    if (result == 0 && mLazyLoad && mLoadedSegments.front() != segment) {
+        list<IndexTableHelperSegment*>::iterator iter = find(mLoadedSegments.begin(), mLoadedSegments.end(),
+                                                             segment);
+        if (iter != mLoadedSegments.end())
+            mLoadedSegments.splice(mLoadedSegments.begin(), mLoadedSegments, iter);
+    }
+
+    return result;
+}
+
+void IndexTableHelper::UpdateSegmentStarts()
+{
+    mSegmentStarts.resize(mSegments.size());
+    size_t i;
+    for (i = 0; i < mSegments.size(); i++)
+        mSegmentStarts[i] = SEG_START(mSegments[i]);
+
+    if (mLastEditUnitSegment >= mSegments.size())
+        mLastEditUnitSegment = 0;
+}
+
+size_t IndexTableHelper::FindSegment(int64_t position) const
+{
+    BMX_ASSERT(!mSegmentStarts.empty() && mSegmentStarts.size() == mSegments.size());
+
+    // find the last segment that starts at or before position
+    vector<int64_t>::const_iterator iter = upper_bound(mSegmentStarts.begin(), mSegmentStarts.end(), position);
+    if (iter == mSegmentStarts.begin())
+        return 0;
+
+    return (size_t)(iter - mSegmentStarts.begin()) - 1;
+}
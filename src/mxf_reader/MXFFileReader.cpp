@@ -41,6 +41,8 @@
 #include <algorithm>
 #include <memory>
 #include <set>
+#include <thread>
+#include <chrono>
 
 #include <bmx/mxf_reader/MXFFileReader.h>
 #include <bmx/mxf_reader/MXFTimedTextTrackReader.h>
@@ -50,6 +52,7 @@
 #include <bmx/st436/ST436Element.h>
 #include <bmx/MXFHTTPFile.h>
 #include <bmx/MXFUtils.h>
+#include <bmx/ThreadPool.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -165,6 +168,11 @@ MXFFileReader::MXFFileReader()
     mEssenceReader = 0;
     mRequireFrameInfoCount = 0;
     mST436ManifestCount = 2;
+    mReadAheadCount = 0;
+    mLazyIndexSegments = 0;
+    mIndexCacheEnabled = false;
+    mIndexCache = 0;
+    mFileWatcher = 0;
 
     mDataModel = new DataModel();
     mHeaderMetadata = new AvidHeaderMetadata(mDataModel);
@@ -183,6 +191,8 @@ MXFFileReader::~MXFFileReader()
     if (mOwnFilefactory)
         delete mFileFactory;
     delete mEssenceReader;
+    delete mIndexCache;
+    delete mFileWatcher;
     delete mFile;
     delete mHeaderMetadata;
     delete mDataModel;
@@ -229,6 +239,25 @@ void MXFFileReader::SetST436ManifestFrameCount(uint32_t count)
     mST436ManifestCount = count;
 }
 
+void MXFFileReader::SetReadAhead(uint32_t count)
+{
+    mReadAheadCount = count;
+
+    if (mEssenceReader)
+        mEssenceReader->SetReadAhead(count);
+}
+
+void MXFFileReader::SetLazyIndex(uint32_t max_loaded_segments)
+{
+    mLazyIndexSegments = max_loaded_segments;
+}
+
+void MXFFileReader::SetIndexCache(bool enable, const string &directory)
+{
+    mIndexCacheEnabled = enable;
+    mIndexCacheDirectory = directory;
+}
+
 void MXFFileReader::SetFileIndex(MXFFileIndex *file_index, bool take_ownership)
 {
     if (mFileId != (size_t)(-1))
@@ -300,6 +329,46 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, string filename, int m
     }
 }
 
+vector<MXFFileReader::OpenResult> MXFFileReader::OpenParallel(const vector<MXFFileReader*> &readers,
+                                                               const vector<string> &filenames,
+                                                               int mode_flags, uint32_t num_threads)
+{
+    BMX_CHECK(readers.size() == filenames.size());
+
+    // the file factories need not be thread-safe and opening in order keeps factory state, e.g. the input
+    // checksum files, in the same order as a sequential open
+    vector<File*> files(readers.size(), 0);
+    size_t i;
+    for (i = 0; i < readers.size(); i++) {
+        try
+        {
+            files[i] = readers[i]->mFileFactory->OpenRead(filenames[i]);
+        }
+        catch (...)
+        {
+            files[i] = 0;
+        }
+    }
+
+    vector<OpenResult> results(readers.size(), MXF_RESULT_OPEN_FAIL);
+    ThreadPool thread_pool(num_threads);
+    thread_pool.Run(readers.size(), [&](size_t index) {
+        if (!files[index])
+            return;
+
+        if (filenames[index].empty())
+            results[index] = readers[index]->Open(files[index], URI("stdin:"), URI(), "");
+        else
+            results[index] = readers[index]->Open(files[index], filenames[index], mode_flags);
+        if (results[index] != MXF_RESULT_SUCCESS) {
+            delete files[index];
+            files[index] = 0;
+        }
+    });
+
+    return results;
+}
+
 MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, const URI &rel_uri, const string &filename, int mode_flags)
 {
     OpenResult result;
@@ -380,6 +449,21 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
         ProcessMetadata(metadata_partition);
 
 
+        // the index cache sidecar file is only used for local files
+        if (mIndexCacheEnabled && mFile->isSeekable() && !filename.empty() && !mxf_http_is_url(filename)) {
+            string cache_filename;
+            if (mIndexCacheDirectory.empty()) {
+                cache_filename = filename;
+            } else {
+                cache_filename = mIndexCacheDirectory;
+                if (!check_ends_with_dir_separator(cache_filename))
+                    cache_filename.append("/");
+                cache_filename.append(strip_path(filename));
+            }
+            cache_filename.append(".bmxidx");
+            mIndexCache = new MXFIndexCache(this, filename, cache_filename);
+        }
+
         // create internal essence reader
         if (!mInternalTrackReaders.empty() && mBodySID != 0) {
             mEssenceReader = new EssenceReader(this, file_is_complete, mOpenModeFlags & MXF_MODE_PARSE_ONLY);
@@ -387,6 +471,9 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
             CheckRequireFrameInfo();
             if (mRequireFrameInfoCount > 0)
                 ExtractFrameInfo();
+
+            if (mReadAheadCount > 0)
+                mEssenceReader->SetReadAhead(mReadAheadCount);
         } else {
             mWrappingType = MXF_UNKNOWN_WRAPPING_TYPE;
         }
@@ -447,6 +534,8 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
         mFile = 0;
         delete mEssenceReader;
         mEssenceReader = 0;
+        delete mIndexCache;
+        mIndexCache = 0;
         delete mHeaderMetadata;
         mHeaderMetadata = 0;
         delete mDataModel;
@@ -502,6 +591,46 @@ vector<size_t> MXFFileReader::GetFileIds(bool internal_ess_only) const
     return file_ids;
 }
 
+bool MXFFileReader::Refresh()
+{
+    if (!mEssenceReader || IsComplete())
+        return false;
+
+    int64_t prev_duration = mDuration;
+    mEssenceReader->Refresh();
+
+    // the available duration excludes the precharge before the origin
+    int64_t available_duration = mEssenceReader->GetIndexedDuration() - mFileOrigin;
+    if (available_duration < 0)
+        available_duration = 0;
+    if (mEssenceReader->IsComplete() || available_duration > mDuration)
+        mDuration = available_duration;
+
+    bool complete = IsComplete();
+    if (mDuration == prev_duration && !complete)
+        return false;
+
+    // extend read limits that ended at the previous duration
+    if (mReadDuration >= 0 && mReadStartPosition + mReadDuration == prev_duration)
+        SetReadLimits(mReadStartPosition, mDuration - mReadStartPosition, false);
+
+    return true;
+}
+
+bool MXFFileReader::WaitForUpdate(uint32_t timeout_msec)
+{
+    if (!mFileWatcher) {
+        string filename = GetFilename();
+        if (filename.empty() || mxf_http_is_url(filename)) {
+            this_thread::sleep_for(chrono::milliseconds(timeout_msec));
+            return false;
+        }
+        mFileWatcher = new FileWatcher(filename);
+    }
+
+    return mFileWatcher->Wait(timeout_msec);
+}
+
 bool MXFFileReader::IsComplete() const
 {
     if (mDuration < 0 || (mEssenceReader && !mEssenceReader->IsComplete()))
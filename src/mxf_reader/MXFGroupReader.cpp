@@ -40,6 +40,7 @@
 
 #include <bmx/mxf_reader/MXFGroupReader.h>
 #include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/ThreadPool.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -102,10 +103,13 @@ MXFGroupReader::MXFGroupReader()
     mEmptyFramesSet = false;
     mReadStartPosition = 0;
     mReadDuration = -1;
+    mReadThreadPool = 0;
 }
 
 MXFGroupReader::~MXFGroupReader()
 {
+    delete mReadThreadPool;
+
     size_t i;
     for (i = 0; i < mReaders.size(); i++)
         delete mReaders[i];
@@ -137,6 +141,15 @@ void MXFGroupReader::AddReader(MXFReader *reader)
     mReaders.push_back(reader);
 }
 
+void MXFGroupReader::SetReadThreads(uint32_t num_threads)
+{
+    delete mReadThreadPool;
+    mReadThreadPool = 0;
+
+    if (num_threads > 1)
+        mReadThreadPool = new ThreadPool(num_threads);
+}
+
 bool MXFGroupReader::Finalize()
 {
     try
@@ -402,35 +415,29 @@ uint32_t MXFGroupReader::Read(uint32_t num_samples, bool is_top)
             SetNextFrameTrackPositions();
         }
 
-        uint32_t max_read_num_samples = 0;
+        vector<size_t> member_indexes;
         size_t i;
         for (i = 0; i < mReaders.size(); i++) {
-            if (!mReaders[i]->IsEnabled())
-                continue;
-
-            int64_t member_current_position = CONVERT_GROUP_POS(current_position);
-
-            // ensure external reader is in sync
-            if (mReaders[i]->GetPosition() != member_current_position)
-                mReaders[i]->Seek(member_current_position);
-
-
-            uint32_t member_num_samples = (uint32_t)convert_duration_higher(num_samples,
-                                                                            current_position,
-                                                                            mSampleSequences[i],
-                                                                            mSampleSequenceSizes[i]);
-
-            uint32_t member_num_read = mReaders[i]->Read(member_num_samples, false);
-            if (member_num_read < member_num_samples && mReaders[i]->ReadError())
-                throw BMXException(mReaders[i]->ReadErrorMessage());
+            if (mReaders[i]->IsEnabled())
+                member_indexes.push_back(i);
+        }
 
-            uint32_t group_num_read = (uint32_t)convert_duration_lower(member_num_read,
-                                                                       member_current_position,
-                                                                       mSampleSequences[i],
-                                                                       mSampleSequenceSizes[i]);
+        vector<uint32_t> group_num_reads(member_indexes.size(), 0);
+        if (mReadThreadPool && member_indexes.size() > 1) {
+            // each member reads into its own track frame buffers and so the members can be read in parallel.
+            // The exception for the first member that failed is re-thrown once all have completed
+            mReadThreadPool->Run(member_indexes.size(), [&](size_t index) {
+                group_num_reads[index] = ReadMember(member_indexes[index], current_position, num_samples);
+            });
+        } else {
+            for (i = 0; i < member_indexes.size(); i++)
+                group_num_reads[i] = ReadMember(member_indexes[i], current_position, num_samples);
+        }
 
-            if (group_num_read > max_read_num_samples)
-                max_read_num_samples = group_num_read;
+        uint32_t max_read_num_samples = 0;
+        for (i = 0; i < group_num_reads.size(); i++) {
+            if (group_num_reads[i] > max_read_num_samples)
+                max_read_num_samples = group_num_reads[i];
         }
 
         CompleteRead();
@@ -644,6 +651,30 @@ void MXFGroupReader::SetTemporaryFrameBuffer(bool enable)
         mReaders[i]->SetTemporaryFrameBuffer(enable);
 }
 
+uint32_t MXFGroupReader::ReadMember(size_t i, int64_t current_position, uint32_t num_samples)
+{
+    int64_t member_current_position = CONVERT_GROUP_POS(current_position);
+
+    // ensure external reader is in sync
+    if (mReaders[i]->GetPosition() != member_current_position)
+        mReaders[i]->Seek(member_current_position);
+
+
+    uint32_t member_num_samples = (uint32_t)convert_duration_higher(num_samples,
+                                                                    current_position,
+                                                                    mSampleSequences[i],
+                                                                    mSampleSequenceSizes[i]);
+
+    uint32_t member_num_read = mReaders[i]->Read(member_num_samples, false);
+    if (member_num_read < member_num_samples && mReaders[i]->ReadError())
+        throw BMXException(mReaders[i]->ReadErrorMessage());
+
+    return (uint32_t)convert_duration_lower(member_num_read,
+                                            member_current_position,
+                                            mSampleSequences[i],
+                                            mSampleSequenceSizes[i]);
+}
+
 void MXFGroupReader::StartRead()
 {
     size_t i;
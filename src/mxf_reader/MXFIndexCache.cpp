@@ -0,0 +1,456 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define __STDC_FORMAT_MACROS
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#if defined(_WIN32)
+#include <process.h> // _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <atomic>
+
+#include <libMXF++/MXF.h>
+
+#include <bmx/mxf_reader/MXFIndexCache.h>
+#include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/mxf_reader/IndexTableHelper.h>
+#include <bmx/mxf_reader/EssenceChunkHelper.h>
+#include <bmx/CRC32.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+using namespace mxfpp;
+
+
+static const unsigned char INDEX_CACHE_MAGIC[8] = {'B', 'M', 'X', 'I', 'D', 'X', 'C', 0x00};
+static const uint32_t INDEX_CACHE_VERSION       = 2;
+static const uint32_t KEY_CONTENT_CHECK_SIZE    = 65536;
+
+
+
+static string get_temp_filename(const string &filename)
+{
+    static atomic<uint32_t> count(0);
+
+    // the process id and count make the name unique for each writer
+#if defined(_WIN32)
+    int pid = _getpid();
+#else
+    int pid = (int)getpid();
+#endif
+    char buffer[32];
+    bmx_snprintf(buffer, sizeof(buffer), ".%d.%u.tmp", pid, (unsigned int)(count++));
+
+    return filename + buffer;
+}
+
+static bool read_cache_file(const string &filename, vector<unsigned char> *data)
+{
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (!file)
+        return false;
+
+    bool result = false;
+    try
+    {
+        int64_t size = get_file_size(file);
+        if (size > 0 && (uint64_t)size <= SIZE_MAX) {
+            data->resize((size_t)size);
+            result = (fread(&(*data)[0], 1, data->size(), file) == data->size());
+        }
+    }
+    catch (const BMXException&)
+    {
+        result = false;
+    }
+
+    fclose(file);
+    return result;
+}
+
+
+
+MXFIndexCacheWriter::MXFIndexCacheWriter()
+{
+}
+
+void MXFIndexCacheWriter::WriteUInt8(uint8_t value)
+{
+    mData.push_back(value);
+}
+
+void MXFIndexCacheWriter::WriteUInt32(uint32_t value)
+{
+    unsigned char bytes[4];
+    int i;
+    for (i = 0; i < 4; i++)
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    mData.insert(mData.end(), bytes, bytes + 4);
+}
+
+void MXFIndexCacheWriter::WriteUInt64(uint64_t value)
+{
+    unsigned char bytes[8];
+    int i;
+    for (i = 0; i < 8; i++)
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    mData.insert(mData.end(), bytes, bytes + 8);
+}
+
+void MXFIndexCacheWriter::WriteRational(Rational value)
+{
+    WriteInt32(value.numerator);
+    WriteInt32(value.denominator);
+}
+
+void MXFIndexCacheWriter::WriteBytes(const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char*)data;
+    mData.insert(mData.end(), bytes, bytes + size);
+}
+
+
+
+MXFIndexCacheReader::MXFIndexCacheReader(const unsigned char *data, size_t size)
+{
+    mData = data;
+    mSize = size;
+    mPos = 0;
+}
+
+uint8_t MXFIndexCacheReader::ReadUInt8()
+{
+    BMX_CHECK(mPos + 1 <= mSize);
+    return mData[mPos++];
+}
+
+uint32_t MXFIndexCacheReader::ReadUInt32()
+{
+    BMX_CHECK(mPos + 4 <= mSize);
+    uint32_t value = 0;
+    int i;
+    for (i = 0; i < 4; i++)
+        value |= ((uint32_t)mData[mPos + i]) << (8 * i);
+    mPos += 4;
+    return value;
+}
+
+uint64_t MXFIndexCacheReader::ReadUInt64()
+{
+    BMX_CHECK(mPos + 8 <= mSize);
+    uint64_t value = 0;
+    int i;
+    for (i = 0; i < 8; i++)
+        value |= ((uint64_t)mData[mPos + i]) << (8 * i);
+    mPos += 8;
+    return value;
+}
+
+Rational MXFIndexCacheReader::ReadRational()
+{
+    Rational value;
+    value.numerator   = ReadInt32();
+    value.denominator = ReadInt32();
+    return value;
+}
+
+void MXFIndexCacheReader::ReadBytes(void *data, size_t size)
+{
+    BMX_CHECK(size <= mSize - mPos);
+    memcpy(data, &mData[mPos], size);
+    mPos += size;
+}
+
+uint32_t MXFIndexCacheReader::ReadCount(size_t min_item_size)
+{
+    uint32_t count = ReadUInt32();
+    BMX_CHECK(min_item_size == 0 || count <= (mSize - mPos) / min_item_size);
+    return count;
+}
+
+
+
+MXFIndexCache::MXFIndexCache(MXFFileReader *file_reader, const string &mxf_filename, const string &cache_filename)
+{
+    mFileReader = file_reader;
+    mMXFFilename = mxf_filename;
+    mCacheFilename = cache_filename;
+}
+
+MXFIndexCache::~MXFIndexCache()
+{
+}
+
+bool MXFIndexCache::Read(IndexTableHelper *index_table, EssenceChunkHelper *essence_chunks)
+{
+    if (!CreateKey())
+        return false;
+
+    vector<unsigned char> data;
+    if (!read_cache_file(mCacheFilename, &data))
+        return false;
+
+    try
+    {
+        MXFIndexCacheReader reader(&data[0], data.size());
+
+        unsigned char magic[sizeof(INDEX_CACHE_MAGIC)];
+        reader.ReadBytes(magic, sizeof(magic));
+        if (memcmp(magic, INDEX_CACHE_MAGIC, sizeof(magic)) != 0 || reader.ReadUInt32() != INDEX_CACHE_VERSION) {
+            log_debug("Ignoring index cache file '%s' with unknown format or version\n", mCacheFilename.c_str());
+            return false;
+        }
+
+        vector<unsigned char> key(reader.ReadCount(1));
+        if (!key.empty())
+            reader.ReadBytes(&key[0], key.size());
+        if (key != mKey) {
+            log_debug("Ignoring index cache file '%s' that doesn't match the MXF file\n", mCacheFilename.c_str());
+            return false;
+        }
+
+        vector<unsigned char> payload(reader.ReadCount(1));
+        if (!payload.empty())
+            reader.ReadBytes(&payload[0], payload.size());
+        uint32_t crc = 0;
+        crc32_init(&crc);
+        if (!payload.empty())
+            crc32_update(&crc, &payload[0], payload.size());
+        crc32_final(&crc);
+        if (reader.ReadUInt32() != crc || !reader.IsEnd() || payload.empty()) {
+            log_warn("Ignoring index cache file '%s' that failed the CRC-32 check\n", mCacheFilename.c_str());
+            return false;
+        }
+
+        MXFIndexCacheReader payload_reader(&payload[0], payload.size());
+
+        uint32_t wrapping_type = payload_reader.ReadUInt32();
+        BMX_CHECK(wrapping_type == MXF_FRAME_WRAPPED || wrapping_type == MXF_CLIP_WRAPPED);
+
+        size_t num_partitions = mFileReader->mFile->getPartitions().size();
+        vector<EssenceChunk> chunks(payload_reader.ReadCount(8 * 3 + 1 + 4 + mxfKey_extlen));
+        size_t i;
+        for (i = 0; i < chunks.size(); i++) {
+            chunks[i].file_position  = payload_reader.ReadInt64();
+            chunks[i].essence_offset = payload_reader.ReadInt64();
+            chunks[i].size           = payload_reader.ReadInt64();
+            chunks[i].is_complete    = payload_reader.ReadBool();
+            chunks[i].partition_id   = payload_reader.ReadUInt32();
+            payload_reader.ReadBytes(&chunks[i].element_key, mxfKey_extlen);
+            BMX_CHECK(chunks[i].partition_id < num_partitions);
+        }
+
+        // the index table is restored last because it is committed as soon as it has been read successfully
+        index_table->ReadCache(&payload_reader);
+        essence_chunks->SetEssenceChunks(chunks);
+        mFileReader->mWrappingType = (MXFEssenceWrappingType)wrapping_type;
+    }
+    catch (const BMXException &ex)
+    {
+        log_warn("Ignoring invalid index cache file '%s': %s\n", mCacheFilename.c_str(), ex.what());
+        return false;
+    }
+
+    log_debug("Read index and essence container layout from cache file '%s'\n", mCacheFilename.c_str());
+    return true;
+}
+
+void MXFIndexCache::Write(const IndexTableHelper *index_table, const EssenceChunkHelper *essence_chunks)
+{
+    // the key is created when the cache file is read
+    if (mKey.empty())
+        return;
+    if (mFileReader->mWrappingType != MXF_FRAME_WRAPPED && mFileReader->mWrappingType != MXF_CLIP_WRAPPED)
+        return;
+
+    MXFIndexCacheWriter payload;
+    payload.WriteUInt32(mFileReader->mWrappingType);
+
+    const vector<EssenceChunk> &chunks = essence_chunks->GetEssenceChunks();
+    payload.WriteUInt32((uint32_t)chunks.size());
+    size_t i;
+    for (i = 0; i < chunks.size(); i++) {
+        payload.WriteInt64(chunks[i].file_position);
+        payload.WriteInt64(chunks[i].essence_offset);
+        payload.WriteInt64(chunks[i].size);
+        payload.WriteBool(chunks[i].is_complete);
+        payload.WriteUInt32((uint32_t)chunks[i].partition_id);
+        payload.WriteBytes(&chunks[i].element_key, mxfKey_extlen);
+    }
+
+    // the index table can't be written if it is only partially loaded
+    if (!index_table->WriteCache(&payload))
+        return;
+
+    if (payload.GetData().size() > UINT32_MAX) {
+        log_warn("Index cache data is too large to be written to file '%s'\n", mCacheFilename.c_str());
+        return;
+    }
+
+    uint32_t crc = 0;
+    crc32_init(&crc);
+    crc32_update(&crc, &payload.GetData()[0], payload.GetData().size());
+    crc32_final(&crc);
+
+    MXFIndexCacheWriter writer;
+    writer.WriteBytes(INDEX_CACHE_MAGIC, sizeof(INDEX_CACHE_MAGIC));
+    writer.WriteUInt32(INDEX_CACHE_VERSION);
+    writer.WriteUInt32((uint32_t)mKey.size());
+    writer.WriteBytes(&mKey[0], mKey.size());
+    writer.WriteUInt32((uint32_t)payload.GetData().size());
+    writer.WriteBytes(&payload.GetData()[0], payload.GetData().size());
+    writer.WriteUInt32(crc);
+
+    // write to a temporary file first so that a reader never sees a partially written cache file. The temporary
+    // filename is unique so that processes writing the same cache file don't write to the same temporary file
+    string temp_filename = get_temp_filename(mCacheFilename);
+    FILE *file = fopen(temp_filename.c_str(), "wb");
+    if (!file) {
+        log_warn("Failed to open index cache file '%s' for writing: %s\n",
+                 temp_filename.c_str(), bmx_strerror(errno).c_str());
+        return;
+    }
+    bool write_ok = (fwrite(&writer.GetData()[0], 1, writer.GetData().size(), file) == writer.GetData().size());
+    if (fclose(file) != 0)
+        write_ok = false;
+    if (!write_ok) {
+        log_warn("Failed to write index cache file '%s'\n", temp_filename.c_str());
+        remove(temp_filename.c_str());
+        return;
+    }
+
+#if defined(_WIN32)
+    // rename fails on Windows if the target exists
+    remove(mCacheFilename.c_str());
+#endif
+    if (rename(temp_filename.c_str(), mCacheFilename.c_str()) != 0) {
+        log_warn("Failed to rename index cache file '%s' to '%s': %s\n",
+                 temp_filename.c_str(), mCacheFilename.c_str(), bmx_strerror(errno).c_str());
+        remove(temp_filename.c_str());
+    }
+}
+
+bool MXFIndexCache::CreateKey()
+{
+    mKey.clear();
+
+    int64_t mod_time;
+    try
+    {
+        mod_time = get_file_mod_time(mMXFFilename);
+    }
+    catch (const BMXException &ex)
+    {
+        log_warn("Not using index cache: %s\n", ex.what());
+        return false;
+    }
+
+    File *file = mFileReader->mFile;
+    const vector<Partition*> &partitions = file->getPartitions();
+    BMX_ASSERT(!partitions.empty());
+    Partition *header_partition = partitions[0];
+
+    MXFIndexCacheWriter key;
+    key.WriteInt64(file->size());
+    key.WriteInt64(mod_time);
+
+    key.WriteUInt64(header_partition->getFooterPartition());
+    key.WriteUInt64(header_partition->getHeaderByteCount());
+    key.WriteUInt64(header_partition->getIndexByteCount());
+    key.WriteUInt32(header_partition->getKagSize());
+    key.WriteUInt32(header_partition->getBodySID());
+    key.WriteUInt32(header_partition->getIndexSID());
+    key.WriteBytes(header_partition->getOperationalPattern(), mxfKey_extlen);
+
+    key.WriteUInt32((uint32_t)partitions.size());
+    size_t i;
+    for (i = 0; i < partitions.size(); i++)
+        key.WriteUInt64(partitions[i]->getThisPartition());
+
+    key.WriteUInt32(mFileReader->mBodySID);
+    key.WriteUInt32(mFileReader->mIndexSID);
+
+    // a file rewritten with the same size and partition layout within the modification time resolution is detected
+    // using the raw bytes of the last partition pack and a CRC-32 of the data that follows the header partition pack,
+    // which includes the header metadata instance UIDs
+    int64_t file_position = file->tell();
+    try
+    {
+        mxfKey pp_key;
+        uint8_t pp_llen;
+        uint64_t pp_len;
+        file->seek(partitions.back()->getThisPartition(), SEEK_SET);
+        file->readKL(&pp_key, &pp_llen, &pp_len);
+        BMX_CHECK(mxf_is_partition_pack(&pp_key) && pp_len <= KEY_CONTENT_CHECK_SIZE);
+        vector<unsigned char> buffer(KEY_CONTENT_CHECK_SIZE);
+        BMX_CHECK(file->read(&buffer[0], (uint32_t)pp_len) == pp_len);
+        key.WriteBytes(&pp_key, mxfKey_extlen);
+        key.WriteBytes(&buffer[0], (size_t)pp_len);
+
+        file->seek(header_partition->getThisPartition(), SEEK_SET);
+        file->readKL(&pp_key, &pp_llen, &pp_len);
+        file->skip(pp_len);
+        uint32_t num_read = file->read(&buffer[0], (uint32_t)buffer.size());
+        uint32_t crc = 0;
+        crc32_init(&crc);
+        crc32_update(&crc, &buffer[0], num_read);
+        crc32_final(&crc);
+        key.WriteUInt32(num_read);
+        key.WriteUInt32(crc);
+
+        file->seek(file_position, SEEK_SET);
+    }
+    catch (const MXFException &ex)
+    {
+        log_warn("Not using index cache: failed to read file content check: %s\n", ex.getMessage().c_str());
+        file->seek(file_position, SEEK_SET);
+        return false;
+    }
+    catch (const BMXException &ex)
+    {
+        log_warn("Not using index cache: failed to read file content check: %s\n", ex.what());
+        file->seek(file_position, SEEK_SET);
+        return false;
+    }
+
+    mKey = key.GetData();
+    return true;
+}
@@ -69,6 +69,7 @@ DefaultMXFPackageResolver::DefaultMXFPackageResolver()
     mFileFactory = new DefaultMXFFileFactory();
     mOwnFilefactory = true;
     mFileReader = 0;
+    mOpenThreads = 1;
 }
 
 DefaultMXFPackageResolver::~DefaultMXFPackageResolver()
@@ -90,6 +91,11 @@ void DefaultMXFPackageResolver::SetFileFactory(MXFFileFactory *factory, bool tak
     mOwnFilefactory = take_ownership;
 }
 
+void DefaultMXFPackageResolver::SetOpenThreads(uint32_t num_threads)
+{
+    mOpenThreads = num_threads;
+}
+
 void DefaultMXFPackageResolver::ExtractPackages(MXFFileReader *file_reader)
 {
     if (!mFileReader)
@@ -177,7 +183,10 @@ vector<ResolvedPackage> DefaultMXFPackageResolver::ResolveSourceClip(SourceClip
         }
     }
 
-    // open referenced files if not already done so
+    // collect the referenced files that have not already been opened
+    vector<URI> open_uris;
+    vector<string> open_urls;
+    vector<string> open_locations;
     for (i = 0; i < locators.size(); i++) {
         NetworkLocator *network_locator = dynamic_cast<NetworkLocator*>(locators[i]);
         if (!network_locator)
@@ -215,29 +224,54 @@ vector<ResolvedPackage> DefaultMXFPackageResolver::ResolveSourceClip(SourceClip
         // check whether file has already been opened
         size_t j;
         for (j = 0; j < mExternalReaders.size(); j++) {
-            if (mExternalReaders[i]->GetAbsoluteURI() == uri)
+            if (mExternalReaders[j]->GetAbsoluteURI() == uri)
                 break;
         }
         if (j < mExternalReaders.size() || mFileReader->GetAbsoluteURI() == uri)
             continue;
+        for (j = 0; j < open_uris.size(); j++) {
+            if (open_uris[j] == uri)
+                break;
+        }
+        if (j < open_uris.size())
+            continue;
 
-        string file_location;
+        open_uris.push_back(uri);
+        open_urls.push_back(url);
         if (uri.IsAbsFile())
-            file_location = uri.ToFilename();
+            open_locations.push_back(uri.ToFilename());
         else
-            file_location = uri.ToString();
-        MXFFileReader *file_reader = new MXFFileReader();
-        file_reader->SetFileFactory(mFileFactory, false);
-        MXFFileReader::OpenResult result = file_reader->Open(file_location);
-        if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
-            log_warn("Failed to open external MXF file '%s'\n", url.c_str());
-            delete file_reader;
-            continue;
+            open_locations.push_back(uri.ToString());
+    }
+
+    // open the files, in parallel if enabled, and extract the packages in locator order
+    vector<MXFFileReader*> file_readers;
+    vector<MXFFileReader::OpenResult> results;
+    if (mOpenThreads > 1 && open_locations.size() > 1) {
+        for (i = 0; i < open_locations.size(); i++) {
+            file_readers.push_back(new MXFFileReader());
+            file_readers.back()->SetFileFactory(mFileFactory, false);
+        }
+        results = MXFFileReader::OpenParallel(file_readers, open_locations, 0, mOpenThreads);
+    } else {
+        for (i = 0; i < open_locations.size(); i++) {
+            file_readers.push_back(new MXFFileReader());
+            file_readers.back()->SetFileFactory(mFileFactory, false);
+            results.push_back(file_readers.back()->Open(open_locations[i]));
         }
+    }
 
-        mExternalReaders.push_back(file_reader);
-        ExtractPackages(file_reader);
+    size_t first_new_reader = mExternalReaders.size();
+    for (i = 0; i < file_readers.size(); i++) {
+        if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
+            log_warn("Failed to open external MXF file '%s'\n", open_urls[i].c_str());
+            delete file_readers[i];
+            continue;
+        }
+        mExternalReaders.push_back(file_readers[i]);
     }
+    for (i = first_new_reader; i < mExternalReaders.size(); i++)
+        ExtractPackages(mExternalReaders[i]);
 
     return ResolveSourceClip(source_clip);
 }
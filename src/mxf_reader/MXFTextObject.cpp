@@ -198,6 +198,10 @@ bool MXFTextObject::CheckIsXML()
 
 void MXFTextObject::ReadGenericStream(FILE *text_file_out, unsigned char **data_out, size_t *data_out_size)
 {
+    // the read-ahead thread must not access the file whilst the stream is read
+    if (mFileReader->mEssenceReader)
+        mFileReader->mEssenceReader->ClearPrefetch();
+
     mxfpp::File *mxf_file = mFileReader->mFile;
     int64_t original_file_pos = mxf_file->tell();
     try
@@ -142,6 +142,10 @@ void MXFTimedTextTrackReader::ReadStream(uint32_t stream_id, const mxfKey *strea
                                          unsigned char **data_out, size_t *data_out_size,
                                          std::vector<std::pair<int64_t, int64_t> > *ranges_out)
 {
+    // the read-ahead thread must not access the file whilst the stream is read
+    if (GetFileReader()->mEssenceReader)
+        GetFileReader()->mEssenceReader->ClearPrefetch();
+
     mxfpp::File *mxf_file = GetFileReader()->mFile;
     int64_t original_file_pos = mxf_file->tell();
     try
@@ -50,7 +50,7 @@ using namespace mxfpp;
 //      (65535 [2-byte max len]
 //        - (80 [segment header] + 12 [delta entry array header] + 6 [delta entry] + 22 [index entry array header]))
 #define MAX_INDEX_SEGMENT_SIZE      65000
-#define INDEX_ENTRIES_INCREMENT     250
+#define INDEX_ENTRIES_CHUNK_SIZE    4096
 
 #define MAX_GOP_SIZE                15
 
@@ -63,6 +63,13 @@ static bool compare_element(const RDD9IndexTableElement *left, const RDD9IndexTa
     return left->element_type < right->element_type;
 }
 
+static uint32_t get_entries_chunk_size(uint32_t index_entry_size)
+{
+    // don't allocate chunks larger than needed for the maximum number of entries in a segment
+    uint32_t max_segment_entries = MAX_INDEX_SEGMENT_SIZE / index_entry_size + 1;
+    return max_segment_entries < INDEX_ENTRIES_CHUNK_SIZE ? max_segment_entries : INDEX_ENTRIES_CHUNK_SIZE;
+}
+
 
 
 RDD9IndexEntry::RDD9IndexEntry()
@@ -159,11 +166,10 @@ RDD9IndexTableSegment::RDD9IndexTableSegment(uint32_t index_sid, uint32_t body_s
                                              int64_t start_position, uint32_t index_entry_size, uint32_t slice_count,
                                              mxfOptBool single_index_location, mxfOptBool single_essence_location,
                                              mxfOptBool forward_index_direction)
+: mEntries(index_entry_size, get_entries_chunk_size(index_entry_size))
 {
     mIndexEntrySize = index_entry_size;
 
-    mEntries.SetAllocBlockSize(INDEX_ENTRIES_INCREMENT * index_entry_size);
-
     mxfUUID uuid;
     mxf_generate_uuid(&uuid);
 
@@ -194,9 +200,8 @@ void RDD9IndexTableSegment::AddIndexEntry(const RDD9IndexEntry *entry, int64_t s
                                           vector<uint32_t> slice_cp_offsets)
 {
     BMX_ASSERT(mIndexEntrySize == 11 + slice_cp_offsets.size() * 4);
-    mEntries.Grow(mIndexEntrySize);
 
-    unsigned char *entry_bytes = mEntries.GetBytesAvailable();
+    unsigned char *entry_bytes = mEntries.AppendRecord();
     mxf_set_int8(entry->temporal_offset,  &entry_bytes[0]);
     mxf_set_int8(entry->key_frame_offset, &entry_bytes[1]);
     mxf_set_uint8(entry->flags,           &entry_bytes[2]);
@@ -205,16 +210,12 @@ void RDD9IndexTableSegment::AddIndexEntry(const RDD9IndexEntry *entry, int64_t s
     for (i = 0; i < slice_cp_offsets.size(); i++)
         mxf_set_uint32(slice_cp_offsets[i], &entry_bytes[11 + i * 4]);
 
-    mEntries.IncrementSize(mIndexEntrySize);
-
     mSegment.incrementIndexDuration();
 }
 
 void RDD9IndexTableSegment::UpdateIndexEntry(int64_t segment_position, int8_t temporal_offset)
 {
-    BMX_ASSERT(segment_position * mIndexEntrySize < mEntries.GetSize());
-
-    mxf_set_int8(temporal_offset, &mEntries.GetBytes()[segment_position * mIndexEntrySize]);
+    mxf_set_int8(temporal_offset, &mEntries.GetRecord((size_t)segment_position)[0]);
 }
 
 uint32_t RDD9IndexTableSegment::GetDuration() const
@@ -222,6 +223,18 @@ uint32_t RDD9IndexTableSegment::GetDuration() const
     return (uint32_t)mSegment.getIndexDuration();
 }
 
+void RDD9IndexTableSegment::WriteIndexEntries(File *mxf_file)
+{
+    size_t num_entries = mEntries.GetNumRecords();
+    size_t index = 0;
+    while (index < num_entries) {
+        const unsigned char *bytes;
+        size_t count = mEntries.GetContiguousRecords(index, num_entries, &bytes);
+        mxf_file->write(bytes, (uint32_t)(count * mIndexEntrySize));
+        index += count;
+    }
+}
+
 
 
 RDD9IndexTable::RDD9IndexTable(uint32_t index_sid, uint32_t body_sid, Rational edit_rate, bool repeat_in_footer)
@@ -480,7 +493,6 @@ void RDD9IndexTable::WriteVBESegments(File *mxf_file, Partition *partition, vect
     size_t i;
     for (i = 0; i < segments.size(); i++) {
         IndexTableSegment *segment = segments[i]->GetSegment();
-        ByteArray *entries = segments[i]->GetEntries();
 
         // Note: RDD9 states that PosTableCount is not encoded but mxf_write_index_table_segment will write it with
         //       the default value 0
@@ -496,7 +508,7 @@ void RDD9IndexTable::WriteVBESegments(File *mxf_file, Partition *partition, vect
         }
 
         segment->writeIndexEntryArrayHeader(mxf_file, mSliceCount, 0, (uint32_t)segment->getIndexDuration());
-        mxf_file->write(entries->GetBytes(), entries->GetSize());
+        segments[i]->WriteIndexEntries(mxf_file);
 
         partition->fillToKag(mxf_file);
     }
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+
+#include <bmx/ChunkedByteArray.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+static unsigned char record_byte(size_t index, uint32_t byte_index)
+{
+    return (unsigned char)(index * 7 + byte_index);
+}
+
+static bool test_contiguous_records(uint32_t record_size, uint32_t chunk_num_records, size_t num_records)
+{
+    ChunkedByteArray array(record_size, chunk_num_records);
+
+    size_t i;
+    uint32_t k;
+    for (i = 0; i < num_records; i++) {
+        unsigned char *record = array.AppendRecord();
+        for (k = 0; k < record_size; k++)
+            record[k] = record_byte(i, k);
+    }
+    if (array.GetNumRecords() != num_records || array.GetSize() != (uint64_t)num_records * record_size) {
+        fprintf(stderr, "Size: unexpected size for %u records\n", (unsigned int)num_records);
+        return false;
+    }
+
+    // walk all ranges starting at each index and check the runs stop at chunk boundaries
+    size_t start, end;
+    for (start = 0; start < num_records; start++) {
+        for (end = start + 1; end <= num_records; end++) {
+            size_t index = start;
+            while (index < end) {
+                const unsigned char *bytes;
+                size_t count = array.GetContiguousRecords(index, end, &bytes);
+                size_t expected_count = chunk_num_records - index % chunk_num_records;
+                if (expected_count > end - index)
+                    expected_count = end - index;
+                if (count != expected_count) {
+                    fprintf(stderr, "GetContiguousRecords: count %u != %u for index %u, end %u, chunk %u\n",
+                            (unsigned int)count, (unsigned int)expected_count,
+                            (unsigned int)index, (unsigned int)end, chunk_num_records);
+                    return false;
+                }
+                if (bytes != array.GetRecord(index)) {
+                    fprintf(stderr, "GetContiguousRecords: bytes != GetRecord for index %u\n", (unsigned int)index);
+                    return false;
+                }
+                for (i = 0; i < count; i++) {
+                    for (k = 0; k < record_size; k++) {
+                        if (bytes[i * record_size + k] != record_byte(index + i, k)) {
+                            fprintf(stderr, "GetContiguousRecords: data mismatch for record %u\n",
+                                    (unsigned int)(index + i));
+                            return false;
+                        }
+                    }
+                }
+                index += count;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool test_append_and_clear()
+{
+    ChunkedByteArray array(3, 2);
+
+    unsigned char bytes[3] = {1, 2, 3};
+    array.AppendRecord(bytes);
+    unsigned char *record = array.AppendRecord();
+    if (record[0] != 0 || record[1] != 0 || record[2] != 0) {
+        fprintf(stderr, "AppendRecord: new record is not zero initialized\n");
+        return false;
+    }
+    const unsigned char *first = array.GetRecord(0);
+    array.AppendRecord(bytes);
+    if (array.GetRecord(0) != first || first[0] != 1 || first[1] != 2 || first[2] != 3) {
+        fprintf(stderr, "AppendRecord: first record moved or changed\n");
+        return false;
+    }
+
+    array.Clear();
+    if (array.GetNumRecords() != 0 || array.GetSize() != 0) {
+        fprintf(stderr, "Clear: array is not empty\n");
+        return false;
+    }
+    record = array.AppendRecord();
+    if (record[0] != 0 || array.GetNumRecords() != 1) {
+        fprintf(stderr, "Clear: unexpected record after clear\n");
+        return false;
+    }
+
+    return true;
+}
+
+
+
+int main(int argc, const char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    static const uint32_t chunk_num_records[] = {1, 2, 3, 7, 16};
+    static const size_t num_records[] = {1, 2, 6, 7, 8, 15, 16, 17, 50};
+
+    try
+    {
+        size_t c, n;
+        for (c = 0; c < BMX_ARRAY_SIZE(chunk_num_records); c++) {
+            for (n = 0; n < BMX_ARRAY_SIZE(num_records); n++) {
+                if (!test_contiguous_records(11, chunk_num_records[c], num_records[n]))
+                    return 1;
+            }
+        }
+        if (!test_contiguous_records(1, 4, 13))
+            return 1;
+
+        if (!test_append_and_clear())
+            return 1;
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception caught: %s\n", ex.what());
+        return 1;
+    }
+
+    return 0;
+}
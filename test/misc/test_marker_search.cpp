@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+
+#include "EssenceParserUtils.h"
+#include <bmx/essence_parser/EssenceParser.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define MAX_DATA_SIZE   200
+
+
+static const char *ISA_NAMES[] = {"scalar", "sse2", "avx2"};
+
+static const unsigned char START_CODE_PREFIX[] = {0x00, 0x00, 0x01};
+static const unsigned char VC3_MARKER[]        = {0x00, 0x00, 0x02, 0x80};
+static const unsigned char VC2_MARKER[]        = {0x42, 0x42, 0x43, 0x44, 0x00};
+static const unsigned char SHORT_MARKER[]      = {0x00, 0x01};
+static const unsigned char LONG_MARKER[]       = {0x00, 0x00, 0x00, 0x01, 0x09, 0xf0};
+
+
+static uint32_t reference_find_marker(const unsigned char *data, uint32_t data_size, const unsigned char *marker,
+                                      uint32_t marker_size)
+{
+    uint32_t offset;
+    for (offset = 0; offset + marker_size <= data_size; offset++) {
+        if (memcmp(&data[offset], marker, marker_size) == 0)
+            return offset;
+    }
+
+    return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+// random bytes from a small alphabet, which results in many partial marker matches
+static void fill_random(vector<unsigned char> *data, const unsigned char *marker, uint32_t marker_size)
+{
+    size_t i;
+    for (i = 0; i < data->size(); i++) {
+        if (rand() % 4 == 0)
+            (*data)[i] = (unsigned char)(rand() & 0xff);
+        else
+            (*data)[i] = marker[rand() % marker_size];
+    }
+}
+
+static bool check_search(MarkerSearchISA isa, const vector<unsigned char> &data, uint32_t data_size,
+                         const unsigned char *marker, uint32_t marker_size)
+{
+    // copy to a buffer that ends with the data so that reads beyond the end are detected by memory checkers
+    vector<unsigned char> buffer(data.begin(), data.begin() + data_size);
+    const unsigned char *bytes = (data_size > 0 ? &buffer[0] : 0);
+
+    uint32_t expected = reference_find_marker(bytes, data_size, marker, marker_size);
+    uint32_t result = find_marker(bytes, data_size, marker, marker_size);
+    if (result != expected) {
+        fprintf(stderr, "find_marker: %s result %u differs from expected %u (data size %u, marker size %u)\n",
+                ISA_NAMES[isa], result, expected, data_size, marker_size);
+        return false;
+    }
+
+    if (marker == START_CODE_PREFIX) {
+        expected = (data_size > 0 ? reference_find_marker(bytes, data_size - 1, marker, marker_size) :
+                                    ESSENCE_PARSER_NULL_OFFSET);
+        result = find_start_code_prefix(bytes, data_size);
+        if (result != expected) {
+            fprintf(stderr, "find_start_code_prefix: %s result %u differs from expected %u (data size %u)\n",
+                    ISA_NAMES[isa], result, expected, data_size);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_marker(MarkerSearchISA isa, const unsigned char *marker, uint32_t marker_size)
+{
+    vector<unsigned char> data(MAX_DATA_SIZE);
+    uint32_t data_size, offset;
+    int i;
+
+    // a single marker at every position, including those that straddle the 16 and 32 byte vector boundaries
+    // and at the end of the data
+    for (data_size = 0; data_size <= MAX_DATA_SIZE; data_size++) {
+        memset(&data[0], 0xff, data.size());
+        if (!check_search(isa, data, data_size, marker, marker_size))
+            return false;
+
+        for (offset = 0; offset + marker_size <= data_size; offset++) {
+            memset(&data[0], 0xff, data.size());
+            memcpy(&data[offset], marker, marker_size);
+            if (!check_search(isa, data, data_size, marker, marker_size))
+                return false;
+        }
+    }
+
+    // random data with many partial matches
+    for (i = 0; i < 2000; i++) {
+        data_size = (uint32_t)(rand() % (MAX_DATA_SIZE + 1));
+        fill_random(&data, marker, marker_size);
+        if (!check_search(isa, data, data_size, marker, marker_size))
+            return false;
+    }
+
+    return true;
+}
+
+static bool test_isa(MarkerSearchISA isa)
+{
+    if (!set_marker_search_isa(isa))
+        return false;
+
+    return test_marker(isa, START_CODE_PREFIX, sizeof(START_CODE_PREFIX)) &&
+           test_marker(isa, VC3_MARKER, sizeof(VC3_MARKER)) &&
+           test_marker(isa, VC2_MARKER, sizeof(VC2_MARKER)) &&
+           test_marker(isa, SHORT_MARKER, sizeof(SHORT_MARKER)) &&
+           test_marker(isa, LONG_MARKER, sizeof(LONG_MARKER));
+}
+
+
+
+int main()
+{
+    int result = 0;
+    int isa;
+
+    srand(1);
+
+    try
+    {
+        for (isa = SCALAR_MARKER_SEARCH_ISA; isa <= AVX2_MARKER_SEARCH_ISA; isa++) {
+            if (!marker_search_isa_supported((MarkerSearchISA)isa))
+                continue;
+            if (!test_isa((MarkerSearchISA)isa))
+                result = 1;
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception: %s\n", ex.what());
+        result = 1;
+    }
+
+    return result;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+#include <string>
+
+#include <bmx/MultiChecksum.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+static const char *TYPE_NAMES[] = {"crc32", "md5", "sha1"};
+
+
+static void fill_random(vector<unsigned char> *data)
+{
+    size_t i;
+    for (i = 0; i < data->size(); i++)
+        (*data)[i] = (unsigned char)(rand() & 0xff);
+}
+
+static string calc_expected(const vector<unsigned char> &data, ChecksumType type)
+{
+    Checksum checksum(type);
+    if (!data.empty())
+        checksum.Update(&data[0], (uint32_t)data.size());
+    checksum.Final();
+    return checksum.GetDigestString();
+}
+
+static bool check_digests(const char *test_name, const MultiChecksum &multi_checksum,
+                          const vector<ChecksumType> &types, const vector<unsigned char> &data)
+{
+    size_t i;
+    for (i = 0; i < types.size(); i++) {
+        string expected = calc_expected(data, types[i]);
+        string result = multi_checksum.GetChecksum(types[i])->GetDigestString();
+        if (result != expected) {
+            fprintf(stderr, "%s: %s digest mismatch for data size %u: '%s' != '%s'\n",
+                    test_name, TYPE_NAMES[types[i]], (unsigned int)data.size(), result.c_str(), expected.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_update(const vector<ChecksumType> &types, const vector<unsigned char> &data,
+                        uint32_t chunk_size, uint32_t num_buffers, uint32_t max_update_size)
+{
+    MultiChecksum multi_checksum(types, chunk_size, num_buffers);
+
+    size_t offset = 0;
+    while (offset < data.size()) {
+        uint32_t count = 1 + (uint32_t)(rand() % max_update_size);
+        if (count > data.size() - offset)
+            count = (uint32_t)(data.size() - offset);
+        multi_checksum.Update(&data[offset], count);
+        offset += count;
+    }
+    multi_checksum.Final();
+
+    return check_digests("Update", multi_checksum, types, data);
+}
+
+static bool test_buffer(const vector<ChecksumType> &types, const vector<unsigned char> &data,
+                        uint32_t chunk_size, uint32_t num_buffers)
+{
+    MultiChecksum multi_checksum(types, chunk_size, num_buffers);
+
+    size_t offset = 0;
+    while (offset < data.size()) {
+        uint32_t size;
+        unsigned char *buffer = multi_checksum.GetBuffer(&size);
+        if (size == 0) {
+            fprintf(stderr, "GetBuffer: returned an empty buffer\n");
+            return false;
+        }
+        // commit less than the buffer size at times to check partially filled chunks
+        if (size > 1 && (rand() & 1))
+            size = 1 + (uint32_t)(rand() % size);
+        if (size > data.size() - offset)
+            size = (uint32_t)(data.size() - offset);
+        memcpy(buffer, &data[offset], size);
+        multi_checksum.CommitBuffer(size);
+        offset += size;
+    }
+    multi_checksum.Final();
+
+    return check_digests("GetBuffer", multi_checksum, types, data);
+}
+
+
+
+int main(int argc, const char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    static const uint32_t data_sizes[] = {0, 1, 63, 64, 1000, 4096, 65537, 300000};
+    static const uint32_t chunk_sizes[] = {1, 64, 4096, 65536};
+    static const uint32_t num_buffers[] = {1, 2, 3};
+
+    vector<vector<ChecksumType> > type_sets;
+    type_sets.push_back(vector<ChecksumType>(1, MD5_CHECKSUM));
+    vector<ChecksumType> types;
+    types.push_back(CRC32_CHECKSUM);
+    types.push_back(MD5_CHECKSUM);
+    type_sets.push_back(types);
+    types.push_back(SHA1_CHECKSUM);
+    type_sets.push_back(types);
+
+    srand(1);
+
+    try
+    {
+        size_t t, d, c, b;
+        for (t = 0; t < type_sets.size(); t++) {
+            for (d = 0; d < BMX_ARRAY_SIZE(data_sizes); d++) {
+                vector<unsigned char> data(data_sizes[d]);
+                fill_random(&data);
+                for (c = 0; c < BMX_ARRAY_SIZE(chunk_sizes); c++) {
+                    // a chunk size of 1 is slow for large data
+                    if (chunk_sizes[c] == 1 && data_sizes[d] > 4096)
+                        continue;
+                    for (b = 0; b < BMX_ARRAY_SIZE(num_buffers); b++) {
+                        if (!test_update(type_sets[t], data, chunk_sizes[c], num_buffers[b], 10000) ||
+                            !test_buffer(type_sets[t], data, chunk_sizes[c], num_buffers[b]))
+                        {
+                            return 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception: %s\n", ex.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+#include <vector>
+
+#include <bmx/frame/PooledFrame.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+static void fill_frame(Frame *frame, uint32_t size, unsigned char value)
+{
+    frame->Grow(size);
+    memset(frame->GetBytesAvailable(), value, size);
+    frame->IncrementSize(size);
+}
+
+static bool check_stats(const FramePoolStats &stats, size_t num_free, size_t num_in_use, size_t max_in_use,
+                        uint64_t num_created, uint64_t num_reused, const char *context)
+{
+    if (stats.num_free != num_free || stats.num_in_use != num_in_use || stats.max_in_use != max_in_use ||
+        stats.num_created != num_created || stats.num_reused != num_reused)
+    {
+        fprintf(stderr, "%s: unexpected stats: free %u, in use %u, max in use %u, created %u, reused %u\n",
+                context, (unsigned int)stats.num_free, (unsigned int)stats.num_in_use,
+                (unsigned int)stats.max_in_use, (unsigned int)stats.num_created, (unsigned int)stats.num_reused);
+        return false;
+    }
+
+    return true;
+}
+
+static bool test_reuse()
+{
+    PooledFrameFactory factory(4);
+
+    Frame *frame = factory.CreateFrame();
+    fill_frame(frame, 1000, 0x5a);
+    const Frame *first_frame = frame;
+    const unsigned char *first_bytes = frame->GetBytes();
+    delete frame;
+    if (!check_stats(factory.GetStats(), 1, 0, 1, 1, 0, "Reuse"))
+        return false;
+
+    // the released frame and its data buffer are re-used, with the buffer capacity retained
+    frame = factory.CreateFrame();
+    if (frame != first_frame) {
+        fprintf(stderr, "Reuse: frame allocation was not re-used\n");
+        delete frame;
+        return false;
+    }
+    if (frame->GetSize() != 0 || frame->GetBytesAvailable() != first_bytes || frame->GetSizeAvailable() < 1000) {
+        fprintf(stderr, "Reuse: data buffer was not reset or its capacity was not retained\n");
+        delete frame;
+        return false;
+    }
+    fill_frame(frame, 1000, 0xa5);
+    delete frame;
+
+    return check_stats(factory.GetStats(), 1, 0, 1, 1, 1, "Reuse");
+}
+
+static bool test_warm_pool()
+{
+    PooledFrameFactory factory(4);
+
+    // no new frames are allocated once the pool holds the maximum number of frames in use
+    vector<Frame*> frames;
+    size_t i, k;
+    for (i = 0; i < 100; i++) {
+        for (k = 0; k < 3; k++) {
+            frames.push_back(factory.CreateFrame());
+            fill_frame(frames.back(), (uint32_t)(100 + i), (unsigned char)k);
+        }
+        for (k = 0; k < frames.size(); k++)
+            delete frames[k];
+        frames.clear();
+    }
+
+    return check_stats(factory.GetStats(), 3, 0, 3, 3, 297, "Warm pool");
+}
+
+static bool test_max_free()
+{
+    PooledFrameFactory factory(4);
+
+    // frames released beyond the maximum are freed
+    vector<Frame*> frames;
+    size_t i;
+    for (i = 0; i < 8; i++)
+        frames.push_back(factory.CreateFrame());
+    if (!check_stats(factory.GetStats(), 0, 8, 8, 8, 0, "Max free"))
+        return false;
+    for (i = 0; i < frames.size(); i++)
+        delete frames[i];
+    frames.clear();
+    if (!check_stats(factory.GetStats(), 4, 0, 8, 8, 0, "Max free"))
+        return false;
+
+    for (i = 0; i < 8; i++)
+        frames.push_back(factory.CreateFrame());
+    for (i = 0; i < frames.size(); i++)
+        delete frames[i];
+
+    return check_stats(factory.GetStats(), 4, 0, 8, 12, 4, "Max free");
+}
+
+static bool test_clone()
+{
+    PooledFrameFactory factory(4);
+
+    Frame *frame = factory.CreateFrame();
+    fill_frame(frame, 64, 0x33);
+    frame->position = 10;
+    Frame *clone = frame->Clone();
+    if (!check_stats(factory.GetStats(), 0, 2, 2, 2, 0, "Clone")) {
+        delete frame;
+        delete clone;
+        return false;
+    }
+    bool result = true;
+    if (clone->position != 10 || clone->GetSize() != 64 || clone->GetBytes() == frame->GetBytes() ||
+        memcmp(clone->GetBytes(), frame->GetBytes(), 64) != 0)
+    {
+        fprintf(stderr, "Clone: clone differs from the frame\n");
+        result = false;
+    }
+    delete frame;
+    delete clone;
+
+    return result && check_stats(factory.GetStats(), 2, 0, 2, 2, 0, "Clone");
+}
+
+static bool test_frame_outlives_factory()
+{
+    // the pool is deleted when the last frame is released
+    PooledFrameFactory *factory = new PooledFrameFactory(4);
+    Frame *frame = factory->CreateFrame();
+    delete factory;
+
+    fill_frame(frame, 256, 0x77);
+    Frame *clone = frame->Clone();
+    delete frame;
+    delete clone;
+
+    return true;
+}
+
+
+
+int main(int argc, const char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    try
+    {
+        if (!test_reuse() ||
+            !test_warm_pool() ||
+            !test_max_free() ||
+            !test_clone() ||
+            !test_frame_outlives_factory())
+        {
+            return 1;
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception caught: %s\n", ex.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+
+#include <bmx/frame/SharedBufferFrame.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define BUFFER_SIZE     100
+
+
+
+static SharedBuffer* create_buffer()
+{
+    SharedBuffer *buffer = new SharedBuffer();
+    buffer->GetData()->Allocate(BUFFER_SIZE);
+    unsigned char *bytes = buffer->GetData()->GetBytes();
+    uint32_t i;
+    for (i = 0; i < BUFFER_SIZE; i++)
+        bytes[i] = (unsigned char)i;
+    buffer->GetData()->SetSize(BUFFER_SIZE);
+
+    return buffer;
+}
+
+static bool check_bytes(const Frame *frame, uint32_t size, unsigned char first_value, const char *context)
+{
+    if (frame->GetSize() != size) {
+        fprintf(stderr, "%s: frame size %u != %u\n", context, frame->GetSize(), size);
+        return false;
+    }
+    uint32_t i;
+    for (i = 0; i < size; i++) {
+        if (frame->GetBytes()[i] != (unsigned char)(first_value + i)) {
+            fprintf(stderr, "%s: frame data mismatch at %u\n", context, i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_slice_lifetime()
+{
+    SharedBuffer *buffer = create_buffer();
+
+    SharedBufferFrame *first = new SharedBufferFrame();
+    SharedBufferFrame *second = new SharedBufferFrame();
+    first->SetSharedData(buffer, 0, 40);
+    second->SetSharedData(buffer, 40, 60);
+
+    // the slices reference the buffer data rather than a copy
+    if (first->GetBytes() != buffer->GetData()->GetBytes() ||
+        second->GetBytes() != buffer->GetData()->GetBytes() + 40)
+    {
+        fprintf(stderr, "Slice lifetime: slice does not reference the shared buffer\n");
+        buffer->Release();
+        delete first;
+        delete second;
+        return false;
+    }
+
+    // a clone shares the buffer
+    Frame *clone = second->Clone();
+    bool result = true;
+    if (!dynamic_cast<SharedBufferFrame*>(clone)->HaveSharedData() || clone->GetBytes() != second->GetBytes()) {
+        fprintf(stderr, "Slice lifetime: clone does not share the buffer\n");
+        result = false;
+    }
+
+    // the buffer remains shared until all but one reference is released
+    delete first;
+    delete second;
+    if (result && !buffer->IsShared()) {
+        fprintf(stderr, "Slice lifetime: buffer released while referenced by clone\n");
+        result = false;
+    }
+    delete clone;
+    if (result && buffer->IsShared()) {
+        fprintf(stderr, "Slice lifetime: buffer still referenced after slices were deleted\n");
+        result = false;
+    }
+    buffer->Release();
+    if (!result)
+        return false;
+
+    // the slices keep the buffer alive after the creator has released its reference
+    buffer = create_buffer();
+    first = new SharedBufferFrame();
+    second = new SharedBufferFrame();
+    first->SetSharedData(buffer, 10, 20);
+    second->SetSharedData(buffer, 30, 70);
+    buffer->Release();
+    result = check_bytes(first, 20, 10, "Slice lifetime") &&
+             check_bytes(second, 70, 30, "Slice lifetime");
+    delete first;
+    result = result && check_bytes(second, 70, 30, "Slice lifetime");
+    delete second;
+
+    return result;
+}
+
+static bool test_copy_on_write()
+{
+    SharedBuffer *buffer = create_buffer();
+
+    SharedBufferFrame first;
+    SharedBufferFrame second;
+    first.SetSharedData(buffer, 0, 50);
+    second.SetSharedData(buffer, 50, 50);
+    buffer->Release();
+
+    // reducing the size doesn't require a copy
+    first.SetSize(20);
+    if (!first.HaveSharedData() || !check_bytes(&first, 20, 0, "Copy on write"))
+        return false;
+    if (first.GetSizeAvailable() != 0 || first.GetBytesAvailable() != 0) {
+        fprintf(stderr, "Copy on write: shared data is writable\n");
+        return false;
+    }
+
+    // growing the frame copies the slice, which is then modified without changing the shared buffer
+    first.Grow(10);
+    if (first.HaveSharedData() || !check_bytes(&first, 20, 0, "Copy on write"))
+        return false;
+    unsigned char *bytes = first.GetBytesAvailable();
+    uint32_t i;
+    for (i = 0; i < 10; i++)
+        bytes[i] = (unsigned char)(20 + i);
+    first.IncrementSize(10);
+    if (!check_bytes(&first, 30, 0, "Copy on write") || !check_bytes(&second, 50, 50, "Copy on write"))
+        return false;
+
+    // increasing the size beyond the slice copies the slice
+    second.SetSize(60);
+    if (second.HaveSharedData()) {
+        fprintf(stderr, "Copy on write: slice not copied when size increased\n");
+        return false;
+    }
+    second.SetSize(50);
+    if (!check_bytes(&second, 50, 50, "Copy on write"))
+        return false;
+
+    // a frame that has data can't be set to reference a shared buffer
+    buffer = create_buffer();
+    bool result = false;
+    try
+    {
+        first.SetSharedData(buffer, 0, 10);
+        fprintf(stderr, "Copy on write: shared data set for frame with data\n");
+    }
+    catch (const BMXException &)
+    {
+        result = true;
+    }
+    buffer->Release();
+
+    return result;
+}
+
+static bool test_invalid_slice()
+{
+    SharedBuffer *buffer = create_buffer();
+
+    SharedBufferFrame frame;
+    bool result = false;
+    try
+    {
+        frame.SetSharedData(buffer, 60, 50);
+        fprintf(stderr, "Invalid slice: slice beyond the buffer was accepted\n");
+    }
+    catch (const BMXException &)
+    {
+        result = !frame.HaveSharedData() && !buffer->IsShared();
+        if (!result)
+            fprintf(stderr, "Invalid slice: buffer referenced after failure\n");
+    }
+    buffer->Release();
+
+    return result;
+}
+
+
+
+int main(int argc, const char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    try
+    {
+        if (!test_slice_lifetime() ||
+            !test_copy_on_write() ||
+            !test_invalid_slice())
+        {
+            return 1;
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception caught: %s\n", ex.what());
+        return 1;
+    }
+
+    return 0;
+}
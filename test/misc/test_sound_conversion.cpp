@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+
+#include <bmx/essence_parser/SoundConversion.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define GUARD_SIZE      64
+#define GUARD_BYTE      0xa5
+
+
+static const char *ISA_NAMES[] = {"scalar", "sse2", "avx2", "neon"};
+
+
+static unsigned char random_byte()
+{
+    return (unsigned char)(rand() & 0xff);
+}
+
+static void fill_random(vector<unsigned char> *data)
+{
+    size_t i;
+    for (i = 0; i < data->size(); i++)
+        (*data)[i] = random_byte();
+}
+
+static vector<unsigned char> create_aes3_data(uint16_t sample_count)
+{
+    vector<unsigned char> aes3_data(4 + sample_count * 8 * 4);
+    fill_random(&aes3_data);
+    aes3_data[1] = (unsigned char)(sample_count & 0xff);
+    aes3_data[2] = (unsigned char)(sample_count >> 8);
+    return aes3_data;
+}
+
+static bool check_guard(const vector<unsigned char> &output, size_t data_size)
+{
+    size_t i;
+    for (i = data_size; i < output.size(); i++) {
+        if (output[i] != GUARD_BYTE)
+            return false;
+    }
+    return true;
+}
+
+static bool compare_output(const char *test_name, SoundConversionISA isa,
+                           const vector<unsigned char> &expected, const vector<unsigned char> &output,
+                           size_t data_size)
+{
+    if (memcmp(&expected[0], &output[0], data_size) != 0) {
+        fprintf(stderr, "%s: %s output differs from scalar output\n", test_name, ISA_NAMES[isa]);
+        return false;
+    }
+    if (!check_guard(output, data_size)) {
+        fprintf(stderr, "%s: %s output overruns the output data\n", test_name, ISA_NAMES[isa]);
+        return false;
+    }
+    return true;
+}
+
+static bool test_aes3_to_pcm(SoundConversionISA isa, uint16_t sample_count, uint32_t bits_per_sample,
+                             bool ignore_valid_flags)
+{
+    vector<unsigned char> aes3_data = create_aes3_data(sample_count);
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    size_t data_size = sample_count * block_align;
+    uint8_t channel_num;
+
+    for (channel_num = 0; channel_num < 8; channel_num++) {
+        vector<unsigned char> expected(data_size + GUARD_SIZE, GUARD_BYTE);
+        vector<unsigned char> output(data_size + GUARD_SIZE, GUARD_BYTE);
+
+        set_sound_conversion_isa(SCALAR_SOUND_CONVERSION_ISA);
+        convert_aes3_to_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), ignore_valid_flags, bits_per_sample,
+                            channel_num, &expected[0], (uint32_t)data_size);
+        set_sound_conversion_isa(isa);
+        convert_aes3_to_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), ignore_valid_flags, bits_per_sample,
+                            channel_num, &output[0], (uint32_t)data_size);
+
+        if (!compare_output("convert_aes3_to_pcm", isa, expected, output, data_size))
+            return false;
+    }
+
+    return true;
+}
+
+static bool test_aes3_to_mc_pcm(SoundConversionISA isa, uint16_t sample_count, uint32_t bits_per_sample,
+                                bool ignore_valid_flags)
+{
+    vector<unsigned char> aes3_data = create_aes3_data(sample_count);
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    uint8_t channel_count;
+
+    for (channel_count = 1; channel_count <= 8; channel_count++) {
+        size_t data_size = sample_count * channel_count * block_align;
+        vector<unsigned char> expected(data_size + GUARD_SIZE, GUARD_BYTE);
+        vector<unsigned char> output(data_size + GUARD_SIZE, GUARD_BYTE);
+
+        set_sound_conversion_isa(SCALAR_SOUND_CONVERSION_ISA);
+        convert_aes3_to_mc_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), ignore_valid_flags, bits_per_sample,
+                               channel_count, &expected[0], (uint32_t)data_size);
+        set_sound_conversion_isa(isa);
+        convert_aes3_to_mc_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), ignore_valid_flags, bits_per_sample,
+                               channel_count, &output[0], (uint32_t)data_size);
+
+        if (!compare_output("convert_aes3_to_mc_pcm", isa, expected, output, data_size))
+            return false;
+    }
+
+    return true;
+}
+
+static bool test_deinterleave(SoundConversionISA isa, uint32_t sample_count, uint32_t bits_per_sample,
+                              uint16_t channel_count)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    vector<unsigned char> input(sample_count * channel_count * block_align);
+    size_t data_size = sample_count * block_align;
+    uint16_t channel_num;
+
+    fill_random(&input);
+    for (channel_num = 0; channel_num < channel_count; channel_num++) {
+        vector<unsigned char> expected(data_size + GUARD_SIZE, GUARD_BYTE);
+        vector<unsigned char> output(data_size + GUARD_SIZE, GUARD_BYTE);
+
+        set_sound_conversion_isa(SCALAR_SOUND_CONVERSION_ISA);
+        deinterleave_audio(&input[0], (uint32_t)input.size(), bits_per_sample, channel_count, channel_num,
+                           &expected[0], (uint32_t)data_size);
+        set_sound_conversion_isa(isa);
+        deinterleave_audio(&input[0], (uint32_t)input.size(), bits_per_sample, channel_count, channel_num,
+                           &output[0], (uint32_t)data_size);
+
+        if (!compare_output("deinterleave_audio", isa, expected, output, data_size))
+            return false;
+    }
+
+    return true;
+}
+
+static bool test_interleave(SoundConversionISA isa, uint32_t sample_count, uint32_t bits_per_sample,
+                            uint16_t channel_count)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    vector<unsigned char> input(sample_count * block_align);
+    vector<unsigned char> initial_output(sample_count * channel_count * block_align);
+    size_t data_size = initial_output.size();
+    uint16_t channel_num;
+
+    fill_random(&input);
+    fill_random(&initial_output);
+    for (channel_num = 0; channel_num < channel_count; channel_num++) {
+        vector<unsigned char> expected(initial_output);
+        vector<unsigned char> output(initial_output);
+        expected.resize(data_size + GUARD_SIZE, GUARD_BYTE);
+        output.resize(data_size + GUARD_SIZE, GUARD_BYTE);
+
+        set_sound_conversion_isa(SCALAR_SOUND_CONVERSION_ISA);
+        interleave_audio(&input[0], (uint32_t)input.size(), bits_per_sample, channel_count, channel_num,
+                         &expected[0], (uint32_t)data_size);
+        set_sound_conversion_isa(isa);
+        interleave_audio(&input[0], (uint32_t)input.size(), bits_per_sample, channel_count, channel_num,
+                         &output[0], (uint32_t)data_size);
+
+        if (!compare_output("interleave_audio", isa, expected, output, data_size))
+            return false;
+    }
+
+    return true;
+}
+
+static bool test_aes3_to_pcm_channels(uint16_t sample_count, uint32_t bits_per_sample, bool ignore_valid_flags)
+{
+    vector<unsigned char> aes3_data = create_aes3_data(sample_count);
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    size_t data_size = sample_count * block_align;
+    uint8_t channel_count, channel_num;
+
+    for (channel_count = 1; channel_count <= 8; channel_count++) {
+        vector<vector<unsigned char> > expected(channel_count);
+        vector<vector<unsigned char> > output(channel_count);
+        vector<unsigned char*> output_ptrs(channel_count);
+        for (channel_num = 0; channel_num < channel_count; channel_num++) {
+            expected[channel_num].assign(data_size + GUARD_SIZE, GUARD_BYTE);
+            output[channel_num].assign(data_size + GUARD_SIZE, GUARD_BYTE);
+            convert_aes3_to_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), ignore_valid_flags, bits_per_sample,
+                                channel_num, &expected[channel_num][0], (uint32_t)data_size);
+            // skip a channel to check that null buffers are ignored
+            if (channel_count < 3 || channel_num != 1)
+                output_ptrs[channel_num] = &output[channel_num][0];
+        }
+
+        convert_aes3_to_pcm_channels(&aes3_data[0], (uint32_t)aes3_data.size(), ignore_valid_flags, bits_per_sample,
+                                     channel_count, &output_ptrs[0], (uint32_t)data_size);
+
+        for (channel_num = 0; channel_num < channel_count; channel_num++) {
+            if (!output_ptrs[channel_num]) {
+                if (!check_guard(output[channel_num], 0)) {
+                    fprintf(stderr, "convert_aes3_to_pcm_channels: skipped channel was written to\n");
+                    return false;
+                }
+            } else if (!compare_output("convert_aes3_to_pcm_channels", get_sound_conversion_isa(),
+                                       expected[channel_num], output[channel_num], data_size))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool test_deinterleave_channels(SoundConversionISA isa, uint32_t sample_count, uint32_t bits_per_sample,
+                                       uint16_t channel_count, bool skip_channels)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    vector<unsigned char> input(sample_count * channel_count * block_align);
+    size_t data_size = sample_count * block_align;
+    uint16_t channel_num;
+
+    fill_random(&input);
+
+    // the expected output is the scalar per-channel output
+    set_sound_conversion_isa(SCALAR_SOUND_CONVERSION_ISA);
+    vector<vector<unsigned char> > expected(channel_count);
+    vector<vector<unsigned char> > output(channel_count);
+    vector<unsigned char*> output_ptrs(channel_count);
+    for (channel_num = 0; channel_num < channel_count; channel_num++) {
+        expected[channel_num].assign(data_size + GUARD_SIZE, GUARD_BYTE);
+        output[channel_num].assign(data_size + GUARD_SIZE, GUARD_BYTE);
+        deinterleave_audio(&input[0], (uint32_t)input.size(), bits_per_sample, channel_count, channel_num,
+                           &expected[channel_num][0], (uint32_t)data_size);
+        // skip channels to check that null buffers are ignored
+        if (!skip_channels || channel_count < 3 || channel_num % 3 != 1)
+            output_ptrs[channel_num] = &output[channel_num][0];
+    }
+
+    set_sound_conversion_isa(isa);
+    deinterleave_audio_channels(&input[0], (uint32_t)input.size(), bits_per_sample, channel_count,
+                                &output_ptrs[0], (uint32_t)data_size);
+
+    for (channel_num = 0; channel_num < channel_count; channel_num++) {
+        if (!output_ptrs[channel_num]) {
+            if (!check_guard(output[channel_num], 0)) {
+                fprintf(stderr, "deinterleave_audio_channels: skipped channel was written to\n");
+                return false;
+            }
+        } else if (!compare_output("deinterleave_audio_channels", isa,
+                                   expected[channel_num], output[channel_num], data_size))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_isa(SoundConversionISA isa)
+{
+    static const uint16_t sample_counts[] = {0, 1, 2, 3, 7, 8, 9, 10, 15, 16, 17, 1601, 1602, 1920, 2002};
+    static const uint32_t bits_per_samples[] = {16, 20, 24};
+    size_t i, j;
+    uint16_t channel_count;
+
+    for (i = 0; i < BMX_ARRAY_SIZE(sample_counts); i++) {
+        for (j = 0; j < BMX_ARRAY_SIZE(bits_per_samples); j++) {
+            if (!test_aes3_to_pcm(isa, sample_counts[i], bits_per_samples[j], true) ||
+                !test_aes3_to_pcm_channels(sample_counts[i], bits_per_samples[j], true) ||
+                !test_aes3_to_pcm_channels(sample_counts[i], bits_per_samples[j], false) ||
+                !test_aes3_to_pcm(isa, sample_counts[i], bits_per_samples[j], false) ||
+                !test_aes3_to_mc_pcm(isa, sample_counts[i], bits_per_samples[j], true) ||
+                !test_aes3_to_mc_pcm(isa, sample_counts[i], bits_per_samples[j], false))
+            {
+                return false;
+            }
+
+            if (sample_counts[i] == 0)
+                continue;
+            for (channel_count = 1; channel_count <= 16; channel_count++) {
+                if (!test_deinterleave(isa, sample_counts[i], bits_per_samples[j], channel_count) ||
+                    !test_deinterleave_channels(isa, sample_counts[i], bits_per_samples[j], channel_count, false) ||
+                    !test_deinterleave_channels(isa, sample_counts[i], bits_per_samples[j], channel_count, true) ||
+                    !test_interleave(isa, sample_counts[i], bits_per_samples[j], channel_count))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+
+int main()
+{
+    int result = 0;
+    int isa;
+
+    srand(1);
+
+    try
+    {
+        if (!test_isa(SCALAR_SOUND_CONVERSION_ISA))
+            result = 1;
+        for (isa = SSE2_SOUND_CONVERSION_ISA; isa <= NEON_SOUND_CONVERSION_ISA; isa++) {
+            if (!sound_conversion_isa_supported((SoundConversionISA)isa))
+                continue;
+            if (!test_isa((SoundConversionISA)isa))
+                result = 1;
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception: %s\n", ex.what());
+        result = 1;
+    }
+
+    return result;
+}
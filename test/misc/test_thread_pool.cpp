@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+
+#include <vector>
+#include <atomic>
+#include <thread>
+
+#include <bmx/ThreadPool.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+static bool test_run(uint32_t num_threads, size_t num_tasks)
+{
+    ThreadPool pool(num_threads);
+
+    // run several batches to check the pool is re-usable
+    int batch;
+    for (batch = 0; batch < 3; batch++) {
+        vector<int> results(num_tasks, -1);
+        pool.Run(num_tasks, [&](size_t index) {
+            results[index] = (int)index * batch;
+        });
+
+        size_t i;
+        for (i = 0; i < num_tasks; i++) {
+            if (results[i] != (int)i * batch) {
+                fprintf(stderr, "Run: task %u not run for %u threads, %u tasks\n",
+                        (unsigned int)i, num_threads, (unsigned int)num_tasks);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool test_exception(uint32_t num_threads)
+{
+    ThreadPool pool(num_threads);
+
+    atomic<int> num_run(0);
+    try
+    {
+        pool.Run(16, [&](size_t index) {
+            num_run++;
+            if (index == 5 || index == 11)
+                throw BMXException("task %u", (unsigned int)index);
+        });
+        fprintf(stderr, "Exception: no exception thrown for %u threads\n", num_threads);
+        return false;
+    }
+    catch (const BMXException &ex)
+    {
+        // the exception from the task with the lowest index is thrown
+        if (string(ex.what()) != "task 5") {
+            fprintf(stderr, "Exception: unexpected exception '%s' for %u threads\n", ex.what(), num_threads);
+            return false;
+        }
+    }
+
+    // all tasks are run in parallel mode but sequential mode stops at the first exception
+    if ((num_threads > 1 && num_run != 16) || (num_threads <= 1 && num_run != 6)) {
+        fprintf(stderr, "Exception: unexpected number of tasks run (%d) for %u threads\n",
+                (int)num_run, num_threads);
+        return false;
+    }
+
+    return test_run(num_threads, 4);
+}
+
+
+
+int main(int argc, const char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    static const uint32_t num_threads[] = {0, 1, 2, 4, 17};
+    static const size_t num_tasks[] = {0, 1, 2, 3, 17, 100};
+
+    size_t t, n;
+    for (t = 0; t < BMX_ARRAY_SIZE(num_threads); t++) {
+        for (n = 0; n < BMX_ARRAY_SIZE(num_tasks); n++) {
+            if (!test_run(num_threads[t], num_tasks[n]))
+                return 1;
+        }
+        if (!test_exception(num_threads[t]))
+            return 1;
+    }
+
+    return 0;
+}